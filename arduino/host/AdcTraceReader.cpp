@@ -0,0 +1,73 @@
+#include "AdcTraceReader.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AdcTraceReader::~AdcTraceReader() {
+    close();
+}
+
+bool AdcTraceReader::open(const char* path) {
+    close();
+    _error.clear();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        _error = std::string("could not open ") + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(AdcTrace::Header)) {
+        ::close(fd);
+        _error = "file is too short for a trace header";
+        return false;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        _error = std::string("could not map ") + path;
+        return false;
+    }
+    _data = (const uint8_t*)data;
+    _size = st.st_size;
+    _header = (const AdcTrace::Header*)_data;
+
+    if (memcmp(_header->magic, AdcTrace::MAGIC, sizeof(_header->magic)) != 0) {
+        _error = "not an adc trace";
+    } else if (_header->version != AdcTrace::VERSION) {
+        _error = "unsupported trace version " + std::to_string(_header->version);
+    } else if (_header->headerSize != AdcTrace::headerSize(_header->nChannels)
+               || _header->frameSize != AdcTrace::frameSize(_header->nChannels)
+               || _size < _header->headerSize) {
+        _error = "inconsistent trace header";
+    }
+    if (!_error.empty()) {
+        close();
+        return false;
+    }
+    _channels = (const AdcTrace::Channel*)(_data + sizeof(AdcTrace::Header));
+    _frameCount = (_size - _header->headerSize) / _header->frameSize;
+    return true;
+}
+
+void AdcTraceReader::close() {
+    if (_data) {
+        munmap((void*)_data, _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _channels = nullptr;
+    _frameCount = 0;
+}
+
+uint32_t AdcTraceReader::frameTimeUS(size_t f) const {
+    uint32_t timeUS;
+    memcpy(&timeUS, frame(f), sizeof(timeUS));
+    return timeUS;
+}
+
+const uint16_t* AdcTraceReader::frameValues(size_t f) const {
+    return (const uint16_t*)(frame(f) + sizeof(uint32_t));
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "AdcTrace.h"
+
+/**
+ * @brief Reads a binary ADC trace (see src/AdcTrace.h), memory mapped, so frames are read in place
+ */
+class AdcTraceReader {
+public:
+    AdcTraceReader() = default;
+    ~AdcTraceReader();
+    AdcTraceReader(const AdcTraceReader&) = delete;
+    AdcTraceReader& operator=(const AdcTraceReader&) = delete;
+
+    /**
+     * @brief Map a trace file and check its header
+     *
+     * Returns false if the file can't be mapped or isn't a trace of a supported version, with the
+     * reason in error().
+     */
+    bool open(const char* path);
+    void close();
+
+    const AdcTrace::Header& header() const { return *_header; }
+    const AdcTrace::Channel& channel(int c) const { return _channels[c]; }
+    int channelCount() const { return _header->nChannels; }
+    size_t frameCount() const { return _frameCount; }
+
+    uint32_t frameTimeUS(size_t f) const;
+    // values of all channels in frame f
+    const uint16_t* frameValues(size_t f) const;
+
+    const std::string& error() const { return _error; }
+
+private:
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    const AdcTrace::Header* _header = nullptr;
+    const AdcTrace::Channel* _channels = nullptr;
+    size_t _frameCount = 0;
+    std::string _error;
+
+    const uint8_t* frame(size_t f) const { return _data + _header->headerSize + f * _header->frameSize; }
+};
@@ -0,0 +1,48 @@
+#include "MidiSenderRecording.h"
+#include <Arduino.h>
+#include <algorithm>
+
+void MidiSenderRecording::sendNoteOn(int pitch, int velocity, int channel) {
+    record(NOTE_ON, pitch, velocity, channel);
+}
+
+void MidiSenderRecording::sendNoteOff(int pitch, int velocity, int channel) {
+    record(NOTE_OFF, pitch, velocity, channel);
+}
+
+void MidiSenderRecording::sendControlChange(int controlNumber, int controlValue, int channel) {
+    record(CONTROL_CHANGE, controlNumber, controlValue, channel);
+}
+
+void MidiSenderRecording::initialize() {
+    _events.clear();
+    _loopCount = 0;
+    _batchCount = 0;
+    _batchSize = 0;
+    _maxBatchSize = 0;
+}
+
+void MidiSenderRecording::loopEnd() {
+    _loopCount++;
+}
+
+void MidiSenderRecording::flushBatch() {
+    if (_batchSize > 0) {
+        _batchCount++;
+        _maxBatchSize = std::max(_maxBatchSize, _batchSize);
+    }
+    _batchSize = 0;
+}
+
+void MidiSenderRecording::record(Type type, int data1, int data2, int channel) {
+    _events.push_back(Event{micros(), type, data1, data2, channel, _batchCount});
+    _batchSize++;
+}
+
+void MidiSenderRecording::writeCsv(FILE* out) const {
+    static const char* typeNames[] = {"on", "off", "cc"};
+    fprintf(out, "time_us,type,data1,data2,channel\n");
+    for (const Event& e : _events) {
+        fprintf(out, "%u,%s,%d,%d,%d\n", e.timeUS, typeNames[e.type], e.data1, e.data2, e.channel);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "MidiSender.h"
+
+/**
+ * @brief MidiSender for the host build, which records every message with its (virtual) time
+ */
+class MidiSenderRecording : public MidiSender {
+public:
+    enum Type {
+        NOTE_ON,
+        NOTE_OFF,
+        CONTROL_CHANGE
+    };
+
+    struct Event {
+        uint32_t timeUS;
+        Type type;
+        // pitch, or control number
+        int data1;
+        // velocity, or control value
+        int data2;
+        int channel;
+        // number of batches flushed before this message, i.e. which usb transfer it went out in
+        int batch;
+    };
+
+    void sendNoteOn(int pitch, int velocity, int channel) override;
+    void sendNoteOff(int pitch, int velocity, int channel) override;
+    void sendControlChange(int controlNumber, int controlValue, int channel) override;
+    void initialize() override;
+    void loopEnd() override;
+    void beginBatch() override {}
+    void flushBatch() override;
+
+    const std::vector<Event>& events() const { return _events; }
+    void clear() { _events.clear(); }
+    int loopCount() const { return _loopCount; }
+    // batches flushed with messages in them, i.e. usb transfers
+    int batchCount() const { return _batchCount; }
+    // most messages in one batch
+    int maxBatchSize() const { return _maxBatchSize; }
+
+    // write the events as csv (time_us,type,data1,data2,channel)
+    void writeCsv(FILE* out) const;
+
+private:
+    void record(Type type, int data1, int data2, int channel);
+
+    std::vector<Event> _events;
+    int _loopCount = 0;
+    int _batchCount = 0;
+    int _batchSize = 0;
+    int _maxBatchSize = 0;
+};
@@ -0,0 +1,112 @@
+#include "MockAdc.h"
+#include <fstream>
+#include <sstream>
+
+namespace {
+    MockAdc* g_installed = nullptr;
+
+    int readInstalled(uint8_t pin) {
+        return g_installed ? g_installed->read(pin) : 0;
+    }
+}
+
+void MockAdc::attach(int signalPin, const int addressPins[N_ADDRESS_PINS]) {
+    _addressPins[signalPin] = std::vector<int>(addressPins, addressPins + N_ADDRESS_PINS);
+}
+
+void MockAdc::setSamples(int signalPin, int muxAddr, const std::vector<int>& samples, uint32_t samplePeriodUS, uint32_t startUS) {
+    Channel& channel = _channels[std::make_pair(signalPin, muxAddr)];
+    channel.samples = samples;
+    channel.samplePeriodUS = max(samplePeriodUS, (uint32_t)1);
+    channel.startUS = startUS;
+}
+
+void MockAdc::setValue(int signalPin, int muxAddr, int value) {
+    Channel& channel = _channels[std::make_pair(signalPin, muxAddr)];
+    channel.samples.resize(1);
+    channel.samples[0] = value;
+    channel.startUS = 0;
+}
+
+bool MockAdc::loadCsv(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    // channels from the header, skipping the time column
+    std::vector<std::pair<int, int>> keys;
+    std::stringstream header(line);
+    std::string cell;
+    std::getline(header, cell, ',');
+    while (std::getline(header, cell, ',')) {
+        int pin = 0;
+        int addr = 0;
+        if (sscanf(cell.c_str(), "%d:%d", &pin, &addr) != 2) {
+            return false;
+        }
+        keys.push_back(std::make_pair(pin, addr));
+    }
+    std::vector<std::vector<int>> columns(keys.size());
+    std::vector<uint32_t> times;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::stringstream row(line);
+        std::getline(row, cell, ',');
+        times.push_back((uint32_t)strtoul(cell.c_str(), nullptr, 10));
+        for (size_t c = 0; c < keys.size(); c++) {
+            columns[c].push_back(std::getline(row, cell, ',') ? atoi(cell.c_str()) : _defaultValue);
+        }
+    }
+    if (times.empty()) {
+        return false;
+    }
+    uint32_t period = (times.size() > 1) ? (times.back() - times.front()) / (times.size() - 1) : 1;
+    for (size_t c = 0; c < keys.size(); c++) {
+        setSamples(keys[c].first, keys[c].second, columns[c], period, times.front());
+    }
+    return true;
+}
+
+int MockAdc::muxAddress(int signalPin) {
+    auto it = _addressPins.find(signalPin);
+    if (it == _addressPins.end()) {
+        return 0;
+    }
+    // inverse of MUX_ADDRESSES
+    for (int addr = 0; addr < (1 << N_ADDRESS_PINS); addr++) {
+        bool match = true;
+        for (int i = 0; i < N_ADDRESS_PINS; i++) {
+            if (host::digitalState(it->second[i]) != MUX_ADDRESSES[addr][i]) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            return addr;
+        }
+    }
+    return 0;
+}
+
+int MockAdc::read(int signalPin) {
+    auto it = _channels.find(std::make_pair(signalPin, muxAddress(signalPin)));
+    if (it == _channels.end() || it->second.samples.empty()) {
+        return _defaultValue;
+    }
+    const Channel& channel = it->second;
+    uint32_t now = micros();
+    size_t i = (now > channel.startUS) ? (now - channel.startUS) / channel.samplePeriodUS : 0;
+    i = min(i, channel.samples.size() - 1);
+    return channel.samples[i];
+}
+
+void MockAdc::install() {
+    g_installed = this;
+    host::setAnalogReader(readInstalled);
+}
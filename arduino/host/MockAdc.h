@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "DualAdcManager.h"
+
+/**
+ * @brief Mock ADC backend for the host build
+ *
+ * Supplies the value seen on each (signal pin, mux address) channel, as a function of the virtual
+ * clock. The mux address of a signal pin is worked out from the state of the address pins driving
+ * that pin's muxes, so DualAdcManager's caching / mux switching is exercised exactly as on the board.
+ *
+ * Channels are fed from arrays of samples (one per samplePeriodUS, holding the last value once the
+ * samples run out), or from a csv file. Channels with no samples read as defaultValue.
+ */
+class MockAdc {
+public:
+    /**
+     * @brief Tell the mock which address pins select the mux input on a signal pin
+     */
+    void attach(int signalPin, const int addressPins[N_ADDRESS_PINS]);
+
+    /**
+     * @brief Set the samples for one channel
+     *
+     * @param samplePeriodUS Time between samples, sample 0 is at startUS
+     */
+    void setSamples(int signalPin, int muxAddr, const std::vector<int>& samples, uint32_t samplePeriodUS, uint32_t startUS = 0);
+
+    /**
+     * @brief Hold one channel at a value, e.g. to feed it a frame at a time when replaying a trace
+     */
+    void setValue(int signalPin, int muxAddr, int value);
+
+    /**
+     * @brief Load samples from a csv file
+     *
+     * The first column is the time in microseconds, and each other column is a channel, with a header
+     * of the form "pin:muxAddr", e.g.
+     *   time_us,23:6,22:4
+     *   0,450,452
+     *   250,451,452
+     * Rows must be evenly spaced in time. Returns false if the file can't be read.
+     */
+    bool loadCsv(const char* path);
+
+    void setDefaultValue(int value) { _defaultValue = value; }
+
+    // value on a signal pin right now (at the virtual time), given the address pin states
+    int read(int signalPin);
+
+    /**
+     * @brief Make this the backend for analogRead (and the ADC library shim)
+     */
+    void install();
+
+private:
+    struct Channel {
+        std::vector<int> samples;
+        uint32_t samplePeriodUS = 1;
+        uint32_t startUS = 0;
+    };
+
+    int muxAddress(int signalPin);
+
+    std::map<int, std::vector<int>> _addressPins;
+    std::map<std::pair<int, int>, Channel> _channels;
+    int _defaultValue = 0;
+};
@@ -0,0 +1,123 @@
+#include "TelemetryDecoder.h"
+#include <string.h>
+
+namespace {
+  const char* attributeAbbrev[Telemetry::NUM_ATTRIBUTES] = {"adc", "kp", "ks", "hp", "hs", "el"};
+
+  template <class T>
+  T get(const uint8_t* p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+  }
+}
+
+void TelemetryDecoder::feed(const uint8_t* data, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (data[i] != 0) {
+      if (_packet.size() < MAX_PACKET) {
+        _packet.push_back(data[i]);
+      }
+      continue;
+    }
+    if (!_packet.empty()) {
+      packet(_packet.data(), _packet.size());
+      _packet.clear();
+    }
+  }
+}
+
+void TelemetryDecoder::packet(uint8_t* data, size_t n) {
+  int length = (n < MAX_PACKET) ? Telemetry::decode(data, n) : -1;
+  // type and crc at least, and a matching crc
+  if (length < 3 || Telemetry::crc16(data, length - 2) != get<uint16_t>(data + length - 2)) {
+    _badPackets++;
+    return;
+  }
+  const uint8_t* payload = data + 1;
+  size_t payloadSize = length - 3;
+  bool ok = false;
+  switch (data[0]) {
+    case Telemetry::SCHEMA:
+      ok = schema(payload, payloadSize);
+      break;
+    case Telemetry::FRAME:
+      ok = frame(payload, payloadSize);
+      break;
+  }
+  if (!ok) {
+    _badPackets++;
+  }
+}
+
+bool TelemetryDecoder::schema(const uint8_t* payload, size_t n) {
+  if (n < (size_t)Telemetry::SCHEMA_HEADER_SIZE || payload[0] != Telemetry::VERSION) {
+    return false;
+  }
+  uint8_t attributes = payload[1];
+  uint16_t nKeys = get<uint16_t>(payload + 2);
+  if (n != (size_t)Telemetry::SCHEMA_HEADER_SIZE + 2 * nKeys) {
+    return false;
+  }
+  std::vector<uint8_t> indices(nKeys);
+  std::vector<uint8_t> pitches(nKeys);
+  for (int k = 0; k < nKeys; k++) {
+    indices[k] = payload[Telemetry::SCHEMA_HEADER_SIZE + 2 * k];
+    pitches[k] = payload[Telemetry::SCHEMA_HEADER_SIZE + 2 * k + 1];
+  }
+  // the schema is repeated, only a change starts a new header
+  if (_hasSchema && attributes == _attributes && indices == _indices && pitches == _pitches) {
+    return true;
+  }
+  _hasSchema = true;
+  _attributes = attributes;
+  _indices = indices;
+  _pitches = pitches;
+  _haveSequence = false;
+  fprintf(_csv, "sequence,time_us");
+  for (int k = 0; k < nKeys; k++) {
+    for (int a = 0; a < Telemetry::NUM_ATTRIBUTES; a++) {
+      if ((attributes >> a) & 1) {
+        fprintf(_csv, ",%s_%d-%d", attributeAbbrev[a], _indices[k], _pitches[k]);
+      }
+    }
+  }
+  fprintf(_csv, "\n");
+  return true;
+}
+
+bool TelemetryDecoder::frame(const uint8_t* payload, size_t n) {
+  if (!_hasSchema) {
+    // can't be read yet, but not bad either
+    return true;
+  }
+  if (n != (size_t)Telemetry::FRAME_HEADER_SIZE + _indices.size() * Telemetry::keySize(_attributes)) {
+    return false;
+  }
+  uint32_t sequence = get<uint32_t>(payload);
+  if (_haveSequence && sequence != _nextSequence) {
+    _droppedFrames += (int32_t)(sequence - _nextSequence) > 0 ? sequence - _nextSequence : 0;
+  }
+  _haveSequence = true;
+  _nextSequence = sequence + 1;
+  fprintf(_csv, "%u,%u", sequence, get<uint32_t>(payload + 4));
+  const uint8_t* p = payload + Telemetry::FRAME_HEADER_SIZE;
+  for (size_t k = 0; k < _indices.size(); k++) {
+    for (int a = 0; a < Telemetry::NUM_ATTRIBUTES; a++) {
+      if (!((_attributes >> a) & 1)) {
+        continue;
+      }
+      if (a == Telemetry::RAW_ADC) {
+        fprintf(_csv, ",%d", get<int16_t>(p));
+      } else if (a == Telemetry::ELAPSED) {
+        fprintf(_csv, ",%u", get<uint16_t>(p));
+      } else {
+        fprintf(_csv, ",%g", get<float>(p));
+      }
+      p += Telemetry::attributeSize(a);
+    }
+  }
+  fprintf(_csv, "\n");
+  _frames++;
+  return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "Telemetry.h"
+
+/**
+ * @brief Decodes a binary telemetry stream (see src/Telemetry.h) into csv
+ *
+ * Bytes can be fed in any sized pieces, e.g. straight from the serial port. Each schema starts a new
+ * csv header, with one column per key and attribute, named as in the text stream (e.g. adc_3-24 for
+ * the raw adc value of key index 3, pitch 24). Packets that fail their check (e.g. text printed in
+ * between packets) are counted and skipped, as are frames before the first schema.
+ */
+class TelemetryDecoder {
+public:
+    explicit TelemetryDecoder(FILE* csv) : _csv(csv) {}
+
+    void feed(const uint8_t* data, size_t n);
+
+    long frameCount() const { return _frames; }
+    long badPackets() const { return _badPackets; }
+    // gaps in the frame sequence numbers, i.e. frames the writer dropped
+    long droppedFrames() const { return _droppedFrames; }
+    bool hasSchema() const { return _hasSchema; }
+
+private:
+    FILE* _csv;
+    std::vector<uint8_t> _packet;
+    // longer than any packet the writer sends, so anything longer is noise
+    static const size_t MAX_PACKET = 1 << 16;
+
+    bool _hasSchema = false;
+    uint8_t _attributes = 0;
+    std::vector<uint8_t> _indices;
+    std::vector<uint8_t> _pitches;
+    bool _haveSequence = false;
+    uint32_t _nextSequence = 0;
+
+    long _frames = 0;
+    long _badPackets = 0;
+    long _droppedFrames = 0;
+
+    void packet(uint8_t* data, size_t n);
+    bool schema(const uint8_t* payload, size_t n);
+    bool frame(const uint8_t* payload, size_t n);
+};
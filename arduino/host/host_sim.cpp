@@ -0,0 +1,860 @@
+// Host (Linux) driver for the firmware core
+// Runs the same KeyScan / KeyHammer / KeyBank / DualAdcManager code as multi_note_simulation.ino, against the
+// shim in host/shim, with a mock ADC fed from synthetic key presses, a csv trace, or a binary trace
+// recorded by the firmware (see src/AdcTrace.h), and a virtual clock.
+// A binary trace is replayed frame by frame at the recorded scan times, so the midi output is exactly
+// what the firmware produced (given the same params). --record writes a binary trace of the run.
+// Prints the midi events produced, how fast the simulation ran compared to real time, and the key to
+// midi latency of the note ons. With --max-latency, fails (exit code 2) if the p99 onset to sent
+// latency is over the limit.
+// With --scheduler (the default with USE_SCAN_SCHEDULER, unless --no-scheduler is given), resting keys
+// are read at the slow rate (see ScanScheduler.h). The adc conversions per scan are printed.
+// With --background, keys are read by AdcFrameScanner's timer interrupt (on the virtual clock), and
+// each scan runs on a complete frame.
+// With --plan, keys are read by a ScanPlan built from the board layout (instead of through their adc
+// functions and the scan scheduler), with each stall waiting as long as its mux transition was measured
+// to need (see MuxSettleTable.h), and the plan's report is printed.
+// With --telemetry, the binary telemetry stream (see src/Telemetry.h) of every key, with every
+// attribute, is written to a file (decode it with telemetry_decode), and checked by decoding it.
+// With --buffers, every key's buffers are dumped after each note on (PRINT_BUFFER, so keys are stepped
+// by their KeyHammer rather than the KeyBank), and printed between scans within BufferDump's byte
+// budget; the rows printed are counted, and with --max-dump-drops N, the run fails if more than N note
+// ons weren't dumped (the queue was full).
+// With --chords, the synthetic keys are instead played in chords of CHORD_SIZE keys, e.g. for --buffers.
+// With --oversample N, every adc value is the average of N conversions (DualAdcManager::setOversampling).
+// With --drift RATE, every synthetic key's values drift by RATE adc bits per second, and a DriftTracker
+// follows them; how far the resting values it ends up with are from the true ones is printed, and with
+// --max-drift-error BITS, the run fails if that is over BITS on average.
+// Checks, each failing the run (exit code 2) if it doesn't hold: --check, each synthetic key gives a
+// note on for every press wholly within the run (and at most one for each press cut off by its start or
+// end); --expect-velocity MIN MAX, every note on velocity is within MIN to MAX; --compare-midi FILE,
+// the note ons are those in FILE (written with --midi, e.g. by the float build), pitch by pitch, with
+// velocities within --velocity-tolerance N (default 0). The telemetry stream (--telemetry) must also
+// decode to the frames written. ctest runs host_sim with these checks (see CMakeLists.txt).
+// With --calibrate, the synthetic keys instead rest, are calibrated (toggled on, as by the sketch's tc
+// command, rest for the UP stage, are pressed and held for the DOWN stage, then toggled off), and rest
+// again; it fails if any key's calibrated up / down values are off from where it rests / is held, or
+// its resting median / standard deviation (StreamingStats) are off from those of the injected noise.
+//
+// usage: host_sim [--seconds S] [--trace adc.csv] [--params keyParams.csv] [--midi out.csv] [--replay trace.bin] [--record trace.bin] [--telemetry out.bin] [--no-bank] [--scheduler] [--no-scheduler] [--buffers] [--max-dump-drops N] [--chords] [--background] [--plan] [--oversample N] [--drift RATE] [--max-drift-error BITS] [--max-latency US] [--check] [--expect-velocity MIN MAX] [--compare-midi midi.csv] [--velocity-tolerance N] [--calibrate]
+
+#include <Arduino.h>
+#include <SD.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <utility>
+#include "KeyHammer.h"
+#include "KeyBank.h"
+#include "DualAdcManager.h"
+#include "ParamHandler.h"
+#include "ScanClock.h"
+#include "MidiSenderRecording.h"
+#include "MockAdc.h"
+#include "AdcTraceReader.h"
+#include "AdcTraceWriter.h"
+#include "TelemetryWriter.h"
+#include "TelemetryDecoder.h"
+#include "ScanScheduler.h"
+#include "AdcFrameScanner.h"
+#include "ScanPlan.h"
+#include "MuxSettleTable.h"
+#include "CrosstalkTable.h"
+#include "MidiQueue.h"
+#include "DriftTracker.h"
+#include "KeyScan.h"
+
+// board layout: 16 signal pins, even indices read by ADC0 (with the left muxes), odd by ADC1 (right muxes)
+const int N_SIGNAL_PINS = 16;
+int signalPins[N_SIGNAL_PINS] = {23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 41, 40, 39, 38, 27, 26};
+int addressPinsL[N_ADDRESS_PINS] = {35, 36, 37};
+int addressPinsR[N_ADDRESS_PINS] = {32, 33, 34};
+// keys on the board, and the number used for synthetic presses (a replayed trace uses one per key channel)
+const int MAX_KEYS = N_SIGNAL_PINS * 8;
+const int N_SYNTHETIC_KEYS = 64;
+const int SCAN_PERIOD_US = 250;
+const int FIRST_PITCH = 24;
+
+const float maxHammerSpeed_m_s = 2.5;
+const float hammer_travel = 7;
+const int adcValKeyDown = 560;
+const int adcValKeyUp = 450;
+// where the synthetic keys are held when pressed
+const int adcValKeyPressed = 565;
+
+DualAdcManager dualAdcManager;
+MidiSenderRecording midiSender;
+MockAdc mockAdc;
+KeyBank keyBank;
+ScanScheduler scheduler;
+KeyScan keyScan;
+AdcFrameScanner frameScanner;
+ScanPlan scanPlan;
+MuxSettleTable settleTable;
+CrosstalkTable crosstalkTable;
+DriftTracker driftTracker;
+
+// keys are read in pairs, like multi_note_simulation.ino: both ADCs are read at once, and the second
+// key of each pair uses the cached value from ADC1
+constexpr int keyPinIndex0(int k) { return 2 * (k / 16); }
+constexpr int keyMuxAddr(int k) { return (k % 16) / 2; }
+constexpr int keySignalPin(int k) { return keyPinIndex0(k) + (k % 2); }
+
+// the same layout as a table, for ScanPlan: even pins are on the left muxes (bus 0), odd on the right
+// (bus 1). Which ADCs can read each pin is as on the teensy 4.1 (see DualAdcManager.h)
+const ScanPlan::Pin planPins[N_SIGNAL_PINS] = {
+  {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH}, {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH},
+  {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH}, {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH},
+  {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH}, {0, ScanPlan::ADC_BOTH}, {1, ScanPlan::ADC_BOTH},
+  {0, ScanPlan::ADC_1}, {1, ScanPlan::ADC_1}, {0, ScanPlan::ADC_0}, {1, ScanPlan::ADC_0},
+};
+
+template <int K>
+int readKey() {
+  if (K % 2 == 0) {
+    return dualAdcManager.readDualGetAdcValue0(keyPinIndex0(K), keyPinIndex0(K) + 1, keyMuxAddr(K), keyMuxAddr(K), 0);
+  }
+  return dualAdcManager.readDualGetAdcValue1(keyPinIndex0(K), keyPinIndex0(K) + 1, keyMuxAddr(K), keyMuxAddr(K), 0);
+}
+
+template <size_t... Ks>
+struct Keyboard {
+  // constructed in place, since KeyHammer's buffers can't be copied
+  KeyHammer keys[sizeof...(Ks)] = {
+    KeyHammer(readKey<Ks>, &midiSender, FIRST_PITCH + (int)Ks, adcValKeyDown, adcValKeyUp, hammer_travel, maxHammerSpeed_m_s)...
+  };
+};
+
+template <size_t... Ks>
+Keyboard<Ks...> makeKeyboard(std::index_sequence<Ks...>);
+typedef decltype(makeKeyboard(std::make_index_sequence<MAX_KEYS>())) KeyboardN;
+
+// presses of each synthetic key that must each give a note on (the whole press is within the run), and
+// that may (also counting presses cut off by the start or end of the run)
+std::vector<int> definitePresses(N_SYNTHETIC_KEYS);
+std::vector<int> possiblePresses(N_SYNTHETIC_KEYS);
+
+// synthetic presses: rest with a little noise, press at increasing speeds, hold, release
+// with every value drifting by driftRate adc bits per second
+void generatePresses(uint32_t durationUS, float driftRate) {
+  const uint32_t periodUS = 50;
+  const size_t n = durationUS / periodUS;
+  for (int k = 0; k < N_SYNTHETIC_KEYS; k++) {
+    std::vector<int> samples(n);
+    float position = adcValKeyUp;
+    // stagger keys, so that presses overlap
+    uint32_t cycleUS = 400000 + 7919 * k;
+    uint32_t offsetUS = 13331 * k;
+    for (size_t i = 0; i < n; i++) {
+      uint32_t t = i * periodUS + offsetUS;
+      uint32_t phase = t % cycleUS;
+      int strike = t / cycleUS;
+      // bits per us
+      float speed = 0.002f + (strike % 20) * 0.001f;
+      if (phase > 100000 && phase < 250000) {
+        position = min((float)adcValKeyPressed, position + speed * periodUS);
+      } else if (phase >= 250000) {
+        position = max((float)adcValKeyUp, position - 0.01f * periodUS);
+      }
+      samples[i] = (int)lroundf(position + driftRate * (i * periodUS / 1e6f)) + (int)random(-2, 3);
+    }
+    mockAdc.setSamples(signalPins[keySignalPin(k)], keyMuxAddr(k), samples, periodUS);
+    for (long startUS = 100000 - (long)offsetUS; startUS < (long)durationUS; startUS += cycleUS) {
+      if (startUS + 150000 <= 0) {
+        continue;
+      }
+      possiblePresses[k]++;
+      definitePresses[k] += (startUS >= 0 && startUS + 150000 <= (long)durationUS);
+    }
+  }
+}
+
+// synthetic chords (--chords): every CHORD_PERIOD_US, the next CHORD_SIZE keys are pressed together
+const int CHORD_SIZE = 10;
+const uint32_t CHORD_PERIOD_US = 500000;
+
+// synthetic chords: rest with a little noise, then press a chord's keys at once (each at its own speed),
+// hold, release
+void generateChords(uint32_t durationUS) {
+  const uint32_t periodUS = 50;
+  const size_t n = durationUS / periodUS;
+  for (int k = 0; k < N_SYNTHETIC_KEYS; k++) {
+    std::vector<int> samples(n);
+    float position = adcValKeyUp;
+    for (size_t i = 0; i < n; i++) {
+      uint32_t t = i * periodUS;
+      int chord = t / CHORD_PERIOD_US;
+      uint32_t phase = t % CHORD_PERIOD_US;
+      // the key's place in the chord, if it is in it
+      int note = (k - chord * CHORD_SIZE % N_SYNTHETIC_KEYS + N_SYNTHETIC_KEYS) % N_SYNTHETIC_KEYS;
+      // moderate speeds, like the first strikes of generatePresses
+      float speed = 0.002f + ((chord + note) % 8) * 0.001f;
+      if (note < CHORD_SIZE && phase > 100000 && phase < 250000) {
+        position = min((float)adcValKeyPressed, position + speed * periodUS);
+      } else {
+        position = max((float)adcValKeyUp, position - 0.01f * periodUS);
+      }
+      samples[i] = (int)lroundf(position) + (int)random(-2, 3);
+    }
+    mockAdc.setSamples(signalPins[keySignalPin(k)], keyMuxAddr(k), samples, periodUS);
+  }
+  for (long startUS = 100000, chord = 0; startUS < (long)durationUS; startUS += CHORD_PERIOD_US, chord++) {
+    for (int note = 0; note < CHORD_SIZE; note++) {
+      int k = (chord * CHORD_SIZE + note) % N_SYNTHETIC_KEYS;
+      possiblePresses[k]++;
+      definitePresses[k] += (startUS + 150000 <= (long)durationUS);
+    }
+  }
+}
+
+// a calibration run (--calibrate): calibration is toggled on, keys rest through the UP stage, are pressed
+// and held, released, and calibration is toggled off. Keys rest for longer than the UP stage first, so a
+// key whose clock hasn't moved since the start (stepped by the bank) would end the stage straight away
+const uint32_t CALIBRATION_ON_US = 1500000;
+const uint32_t CALIBRATION_PRESS_US = 2800000;
+const uint32_t CALIBRATION_RELEASE_US = 3400000;
+const uint32_t CALIBRATION_OFF_US = 3700000;
+
+// synthetic calibration: rest with a little noise, then each key pressed, held and released
+void generateCalibration(uint32_t durationUS) {
+  const uint32_t periodUS = 50;
+  const size_t n = durationUS / periodUS;
+  for (int k = 0; k < N_SYNTHETIC_KEYS; k++) {
+    std::vector<int> samples(n);
+    float position = adcValKeyUp;
+    for (size_t i = 0; i < n; i++) {
+      uint32_t t = i * periodUS;
+      if (t >= CALIBRATION_PRESS_US && t < CALIBRATION_RELEASE_US) {
+        position = min((float)adcValKeyPressed, position + 0.005f * periodUS);
+      } else if (t >= CALIBRATION_RELEASE_US) {
+        position = max((float)adcValKeyUp, position - 0.01f * periodUS);
+      }
+      samples[i] = (int)lroundf(position) + (int)random(-2, 3);
+    }
+    mockAdc.setSamples(signalPins[keySignalPin(k)], keyMuxAddr(k), samples, periodUS);
+  }
+}
+
+// velocity of each note on, in order, by pitch
+typedef std::map<int, std::vector<int>> NoteOns;
+
+NoteOns noteOnsOf(const std::vector<MidiSenderRecording::Event>& events) {
+  NoteOns noteOns;
+  for (const MidiSenderRecording::Event& e : events) {
+    if (e.type == MidiSenderRecording::NOTE_ON) {
+      noteOns[e.data1].push_back(e.data2);
+    }
+  }
+  return noteOns;
+}
+
+// note ons from a csv written with --midi
+bool readNoteOns(const char* path, NoteOns& noteOns) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    unsigned timeUS;
+    char type[8];
+    int pitch, velocity, channel;
+    if (sscanf(line.c_str(), "%u,%7[^,],%d,%d,%d", &timeUS, type, &pitch, &velocity, &channel) == 5 &&
+        std::string(type) == "on") {
+      noteOns[pitch].push_back(velocity);
+    }
+  }
+  return true;
+}
+
+bool loadSdFile(const char* hostPath, const char* sdPath) {
+  std::ifstream file(hostPath);
+  if (!file) {
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  SD.files()[sdPath] = contents.str();
+  return true;
+}
+
+bool saveSdFile(const char* sdPath, const char* hostPath) {
+  std::ofstream file(hostPath, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  const std::string& contents = SD.files()[sdPath];
+  file.write(contents.data(), contents.size());
+  return (bool)file;
+}
+
+int main(int argc, char** argv) {
+  float seconds = 5;
+  const char* tracePath = nullptr;
+  const char* replayPath = nullptr;
+  const char* recordPath = nullptr;
+  const char* telemetryPath = nullptr;
+  const char* paramsPath = nullptr;
+  const char* midiPath = nullptr;
+  bool useBank = true;
+  #ifdef USE_SCAN_SCHEDULER
+  bool useScheduler = true;
+  #else
+  bool useScheduler = false;
+  #endif
+  bool background = false;
+  bool dumpBuffers = false;
+  long maxDumpDrops = -1;
+  bool chords = false;
+  bool usePlan = false;
+  long maxLatencyUS = -1;
+  bool checkPresses = false;
+  int minVelocity = -1;
+  int maxVelocity = -1;
+  const char* compareMidiPath = nullptr;
+  int velocityTolerance = 0;
+  int oversampling = ADC_OVERSAMPLING;
+  float driftRate = 0;
+  bool trackDrift = false;
+  float maxDriftError = -1;
+  bool calibrate = false;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--seconds" && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (arg == "--trace" && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (arg == "--replay" && i + 1 < argc) {
+      replayPath = argv[++i];
+    } else if (arg == "--record" && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (arg == "--telemetry" && i + 1 < argc) {
+      telemetryPath = argv[++i];
+    } else if (arg == "--params" && i + 1 < argc) {
+      paramsPath = argv[++i];
+    } else if (arg == "--midi" && i + 1 < argc) {
+      midiPath = argv[++i];
+    } else if (arg == "--no-bank") {
+      useBank = false;
+    } else if (arg == "--scheduler") {
+      useScheduler = true;
+    } else if (arg == "--no-scheduler") {
+      useScheduler = false;
+    } else if (arg == "--background") {
+      background = true;
+    } else if (arg == "--buffers") {
+      dumpBuffers = true;
+    } else if (arg == "--max-dump-drops" && i + 1 < argc) {
+      maxDumpDrops = atol(argv[++i]);
+    } else if (arg == "--chords") {
+      chords = true;
+    } else if (arg == "--plan") {
+      usePlan = true;
+    } else if (arg == "--oversample" && i + 1 < argc) {
+      oversampling = atoi(argv[++i]);
+    } else if (arg == "--drift" && i + 1 < argc) {
+      driftRate = atof(argv[++i]);
+      trackDrift = true;
+    } else if (arg == "--max-drift-error" && i + 1 < argc) {
+      maxDriftError = atof(argv[++i]);
+    } else if (arg == "--max-latency" && i + 1 < argc) {
+      maxLatencyUS = atol(argv[++i]);
+    } else if (arg == "--check") {
+      checkPresses = true;
+    } else if (arg == "--expect-velocity" && i + 2 < argc) {
+      minVelocity = atoi(argv[++i]);
+      maxVelocity = atoi(argv[++i]);
+    } else if (arg == "--compare-midi" && i + 1 < argc) {
+      compareMidiPath = argv[++i];
+    } else if (arg == "--velocity-tolerance" && i + 1 < argc) {
+      velocityTolerance = atoi(argv[++i]);
+    } else if (arg == "--calibrate") {
+      calibrate = true;
+    } else {
+      fprintf(stderr, "usage: %s [--seconds S] [--trace adc.csv] [--params keyParams.csv] [--midi out.csv] [--replay trace.bin] [--record trace.bin] [--telemetry out.bin] [--no-bank] [--scheduler] [--no-scheduler] [--buffers] [--max-dump-drops N] [--chords] [--background] [--plan] [--oversample N] [--drift RATE] [--max-drift-error BITS] [--max-latency US] [--check] [--expect-velocity MIN MAX] [--compare-midi midi.csv] [--velocity-tolerance N] [--calibrate]\n", argv[0]);
+      return 1;
+    }
+  }
+  uint32_t durationUS = (uint32_t)(seconds * 1e6f);
+  if (checkPresses && (replayPath || tracePath)) {
+    fprintf(stderr, "--check needs synthetic presses (not --replay or --trace)\n");
+    return 1;
+  }
+  if (maxDumpDrops >= 0 && !dumpBuffers) {
+    fprintf(stderr, "--max-dump-drops needs --buffers\n");
+    return 1;
+  }
+  if (chords && (replayPath || tracePath || calibrate || trackDrift)) {
+    fprintf(stderr, "--chords are synthetic presses without drift (not --replay, --trace, --calibrate or --drift)\n");
+    return 1;
+  }
+  if (maxDriftError >= 0 && (!trackDrift || replayPath || tracePath)) {
+    fprintf(stderr, "--max-drift-error needs --drift, with synthetic presses (not --replay or --trace)\n");
+    return 1;
+  }
+  if (calibrate && (replayPath || tracePath || checkPresses || trackDrift || dumpBuffers)) {
+    fprintf(stderr, "--calibrate runs its own synthetic keys (not --replay, --trace, --check, --drift or --buffers)\n");
+    return 1;
+  }
+  if (calibrate && durationUS < CALIBRATION_OFF_US) {
+    fprintf(stderr, "--calibrate needs at least %.1f seconds\n", CALIBRATION_OFF_US / 1e6f);
+    return 1;
+  }
+
+  static KeyboardN keyboard;
+  KeyHammer* keys = keyboard.keys;
+  int nKeys = N_SYNTHETIC_KEYS;
+
+  for (int i = 0; i < N_SIGNAL_PINS; i++) {
+    mockAdc.attach(signalPins[i], (i % 2 == 0) ? addressPinsL : addressPinsR);
+  }
+  mockAdc.setDefaultValue(adcValKeyUp);
+  mockAdc.install();
+  randomSeed(1);
+  AdcTraceReader replay;
+  // trace channel of each key, when replaying
+  std::vector<int> keyChannels;
+  if (replayPath) {
+    if (!replay.open(replayPath)) {
+      fprintf(stderr, "could not read trace %s: %s\n", replayPath, replay.error().c_str());
+      return 1;
+    }
+    // the board here has no pedals, so pedal channels are not replayed
+    for (int c = 0; c < replay.channelCount(); c++) {
+      if (replay.channel(c).kind == AdcTrace::KEY) {
+        keyChannels.push_back(c);
+      }
+    }
+    if ((int)keyChannels.size() > MAX_KEYS) {
+      fprintf(stderr, "trace has %d keys, at most %d are supported\n", (int)keyChannels.size(), MAX_KEYS);
+      return 1;
+    }
+    nKeys = keyChannels.size();
+    for (int k = 0; k < nKeys; k++) {
+      keys[k].pitch = replay.channel(keyChannels[k]).pitch;
+    }
+    durationUS = replay.frameCount() ? replay.frameTimeUS(replay.frameCount() - 1) - replay.frameTimeUS(0) : 0;
+    if (background) {
+      fprintf(stderr, "--background can't be used with --replay (replay already gives one frame per scan)\n");
+      return 1;
+    }
+  } else if (tracePath) {
+    if (!mockAdc.loadCsv(tracePath)) {
+      fprintf(stderr, "could not read trace %s\n", tracePath);
+      return 1;
+    }
+  } else if (calibrate) {
+    generateCalibration(durationUS);
+  } else if (chords) {
+    generateChords(durationUS);
+  } else {
+    generatePresses(durationUS, driftRate);
+  }
+
+  dualAdcManager.begin(addressPinsL, addressPinsR, signalPins, N_SIGNAL_PINS);
+  for (int i = 0; i < N_SIGNAL_PINS; i++) {
+    dualAdcManager.setOversampling(i, oversampling);
+  }
+  #ifdef USE_CROSSTALK_COMPENSATION
+  // the mock muxes have no carry-over, so this only checks the correction leaves values alone
+  crosstalkTable.calibrate(&dualAdcManager, planPins, N_SIGNAL_PINS, 0);
+  crosstalkTable.apply(&dualAdcManager);
+  #endif
+  if (paramsPath) {
+    if (!loadSdFile(paramsPath, "/keyParams.csv")) {
+      fprintf(stderr, "could not read params %s\n", paramsPath);
+      return 1;
+    }
+    ParamHandler ph;
+    ph.initialize(nKeys);
+    for (int i = 0; i < nKeys; i++) {
+      if (ph.existsAdcValKeyDown(i)) {
+        keys[i].setAdcValKeyDown(ph.getAdcValKeyDown(i));
+      }
+      if (ph.existsAdcValKeyUp(i)) {
+        keys[i].setAdcValKeyUp(ph.getAdcValKeyUp(i));
+      }
+    }
+  }
+  midiSender.initialize();
+  // time each sample by its conversion, rather than by the start of the scan
+  KeyHammer::setSampleClock([]() -> uint32_t { return dualAdcManager.getConversionUS(); });
+  keyBank.begin(keys, nKeys);
+  if (trackDrift) {
+    driftTracker.begin(keys, nKeys);
+  }
+  if (usePlan) {
+    // keys are read by the plan, so not scheduled
+    useScheduler = false;
+    std::vector<ScanPlan::Channel> channels(nKeys);
+    for (int k = 0; k < nKeys; k++) {
+      channels[k] = ScanPlan::Channel{(uint8_t)keySignalPin(k), (uint8_t)keyMuxAddr(k)};
+    }
+    if (!scanPlan.build(channels.data(), nKeys, planPins, N_SIGNAL_PINS)) {
+      fprintf(stderr, "could not build scan plan: %s\n", scanPlan.getError());
+      return 1;
+    }
+    #ifdef USE_MUX_SETTLE_TABLE
+    // the mock muxes settle straight away, so each stall only waits MUX_SETTLE_MARGIN_US
+    settleTable.characterise(&dualAdcManager, planPins, N_SIGNAL_PINS);
+    scanPlan.applySettleTable(&settleTable);
+    #ifdef USE_CROSSTALK_COMPENSATION
+    crosstalkTable.apply(&dualAdcManager);
+    #endif
+    #endif
+  }
+  if (useScheduler) {
+    #ifndef USE_IDLE_FAST_PATH
+    fprintf(stderr, "--scheduler needs USE_IDLE_FAST_PATH (config.h) to know which keys are resting\n");
+    return 1;
+    #endif
+    scheduler.begin(&dualAdcManager, keys, nKeys);
+  }
+  // the same scan as the firmware's loop, wired from the options above
+  keyScan.begin(keys, nKeys, NULL, 0, &midiSender);
+  keyScan.setBank(useBank ? &keyBank : NULL);
+  keyScan.setScheduler(useScheduler ? &scheduler : NULL);
+  keyScan.setPlan(usePlan ? &scanPlan : NULL, &dualAdcManager, 0);
+  #ifdef USE_PROFILER
+  Profiler::begin();
+  #endif
+
+  // recorded the same way as the firmware does, to the (in memory) SD card
+  AdcTraceWriter recorder;
+  if (recordPath) {
+    std::vector<AdcTrace::Channel> channels(nKeys);
+    for (int k = 0; k < nKeys; k++) {
+      channels[k] = AdcTrace::Channel{(uint8_t)keys[k].pitch, AdcTrace::KEY, 0};
+    }
+    recorder.begin("/trace.bin", channels.data(), nKeys, SCAN_PERIOD_US);
+  }
+  std::vector<uint16_t> frame(nKeys);
+  // streamed the same way as the firmware does, to the (in memory) serial port
+  TelemetryWriter telemetry;
+  std::string telemetryBytes;
+  if (telemetryPath) {
+    std::vector<uint8_t> indices(nKeys);
+    std::vector<uint8_t> pitches(nKeys);
+    for (int k = 0; k < nKeys; k++) {
+      indices[k] = k;
+      pitches[k] = keys[k].pitch;
+    }
+    telemetry.begin(indices.data(), pitches.data(), nKeys, (1 << Telemetry::NUM_ATTRIBUTES) - 1, SCAN_PERIOD_US);
+    Serial.clearOutput();
+  }
+  if (background && !frameScanner.begin(&dualAdcManager, keys, nKeys, NULL, 0, ADC_FRAME_TICK_US, SCAN_PERIOD_US)) {
+    fprintf(stderr, "could not start the background adc scanner\n");
+    return 1;
+  }
+
+  // the shim's virtual clock, so runs are reproducible
+  ScanClock scanClock(host::nowUS);
+  uint32_t lastScanUS = 0;
+  long scans = 0;
+  uint32_t conversionsBefore = dualAdcManager.getConversionCount();
+  if (dumpBuffers) {
+    for (int i = 0; i < nKeys; i++) {
+      keys[i].setPrintMode(PRINT_BUFFER);
+    }
+    // keys dumping their buffers are stepped by their KeyHammer
+    keyScan.loadParams();
+    Serial.clearOutput();
+  }
+  long dumpBytes = 0;
+  long dumpRows = 0;
+  // calibration toggles made so far (--calibrate)
+  int calibrationToggles = 0;
+  auto scan = [&](uint32_t nowUS) {
+    if (calibrate && calibrationToggles < 2 && nowUS >= (calibrationToggles ? CALIBRATION_OFF_US : CALIBRATION_ON_US)) {
+      // as the sketch's tc command does
+      for (int i = 0; i < nKeys; i++) {
+        keys[i].toggleCalibration();
+      }
+      keyScan.loadParams();
+      calibrationToggles++;
+    }
+    keyScan.start();
+    {
+      PROF_SCOPE(PROF_SCAN);
+      keyScan.step(nowUS);
+    }
+    keyScan.finish();
+    midiSender.loopEnd();
+    if (recorder.isRecording()) {
+      for (int i = 0; i < nKeys; i++) {
+        frame[i] = abs(keyScan.getRawADC(i));
+      }
+      recorder.writeFrame(nowUS, frame.data());
+    }
+    if (telemetry.isStreaming()) {
+      telemetry.beginFrame(nowUS);
+      for (int i = 0; i < nKeys; i++) {
+        telemetry.addKey(keyScan.getRawADC(i), keyScan.getKeyPosition(i), keyScan.getKeySpeed(i),
+                         keyScan.getHammerPosition(i), keyScan.getHammerSpeed(i), keyScan.getElapsedUS(i));
+      }
+      telemetry.endFrame();
+      telemetry.drain();
+      telemetryBytes += Serial.output();
+      Serial.clearOutput();
+    }
+    if (trackDrift) {
+      int moved = driftTracker.step(nowUS, [](int i) {
+        return DriftTracker::KeyState{keyScan.getRawADC(i), keyScan.getKeySpeed(i), keyScan.isNoteOn(i)};
+      });
+      if (moved >= 0) {
+        keyScan.loadParams(moved);
+      }
+    }
+    if (dumpBuffers) {
+      dumpBytes += BufferDump::drain();
+      for (char c : Serial.output()) {
+        dumpRows += (c == '\n');
+      }
+      Serial.clearOutput();
+    }
+    scans++;
+  };
+  auto wallStart = std::chrono::steady_clock::now();
+  if (replayPath) {
+    // each frame at its recorded time, with every key channel held at its recorded value
+    for (size_t f = 0; f < replay.frameCount(); f++) {
+      host::setMicros(replay.frameTimeUS(f));
+      const uint16_t* values = replay.frameValues(f);
+      for (int k = 0; k < nKeys; k++) {
+        mockAdc.setValue(signalPins[keySignalPin(k)], keyMuxAddr(k), values[keyChannels[k]]);
+      }
+      scan(scanClock.sample());
+    }
+  } else if (background) {
+    // the scanner's timer fires as the virtual clock advances, and each scan runs on a complete frame,
+    // at the time the frame was read
+    while (host::nowUS() < durationUS) {
+      const AdcFrame* adcFrame = frameScanner.acquireFrame();
+      if (!adcFrame) {
+        host::advanceMicros(ADC_FRAME_TICK_US);
+        continue;
+      }
+      dualAdcManager.setFrame(adcFrame);
+      scan(adcFrame->startUS);
+      dualAdcManager.setFrame(NULL);
+      frameScanner.releaseFrame();
+    }
+    frameScanner.end();
+  } else {
+    while (scanClock.sample() < durationUS) {
+      // nothing else runs on the host, so skip straight to the next scan
+      if (scans > 0 && scanClock.since(lastScanUS) < (uint32_t)SCAN_PERIOD_US) {
+        host::advanceMicros(SCAN_PERIOD_US - scanClock.since(lastScanUS));
+        scanClock.sample();
+      }
+      uint32_t nowUS = scanClock.now();
+      lastScanUS = nowUS;
+      scan(nowUS);
+    }
+  }
+  double wallUS = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - wallStart).count();
+  // set by any check that fails, and the run fails (exit code 2) at the end
+  bool failed = false;
+
+  if (recordPath) {
+    recorder.end();
+    if (!saveSdFile("/trace.bin", recordPath)) {
+      fprintf(stderr, "could not write %s\n", recordPath);
+      return 1;
+    }
+  }
+  if (telemetryPath) {
+    FILE* out = fopen(telemetryPath, "wb");
+    if (!out) {
+      fprintf(stderr, "could not write %s\n", telemetryPath);
+      return 1;
+    }
+    fwrite(telemetryBytes.data(), 1, telemetryBytes.size(), out);
+    fclose(out);
+    // check the stream decodes to the frames that were written
+    FILE* csv = fopen("/dev/null", "w");
+    TelemetryDecoder decoder(csv);
+    decoder.feed((const uint8_t*)telemetryBytes.data(), telemetryBytes.size());
+    fclose(csv);
+    fprintf(stderr, "telemetry: %lu frames (%.1f bytes per scan), %lu dropped, %ld decoded, %ld bad packets\n",
+            (unsigned long)telemetry.getFrameCount(), (double)telemetryBytes.size() / scans,
+            (unsigned long)telemetry.getDroppedFrames(), decoder.frameCount(), decoder.badPackets());
+    if (decoder.frameCount() != (long)(telemetry.getFrameCount() - telemetry.getDroppedFrames()) || decoder.badPackets()) {
+      fprintf(stderr, "telemetry stream doesn't decode to the frames written\n");
+      failed = true;
+    }
+  }
+  if (trackDrift) {
+    fprintf(stderr, "drift: %lu adc bits moved", (unsigned long)driftTracker.getMoves());
+    if (!replayPath && !tracePath) {
+      // where the synthetic keys rest at the end of the run
+      float restingUp = adcValKeyUp + driftRate * durationUS / 1e6f;
+      float error = 0;
+      for (int i = 0; i < nKeys; i++) {
+        error += fabsf(keys[i].getAdcValKeyUp() - restingUp);
+      }
+      fprintf(stderr, ", resting values %.2f bits from where the keys rest on average (%.2f if not followed)",
+              error / nKeys, fabsf(restingUp - adcValKeyUp));
+      if (maxDriftError >= 0 && error / nKeys > maxDriftError) {
+        fprintf(stderr, "\nresting values are over %.2f bits from where the keys rest", maxDriftError);
+        failed = true;
+      }
+    }
+    fprintf(stderr, "\n");
+  }
+  if (dumpBuffers) {
+    fprintf(stderr, "buffer dumps: %lu captured, %lu dropped, %ld rows printed (%ld bytes, at most %d per scan), %d waiting\n",
+            (unsigned long)BufferDump::getCaptured(), (unsigned long)BufferDump::getDropped(), dumpRows, dumpBytes,
+            BufferDump::getBudget(), BufferDump::depth());
+    if (maxDumpDrops >= 0 && (long)BufferDump::getDropped() > maxDumpDrops) {
+      fprintf(stderr, "over %ld buffer dumps dropped\n", maxDumpDrops);
+      failed = true;
+    }
+  }
+  if (midiPath) {
+    FILE* out = fopen(midiPath, "w");
+    if (!out) {
+      fprintf(stderr, "could not write %s\n", midiPath);
+      return 1;
+    }
+    midiSender.writeCsv(out);
+    fclose(out);
+  } else {
+    midiSender.writeCsv(stdout);
+  }
+
+  int noteOnCount = 0;
+  for (const MidiSenderRecording::Event& e : midiSender.events()) {
+    noteOnCount += (e.type == MidiSenderRecording::NOTE_ON);
+  }
+  fprintf(stderr, "%s: %d keys, %ld scans, %d note ons\n", useBank ? "KeyBank" : "KeyHammer", nKeys, scans, noteOnCount);
+  fprintf(stderr, "%d midi messages in %d usb transfers (at most %d per transfer)\n", (int)midiSender.events().size(),
+          midiSender.batchCount(), midiSender.maxBatchSize());
+  fprintf(stderr, "%.3f us per scan (%.1f ns per key), %.1fx real time\n",
+          wallUS / scans, 1000 * wallUS / scans / nKeys, durationUS / wallUS);
+  fprintf(stderr, "%.2f adc conversions per scan%s\n",
+          (double)(dualAdcManager.getConversionCount() - conversionsBefore) / scans,
+          useScheduler ? " (scan scheduler)" : "");
+  if (usePlan) {
+    Serial.clearOutput();
+    scanPlan.printReport();
+    fputs(Serial.output().c_str(), stderr);
+  }
+  if (background) {
+    fprintf(stderr, "background adc: %d conversions per frame, %lu frames, %lu dropped\n", frameScanner.getNumSlots(),
+            (unsigned long)frameScanner.getFrameCount(), (unsigned long)frameScanner.getDroppedFrames());
+  }
+  #ifdef USE_PROFILER
+  Serial.clearOutput();
+  Profiler::print();
+  fputs(Serial.output().c_str(), stderr);
+  #endif
+  #ifdef USE_MIDI_QUEUE
+  Serial.clearOutput();
+  MidiQueue::print();
+  fputs(Serial.output().c_str(), stderr);
+  #endif
+  #ifdef USE_LATENCY_TRACKER
+  Serial.clearOutput();
+  LatencyTracker::print();
+  fputs(Serial.output().c_str(), stderr);
+  #endif
+
+  NoteOns noteOns = noteOnsOf(midiSender.events());
+  if (calibrate) {
+    // each key's values are the medians of its samples, so within the noise of where it rests / is held,
+    // and the spread of its resting samples is that of the noise (random(-2, 3): sqrt(2) bits)
+    const float noiseStd = sqrtf(2);
+    int off = 0;
+    float maxStdError = 0;
+    for (int k = 0; k < nKeys; k++) {
+      int up = keys[k].getAdcValKeyUp();
+      int down = keys[k].getAdcValKeyDown();
+      int upMedian = keys[k].getCalibrationUpMedian();
+      float upStd = keys[k].getCalibrationUpStd();
+      maxStdError = max(maxStdError, fabsf(upStd - noiseStd));
+      if (keys[k].isCalibrating() || abs(up - adcValKeyUp) > 1 || abs(down - adcValKeyPressed) > 1 ||
+          abs(upMedian - adcValKeyUp) > 1 || fabsf(upStd - noiseStd) > 0.1f * noiseStd) {
+        fprintf(stderr, "pitch %d: calibrated to up %d, down %d (resting median %d, std %.2f), expected %d, %d (%d, %.2f)\n",
+                keys[k].pitch, up, down, upMedian, upStd, adcValKeyUp, adcValKeyPressed, adcValKeyUp, noiseStd);
+        off++;
+      }
+    }
+    fprintf(stderr, "calibration: %d of %d keys off, resting std within %.3f of the noise's\n", off, nKeys, maxStdError);
+    // calibrating keys send nothing, and the keys rest before and after
+    if (off || noteOnCount) {
+      failed = true;
+    }
+  }
+  if (checkPresses) {
+    int definite = 0;
+    int possible = 0;
+    for (int k = 0; k < nKeys; k++) {
+      const std::vector<int>& velocities = noteOns[keys[k].pitch];
+      definite += definitePresses[k];
+      possible += possiblePresses[k];
+      if ((int)velocities.size() < definitePresses[k] || (int)velocities.size() > possiblePresses[k]) {
+        fprintf(stderr, "pitch %d: %d note ons, expected %d to %d\n", keys[k].pitch, (int)velocities.size(),
+                definitePresses[k], possiblePresses[k]);
+        failed = true;
+      }
+    }
+    fprintf(stderr, "check: %d note ons for %d to %d presses\n", noteOnCount, definite, possible);
+  }
+  if (minVelocity >= 0) {
+    int outside = 0;
+    for (const auto& pitch : noteOns) {
+      for (int velocity : pitch.second) {
+        outside += (velocity < minVelocity || velocity > maxVelocity);
+      }
+    }
+    if (outside) {
+      fprintf(stderr, "%d note ons with velocities outside %d to %d\n", outside, minVelocity, maxVelocity);
+      failed = true;
+    }
+  }
+  if (compareMidiPath) {
+    NoteOns expected;
+    if (!readNoteOns(compareMidiPath, expected)) {
+      fprintf(stderr, "could not read %s\n", compareMidiPath);
+      return 1;
+    }
+    // note ons of each pitch are paired up in order
+    int maxError = 0;
+    int divergent = 0;
+    int missing = 0;
+    for (int pitch = 0; pitch < 128; pitch++) {
+      const std::vector<int>& a = noteOns[pitch];
+      const std::vector<int>& b = expected[pitch];
+      missing += abs((int)a.size() - (int)b.size());
+      for (size_t i = 0; i < min(a.size(), b.size()); i++) {
+        int error = abs(a[i] - b[i]);
+        maxError = max(maxError, error);
+        divergent += (error > 0);
+      }
+    }
+    fprintf(stderr, "compared to %s: %d unmatched note ons, %d velocities differ (by at most %d)\n", compareMidiPath,
+            missing, divergent, maxError);
+    if (missing || maxError > velocityTolerance) {
+      fprintf(stderr, "note ons differ from %s by more than %d\n", compareMidiPath, velocityTolerance);
+      failed = true;
+    }
+  }
+  #ifdef USE_LATENCY_TRACKER
+  if (maxLatencyUS >= 0) {
+    LatencyTracker::Summary total = LatencyTracker::summarize(-1, LatencyTracker::ONSET_TO_SENT);
+    if ((long)total.p99 > maxLatencyUS) {
+      fprintf(stderr, "p99 latency %lu us is over the limit of %ld us\n", (unsigned long)total.p99, maxLatencyUS);
+      failed = true;
+    }
+  }
+  #else
+  if (maxLatencyUS >= 0) {
+    fprintf(stderr, "--max-latency needs USE_LATENCY_TRACKER (config.h)\n");
+    return 1;
+  }
+  #endif
+  return failed ? 2 : 0;
+}
@@ -0,0 +1,63 @@
+// Host shim for the teensy ADC library (https://github.com/pedvide/ADC), backed by the mock ADC
+// (host::setAnalogReader). Each conversion advances the virtual clock by host::conversionTimeUS().
+#pragma once
+#include "Arduino.h"
+
+enum class ADC_CONVERSION_SPEED { VERY_LOW_SPEED, LOW_SPEED, MED_SPEED, HIGH_SPEED_16BITS, HIGH_SPEED, VERY_HIGH_SPEED };
+enum class ADC_SAMPLING_SPEED { VERY_LOW_SPEED, LOW_SPEED, MED_SPEED, HIGH_SPEED, VERY_HIGH_SPEED };
+
+class ADC_Module {
+public:
+  void setAveraging(uint8_t num) { _averaging = num; }
+  void setResolution(uint8_t bits) { (void)bits; }
+  void setConversionSpeed(ADC_CONVERSION_SPEED speed) { (void)speed; }
+  void setSamplingSpeed(ADC_SAMPLING_SPEED speed) { (void)speed; }
+  int analogRead(uint8_t pin) { return ::analogRead(pin); }
+  // the input is sampled when the conversion starts, as on the board
+  bool startSingleRead(uint8_t pin) { _value = host::readAnalog(pin); _startUS = micros(); return true; }
+  // time only passes on the host when something waits, so polling waits out the rest of the conversion
+  bool isComplete() {
+    uint32_t elapsedUS = micros() - _startUS;
+    if (elapsedUS < host::conversionTimeUS()) {
+      host::advanceMicros(host::conversionTimeUS() - elapsedUS);
+    }
+    return true;
+  }
+  int readSingle() { return _value; }
+
+private:
+  uint8_t _averaging = 1;
+  int _value = 0;
+  uint32_t _startUS = 0;
+};
+
+class ADC {
+public:
+  struct Sync_result {
+    int32_t result_adc0;
+    int32_t result_adc1;
+  };
+
+  ADC_Module* adc0 = &_adc0;
+  ADC_Module* adc1 = &_adc1;
+
+  Sync_result analogSynchronizedRead(uint8_t pin0, uint8_t pin1) {
+    // both conversions happen at the same time, so only advance the clock once
+    host::advanceMicros(host::conversionTimeUS());
+    return Sync_result{host::readAnalog(pin0), host::readAnalog(pin1)};
+  }
+
+  bool startSynchronizedSingleRead(uint8_t pin0, uint8_t pin1) {
+    _adc0.startSingleRead(pin0);
+    _adc1.startSingleRead(pin1);
+    return true;
+  }
+
+  Sync_result readSynchronizedSingle() {
+    return Sync_result{_adc0.readSingle(), _adc1.readSingle()};
+  }
+
+private:
+  ADC_Module _adc0;
+  ADC_Module _adc1;
+};
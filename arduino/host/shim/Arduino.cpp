@@ -0,0 +1,127 @@
+#include "Arduino.h"
+#include <vector>
+
+HostSerial Serial;
+
+namespace {
+  uint32_t g_nowUS = 0;
+  uint32_t g_conversionTimeUS = 1;
+  uint8_t g_digitalState[256];
+  host::AnalogReader g_analogReader = nullptr;
+  // running IntervalTimers, and whether a callback is running (callbacks don't nest)
+  std::vector<IntervalTimer*> g_timers;
+  bool g_inTimer = false;
+}
+
+namespace host {
+  uint32_t nowUS() { return g_nowUS; }
+  void setMicros(uint32_t us) { g_nowUS = us; }
+  void advanceMicros(uint32_t us) {
+    uint32_t targetUS = g_nowUS + us;
+    if (!g_inTimer) {
+      g_inTimer = true;
+      // earliest due timer first, until none are due by the target time
+      while (true) {
+        IntervalTimer* next = nullptr;
+        for (IntervalTimer* timer : g_timers) {
+          if ((int32_t)(targetUS - timer->nextUS()) >= 0
+              && (!next || (int32_t)(next->nextUS() - timer->nextUS()) > 0)) {
+            next = timer;
+          }
+        }
+        if (!next) {
+          break;
+        }
+        next->fireDue(targetUS);
+      }
+      g_inTimer = false;
+    }
+    if ((int32_t)(targetUS - g_nowUS) > 0) {
+      g_nowUS = targetUS;
+    }
+  }
+  int digitalState(uint8_t pin) { return g_digitalState[pin]; }
+  void setAnalogReader(AnalogReader reader) { g_analogReader = reader; }
+  int readAnalog(uint8_t pin) { return g_analogReader ? g_analogReader(pin) : 0; }
+  void setConversionTimeUS(uint32_t us) { g_conversionTimeUS = us; }
+  uint32_t conversionTimeUS() { return g_conversionTimeUS; }
+}
+
+bool IntervalTimer::begin(void (*callback)(), uint32_t periodUS) {
+  end();
+  if (!callback || periodUS == 0) {
+    return false;
+  }
+  _callback = callback;
+  _periodUS = periodUS;
+  _nextUS = g_nowUS + periodUS;
+  g_timers.push_back(this);
+  return true;
+}
+
+void IntervalTimer::end() {
+  for (size_t i = 0; i < g_timers.size(); i++) {
+    if (g_timers[i] == this) {
+      g_timers.erase(g_timers.begin() + i);
+      break;
+    }
+  }
+  _callback = nullptr;
+}
+
+bool IntervalTimer::fireDue(uint32_t untilUS) {
+  if (!_callback || (int32_t)(untilUS - _nextUS) < 0) {
+    return false;
+  }
+  if ((int32_t)(_nextUS - g_nowUS) > 0) {
+    g_nowUS = _nextUS;
+  }
+  _nextUS += _periodUS;
+  _callback();
+  return true;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t value) { g_digitalState[pin] = value ? 1 : 0; }
+int digitalRead(uint8_t pin) { return g_digitalState[pin]; }
+
+int analogRead(uint8_t pin) {
+  host::advanceMicros(g_conversionTimeUS);
+  return host::readAnalog(pin);
+}
+
+long random(long howbig) { return howbig > 0 ? std::rand() % howbig : 0; }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+void randomSeed(unsigned long seed) { std::srand((unsigned)seed); }
+
+size_t HostSerial::write(uint8_t b) {
+  _output.push_back((char)b);
+  if (_echo) { fputc(b, stdout); }
+  return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size) {
+  _output.append((const char*)buffer, size);
+  if (_echo) { fwrite(buffer, 1, size, stdout); }
+  return size;
+}
+
+size_t HostSerial::printf(const char* format, ...) {
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (n < 0) { return 0; }
+  return write((const uint8_t*)buffer, min((size_t)n, sizeof(buffer) - 1));
+}
+
+int HostSerial::read() {
+  if (_inputPos >= _input.size()) { return -1; }
+  return (uint8_t)_input[_inputPos++];
+}
+
+int HostSerial::peek() {
+  if (_inputPos >= _input.size()) { return -1; }
+  return (uint8_t)_input[_inputPos];
+}
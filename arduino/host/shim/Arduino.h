@@ -0,0 +1,139 @@
+// Minimal Arduino core shim for the host (Linux) build.
+// Only the parts of the Arduino/Teensy API used by arduino/src are provided.
+// Time is virtual: micros()/millis() only advance when the host driver (or a delay) advances them.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdarg>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LED_BUILTIN 13
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Teensy style min/max/constrain (templates rather than macros, so std headers still work)
+template <class A, class B>
+constexpr auto min(A a, B b) -> typename std::decay<decltype(a < b ? a : b)>::type { return (b < a) ? b : a; }
+template <class A, class B>
+constexpr auto max(A a, B b) -> typename std::decay<decltype(a < b ? a : b)>::type { return (a < b) ? b : a; }
+template <class T, class L, class H>
+constexpr T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+namespace host {
+  // virtual clock, in microseconds
+  uint32_t nowUS();
+  void setMicros(uint32_t us);
+  void advanceMicros(uint32_t us);
+
+  // digital pin state, as set by digitalWrite (used by the mock ADC to work out mux addresses)
+  int digitalState(uint8_t pin);
+
+  // the mock ADC backend: returns the value seen on an analog pin, given the current pin states
+  typedef int (*AnalogReader)(uint8_t pin);
+  void setAnalogReader(AnalogReader reader);
+  int readAnalog(uint8_t pin);
+  // virtual time taken by one ADC conversion
+  void setConversionTimeUS(uint32_t us);
+  uint32_t conversionTimeUS();
+}
+
+inline uint32_t micros() { return host::nowUS(); }
+inline uint32_t millis() { return host::nowUS() / 1000; }
+inline void delayMicroseconds(uint32_t us) { host::advanceMicros(us); }
+inline void delay(uint32_t ms) { host::advanceMicros(ms * 1000); }
+// nothing runs concurrently on the host (timers fire from advanceMicros), so these do nothing
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+/**
+ * @brief Teensy IntervalTimer, on the virtual clock
+ *
+ * The callback runs from host::advanceMicros, at each multiple of the period the clock passes, with
+ * the clock set to the time it is due. host::setMicros doesn't run callbacks.
+ */
+class IntervalTimer {
+public:
+  ~IntervalTimer() { end(); }
+  bool begin(void (*callback)(), uint32_t periodUS);
+  void end();
+  void priority(uint8_t level) { (void)level; }
+
+  // host side: run the callback if it is due at or before untilUS, returns false if it isn't
+  bool fireDue(uint32_t untilUS);
+  uint32_t nextUS() const { return _nextUS; }
+
+private:
+  void (*_callback)() = nullptr;
+  uint32_t _periodUS = 0;
+  uint32_t _nextUS = 0;
+};
+
+/**
+ * @brief In-memory serial port
+ *
+ * Everything printed is appended to an output string (and optionally echoed to stdout).
+ * Input can be queued with inject() for testing serial commands.
+ */
+class HostSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t b);
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t print(const char* s) { return write(s); }
+  size_t print(const std::string& s) { return write((const uint8_t*)s.data(), s.size()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n) { return printf("%d", n); }
+  size_t print(unsigned int n) { return printf("%u", n); }
+  size_t print(long n) { return printf("%ld", n); }
+  size_t print(unsigned long n) { return printf("%lu", n); }
+  size_t print(double n) { return printf("%.2f", n); }
+  template <class T>
+  size_t println(T value) { size_t n = print(value); return n + write("\r\n"); }
+  size_t println() { return write("\r\n"); }
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  void flush() {}
+  int availableForWrite() { return _writeCapacity; }
+  int available() { return (int)(_input.size() - _inputPos); }
+  int read();
+  int peek();
+  operator bool() { return true; }
+
+  // host side helpers
+  void inject(const char* text) { _input += text; }
+  const std::string& output() const { return _output; }
+  void clearOutput() { _output.clear(); }
+  void setEcho(bool echo) { _echo = echo; }
+  void setWriteCapacity(int bytes) { _writeCapacity = bytes; }
+
+private:
+  std::string _output;
+  std::string _input;
+  size_t _inputPos = 0;
+  bool _echo = false;
+  int _writeCapacity = 4096;
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,78 @@
+// Host shim for https://github.com/michalmonday/CSV-Parser-for-Arduino
+// Supports the column types used in arduino/src: 'd' (int16_t), 'L' (int32_t), 'f' (float)
+#pragma once
+#include "SD.h"
+#include <string>
+#include <vector>
+
+class CSV_Parser {
+public:
+  CSV_Parser(const char* format, bool hasHeader = true, char delimiter = ',')
+    : _format(format), _hasHeader(hasHeader), _delimiter(delimiter) {}
+
+  bool readSDfile(const char* path) {
+    File f = SD.open(path, FILE_READ);
+    if (!f) { return false; }
+    std::string text;
+    while (f.available()) { text.push_back((char)f.read()); }
+    std::vector<std::vector<std::string>> rows;
+    size_t start = 0;
+    while (start < text.size()) {
+      size_t end = text.find('\n', start);
+      if (end == std::string::npos) { end = text.size(); }
+      std::string line = text.substr(start, end - start);
+      if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+      if (!line.empty()) { rows.push_back(split(line)); }
+      start = end + 1;
+    }
+    if (rows.empty()) { return false; }
+    size_t nCols = _format.size();
+    if (_hasHeader) {
+      _headers = rows.front();
+      rows.erase(rows.begin());
+    }
+    _columns.assign(nCols, std::vector<uint8_t>());
+    for (size_t c = 0; c < nCols; c++) {
+      size_t width = _format[c] == 'd' ? sizeof(int16_t) : 4;
+      _columns[c].resize(width * rows.size());
+      for (size_t r = 0; r < rows.size(); r++) {
+        const char* cell = c < rows[r].size() ? rows[r][c].c_str() : "0";
+        uint8_t* dst = _columns[c].data() + r * width;
+        if (_format[c] == 'd') { int16_t v = (int16_t)atoi(cell); memcpy(dst, &v, sizeof(v)); }
+        else if (_format[c] == 'f') { float v = (float)atof(cell); memcpy(dst, &v, sizeof(v)); }
+        else { int32_t v = (int32_t)atol(cell); memcpy(dst, &v, sizeof(v)); }
+      }
+    }
+    _rows = (int)rows.size();
+    return true;
+  }
+
+  void* operator[](const char* name) {
+    for (size_t c = 0; c < _headers.size() && c < _columns.size(); c++) {
+      if (_headers[c] == name) { return _columns[c].data(); }
+    }
+    return nullptr;
+  }
+
+  int getRowsCount() const { return _rows; }
+
+private:
+  std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> cells;
+    size_t start = 0;
+    while (true) {
+      size_t end = line.find(_delimiter, start);
+      cells.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+      if (end == std::string::npos) { break; }
+      start = end + 1;
+    }
+    return cells;
+  }
+
+  std::string _format;
+  bool _hasHeader;
+  char _delimiter;
+  std::vector<std::string> _headers;
+  std::vector<std::vector<uint8_t>> _columns;
+  int _rows = 0;
+};
@@ -0,0 +1,71 @@
+// Host shim for https://github.com/rlogiacco/CircularBuffer (same interface, same semantics)
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t S, typename IT = size_t>
+class CircularBuffer {
+public:
+  static constexpr IT capacity = static_cast<IT>(S);
+  using index_t = IT;
+
+  CircularBuffer() : head(buffer), tail(buffer), count(0) {}
+
+  // adds an element to the beginning of the buffer
+  bool unshift(T value) {
+    if (head == buffer) { head = buffer + capacity; }
+    *--head = value;
+    if (count == capacity) {
+      if (tail-- == buffer) { tail = buffer + capacity - 1; }
+      return false;
+    }
+    if (count++ == 0) { tail = head; }
+    return true;
+  }
+
+  // adds an element to the end of the buffer
+  bool push(T value) {
+    if (++tail == buffer + capacity) { tail = buffer; }
+    *tail = value;
+    if (count == capacity) {
+      if (++head == buffer + capacity) { head = buffer; }
+      return false;
+    }
+    if (count++ == 0) { head = tail; }
+    return true;
+  }
+
+  T shift() {
+    if (count == 0) { return *head; }
+    T result = *head++;
+    if (head >= buffer + capacity) { head = buffer; }
+    count--;
+    return result;
+  }
+
+  T pop() {
+    if (count == 0) { return *tail; }
+    T result = *tail--;
+    if (tail < buffer) { tail = buffer + capacity - 1; }
+    count--;
+    return result;
+  }
+
+  T inline first() const { return *head; }
+  T inline last() const { return *tail; }
+  T operator[](IT index) const {
+    if (index >= count) { return *tail; }
+    return *(buffer + ((head - buffer + index) % capacity));
+  }
+  IT inline size() const { return count; }
+  IT inline available() const { return capacity - count; }
+  bool inline isEmpty() const { return count == 0; }
+  bool inline isFull() const { return count == capacity; }
+  void inline clear() { head = tail = buffer; count = 0; }
+
+private:
+  T buffer[S];
+  T* head;
+  T* tail;
+  IT count;
+};
@@ -0,0 +1,52 @@
+// Host shim for the Arduino SD library: an in-memory filesystem
+#pragma once
+#include "Arduino.h"
+#include <map>
+#include <string>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+#define BUILTIN_SDCARD 254
+
+class File {
+public:
+  File() : _contents(nullptr), _pos(0) {}
+  explicit File(std::string* contents) : _contents(contents), _pos(0) {}
+  operator bool() const { return _contents != nullptr; }
+  size_t write(uint8_t b) { if (!_contents) { return 0; } _contents->push_back((char)b); return 1; }
+  size_t write(const uint8_t* buffer, size_t size) { if (!_contents) { return 0; } _contents->append((const char*)buffer, size); return size; }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(int n) { return print(std::to_string(n).c_str()); }
+  size_t println(const char* s) { return print(s) + print("\r\n"); }
+  size_t println(int n) { return print(n) + print("\r\n"); }
+  int available() { return _contents ? (int)(_contents->size() - _pos) : 0; }
+  int read() { return available() > 0 ? (uint8_t)(*_contents)[_pos++] : -1; }
+  int peek() { return available() > 0 ? (uint8_t)(*_contents)[_pos] : -1; }
+  size_t size() { return _contents ? _contents->size() : 0; }
+  void close() { _contents = nullptr; }
+
+private:
+  std::string* _contents;
+  size_t _pos;
+};
+
+class SDClass {
+public:
+  bool begin(uint8_t csPin) { (void)csPin; return _present; }
+  bool exists(const char* path) { return _files.count(path) > 0; }
+  bool remove(const char* path) { return _files.erase(path) > 0; }
+  File open(const char* path, uint8_t mode = FILE_READ) {
+    if (mode == FILE_READ && !exists(path)) { return File(); }
+    return File(&_files[path]);
+  }
+
+  // host side helpers
+  void setPresent(bool present) { _present = present; }
+  std::map<std::string, std::string>& files() { return _files; }
+
+private:
+  bool _present = true;
+  std::map<std::string, std::string> _files;
+};
+
+extern SDClass SD;
@@ -0,0 +1,2 @@
+// Host shim: SPI is not used directly by arduino/src
+#pragma once
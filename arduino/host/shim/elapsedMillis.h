@@ -0,0 +1,31 @@
+// Host shim for https://github.com/pfeerick/elapsedMillis, driven by the virtual clock
+#pragma once
+#include "Arduino.h"
+
+class elapsedMillis {
+private:
+  unsigned long ms;
+public:
+  elapsedMillis(void) { ms = millis(); }
+  elapsedMillis(unsigned long val) { ms = millis() - val; }
+  elapsedMillis(const elapsedMillis& orig) { ms = orig.ms; }
+  operator unsigned long() const { return millis() - ms; }
+  elapsedMillis& operator=(const elapsedMillis& rhs) { ms = rhs.ms; return *this; }
+  elapsedMillis& operator=(unsigned long val) { ms = millis() - val; return *this; }
+  elapsedMillis& operator-=(unsigned long val) { ms += val; return *this; }
+  elapsedMillis& operator+=(unsigned long val) { ms -= val; return *this; }
+};
+
+class elapsedMicros {
+private:
+  unsigned long us;
+public:
+  elapsedMicros(void) { us = micros(); }
+  elapsedMicros(unsigned long val) { us = micros() - val; }
+  elapsedMicros(const elapsedMicros& orig) { us = orig.us; }
+  operator unsigned long() const { return micros() - us; }
+  elapsedMicros& operator=(const elapsedMicros& rhs) { us = rhs.us; return *this; }
+  elapsedMicros& operator=(unsigned long val) { us = micros() - val; return *this; }
+  elapsedMicros& operator-=(unsigned long val) { us += val; return *this; }
+  elapsedMicros& operator+=(unsigned long val) { us -= val; return *this; }
+};
@@ -0,0 +1,6 @@
+#include "SD.h"
+#include "usb_midi.h"
+
+SDClass SD;
+usb_midi_class usbMIDI;
+namespace host { std::vector<UsbMidiEvent> usbMidiLog; }
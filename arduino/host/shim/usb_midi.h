@@ -0,0 +1,34 @@
+// Host shim for the teensy usbMIDI object; events are appended to host::usbMidiLog
+#pragma once
+#include "Arduino.h"
+#include <vector>
+
+namespace host {
+  struct UsbMidiEvent {
+    uint32_t timeUS;
+    uint8_t type; // 0x90 note on, 0x80 note off, 0xB0 control change
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t channel;
+    // number of send_now() calls before this event was queued, i.e. which USB transfer it went out in
+    uint32_t flushIndex;
+  };
+  extern std::vector<UsbMidiEvent> usbMidiLog;
+}
+
+class usb_midi_class {
+public:
+  void sendNoteOn(uint8_t note, uint8_t velocity, uint8_t channel) { log(0x90, note, velocity, channel); }
+  void sendNoteOff(uint8_t note, uint8_t velocity, uint8_t channel) { log(0x80, note, velocity, channel); }
+  void sendControlChange(uint8_t control, uint8_t value, uint8_t channel) { log(0xB0, control, value, channel); }
+  void send_now() { _flushCount++; }
+  bool read() { return false; }
+
+private:
+  void log(uint8_t type, uint8_t d1, uint8_t d2, uint8_t channel) {
+    host::usbMidiLog.push_back(host::UsbMidiEvent{micros(), type, d1, d2, channel, _flushCount});
+  }
+  uint32_t _flushCount = 0;
+};
+
+extern usb_midi_class usbMIDI;
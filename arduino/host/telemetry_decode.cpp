@@ -0,0 +1,41 @@
+// Decodes a binary telemetry stream (see src/Telemetry.h), e.g. captured from the serial port while
+// the firmware is in "pm telemetry" mode, or written by host_sim --telemetry, into csv.
+// Prints the number of frames, dropped frames and bad packets to stderr.
+//
+// usage: telemetry_decode capture.bin [out.csv]
+#include <stdio.h>
+#include "TelemetryDecoder.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s capture.bin [out.csv]\n", argv[0]);
+    return 1;
+  }
+  FILE* in = fopen(argv[1], "rb");
+  if (!in) {
+    fprintf(stderr, "could not read %s\n", argv[1]);
+    return 1;
+  }
+  FILE* out = stdout;
+  if (argc == 3) {
+    out = fopen(argv[2], "w");
+    if (!out) {
+      fprintf(stderr, "could not write %s\n", argv[2]);
+      fclose(in);
+      return 1;
+    }
+  }
+  TelemetryDecoder decoder(out);
+  uint8_t buffer[65536];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+    decoder.feed(buffer, n);
+  }
+  fclose(in);
+  if (out != stdout) {
+    fclose(out);
+  }
+  fprintf(stderr, "%ld frames, %ld dropped, %ld bad packets\n", decoder.frameCount(), decoder.droppedFrames(),
+          decoder.badPackets());
+  return decoder.hasSchema() ? 0 : 2;
+}
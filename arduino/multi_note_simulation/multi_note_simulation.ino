@@ -7,8 +7,20 @@
 #include <math.h>
 #include <Bounce2.h>
 #include "KeyHammer.h"
+#include "KeyBank.h"
 #include "Pedal.h"
 #include "DualAdcManager.h"
+#include "ScanClock.h"
+#include "AdcTraceWriter.h"
+#include "TelemetryWriter.h"
+#include "ScanScheduler.h"
+#include "AdcFrameScanner.h"
+#include "ScanPlan.h"
+#include "MuxSettleTable.h"
+#include "CrosstalkTable.h"
+#include "MidiQueue.h"
+#include "DriftTracker.h"
+#include "KeyScan.h"
 #include <ParamHandler.h>
 
 // board specific imports and midi setup
@@ -114,7 +126,7 @@ const int MIDI_G = 31 + shift;
 const int MIDI_Ab = 32 + shift;
 
 // mapping of pitch numbers to mux addresses, with A=0
-const int pC2muxAddr[] = {
+constexpr int pC2muxAddr[] = {
   6, 4, 7, 3, 1, 0, // A to Eb indexes on left mux
   4, 6, 7, 1, 3, 0 // Eb to Ab indexes on right mux
 }; // 7 resolves to 6, 3 and 1 to 0
@@ -253,6 +265,180 @@ Pedal pedals[] = {
 const int n_keys = sizeof(keys) / sizeof(keys[0]);
 const int nPedals = sizeof(pedals) / sizeof(pedals[0]);
 
+#ifdef USE_SCAN_PLAN
+  // signal pin and mux input of each key, in the same order as keys[]
+  // (the pin each key's adc function reads, at the address of the bus that pin's mux is on)
+  const ScanPlan::Channel keyChannels[] = {
+  // A / pc 0
+  {SP_LD3, pC2muxAddr[0]}, // MIDI_A
+  {SP_LD2, pC2muxAddr[0]}, // MIDI_A+12
+  {SP_LD1, pC2muxAddr[0]}, // MIDI_A+24
+  {SP_LM, pC2muxAddr[0]}, // MIDI_A+36
+  {SP_LU1, pC2muxAddr[0]}, // MIDI_A+48
+  {SP_LU2, pC2muxAddr[0]}, // MIDI_A+60
+  {SP_LU3, pC2muxAddr[0]}, // MIDI_A+72
+  // Eb / pc 6
+  {SP_RD3, pC2muxAddr[6]}, // MIDI_Eb
+  {SP_RD2, pC2muxAddr[6]}, // MIDI_Eb+12
+  {SP_RD1, pC2muxAddr[6]}, // MIDI_Eb+24
+  {SP_RM, pC2muxAddr[6]}, // MIDI_Eb+36
+  {SP_RU1, pC2muxAddr[6]}, // MIDI_Eb+48
+  {SP_RU2, pC2muxAddr[6]}, // MIDI_Eb+60
+  {SP_RU3, pC2muxAddr[6]}, // MIDI_Eb+72
+  // Bb / pc 1
+  {SP_LD3, pC2muxAddr[1]}, // MIDI_Bb
+  {SP_LD2, pC2muxAddr[1]}, // MIDI_Bb+12
+  {SP_LD1, pC2muxAddr[1]}, // MIDI_Bb+24
+  {SP_LM, pC2muxAddr[1]}, // MIDI_Bb+36
+  {SP_LU1, pC2muxAddr[1]}, // MIDI_Bb+48
+  {SP_LU2, pC2muxAddr[1]}, // MIDI_Bb+60
+  {SP_LU3, pC2muxAddr[1]}, // MIDI_Bb+72
+  // E / pc 7
+  {SP_RD3, pC2muxAddr[7]}, // MIDI_E
+  {SP_RD2, pC2muxAddr[7]}, // MIDI_E+12
+  {SP_RD1, pC2muxAddr[7]}, // MIDI_E+24
+  {SP_RM, pC2muxAddr[7]}, // MIDI_E+36
+  {SP_RU1, pC2muxAddr[7]}, // MIDI_E+48
+  {SP_RU2, pC2muxAddr[7]}, // MIDI_E+60
+  {SP_RU3, pC2muxAddr[7]}, // MIDI_E+72
+  // B / pc 2
+  {SP_LD3, pC2muxAddr[2]}, // MIDI_B
+  {SP_LD2, pC2muxAddr[2]}, // MIDI_B+12
+  {SP_LD1, pC2muxAddr[2]}, // MIDI_B+24
+  {SP_LM, pC2muxAddr[2]}, // MIDI_B+36
+  {SP_LU1, pC2muxAddr[2]}, // MIDI_B+48
+  {SP_LU2, pC2muxAddr[2]}, // MIDI_B+60
+  {SP_LU3, pC2muxAddr[2]}, // MIDI_B+72
+  // F / pc 8
+  {SP_RD3, pC2muxAddr[8]}, // MIDI_F
+  {SP_RD2, pC2muxAddr[8]}, // MIDI_F+12
+  {SP_RD1, pC2muxAddr[8]}, // MIDI_F+24
+  {SP_RM, pC2muxAddr[8]}, // MIDI_F+36
+  {SP_RU1, pC2muxAddr[8]}, // MIDI_F+48
+  {SP_RU2, pC2muxAddr[8]}, // MIDI_F+60
+  {SP_RU3, pC2muxAddr[8]}, // MIDI_F+72
+  // C / pc 3
+  {SP_LD3, pC2muxAddr[3]}, // MIDI_C
+  {SP_LD2, pC2muxAddr[3]}, // MIDI_C+12
+  {SP_LD1, pC2muxAddr[3]}, // MIDI_C+24
+  {SP_LM, pC2muxAddr[3]}, // MIDI_C+36
+  {SP_LU1, pC2muxAddr[3]}, // MIDI_C+48
+  {SP_LU2, pC2muxAddr[3]}, // MIDI_C+60
+  {SP_LU3, pC2muxAddr[3]}, // MIDI_C+72
+  // Gb / pc 9
+  {SP_RD3, pC2muxAddr[9]}, // MIDI_Gb
+  {SP_RD2, pC2muxAddr[9]}, // MIDI_Gb+12
+  {SP_RD1, pC2muxAddr[9]}, // MIDI_Gb+24
+  {SP_RM, pC2muxAddr[9]}, // MIDI_Gb+36
+  {SP_RU1, pC2muxAddr[9]}, // MIDI_Gb+48
+  {SP_RU2, pC2muxAddr[9]}, // MIDI_Gb+60
+  {SP_RU3, pC2muxAddr[9]}, // MIDI_Gb+72
+  // Db / pc 4
+  {SP_LD3, pC2muxAddr[4]}, // MIDI_Db
+  {SP_LD2, pC2muxAddr[4]}, // MIDI_Db+12
+  {SP_LD1, pC2muxAddr[4]}, // MIDI_Db+24
+  {SP_LM, pC2muxAddr[4]}, // MIDI_Db+36
+  {SP_LU1, pC2muxAddr[4]}, // MIDI_Db+48
+  {SP_LU2, pC2muxAddr[4]}, // MIDI_Db+60
+  {SP_LU3, pC2muxAddr[4]}, // MIDI_Db+72
+  // G / pc 10
+  {SP_RD3, pC2muxAddr[10]}, // MIDI_G
+  {SP_RD2, pC2muxAddr[10]}, // MIDI_G+12
+  {SP_RD1, pC2muxAddr[10]}, // MIDI_G+24
+  {SP_RM, pC2muxAddr[10]}, // MIDI_G+36
+  {SP_RU1, pC2muxAddr[10]}, // MIDI_G+48
+  {SP_RU2, pC2muxAddr[10]}, // MIDI_G+60
+  {SP_RU3, pC2muxAddr[10]}, // MIDI_G+72
+  // D / pc 5
+  {SP_LD3, pC2muxAddr[5]}, // MIDI_D
+  {SP_LD2, pC2muxAddr[5]}, // MIDI_D+12
+  {SP_LD1, pC2muxAddr[5]}, // MIDI_D+24
+  {SP_LM, pC2muxAddr[5]}, // MIDI_D+36
+  {SP_LU1, pC2muxAddr[5]}, // MIDI_D+48
+  {SP_LU2, pC2muxAddr[5]}, // MIDI_D+60
+  {SP_LU3, pC2muxAddr[5]}, // MIDI_D+72
+  // Ab / pc 11
+  {SP_RD3, pC2muxAddr[11]}, // MIDI_Ab
+  {SP_RD2, pC2muxAddr[11]}, // MIDI_Ab+12
+  {SP_RD1, pC2muxAddr[11]}, // MIDI_Ab+24
+  {SP_RM, pC2muxAddr[11]}, // MIDI_Ab+36
+  {SP_RU1, pC2muxAddr[11]}, // MIDI_Ab+48
+  {SP_RU2, pC2muxAddr[11]}, // MIDI_Ab+60
+  {SP_RU3, pC2muxAddr[11]}, // MIDI_Ab+72
+  };
+  static_assert(sizeof(keyChannels) / sizeof(keyChannels[0]) == n_keys, "keyChannels must have an entry per key");
+#endif
+
+#if defined(USE_SCAN_PLAN) || defined(USE_CROSSTALK_COMPENSATION)
+  // bus (0: addressPinsL, 1: addressPinsR) and ADCs of each signal pin, in the same order as signalPins[]
+  const ScanPlan::Pin planPins[] = {
+    {0, ScanPlan::ADC_BOTH}, // LU3
+    {0, ScanPlan::ADC_BOTH}, // LU2
+    {0, ScanPlan::ADC_BOTH}, // LU1
+    {1, ScanPlan::ADC_BOTH}, // RU3
+    {1, ScanPlan::ADC_BOTH}, // RU2
+    {1, ScanPlan::ADC_BOTH}, // RU1
+    {0, ScanPlan::ADC_BOTH}, // LM
+    {1, ScanPlan::ADC_BOTH}, // RM
+    {0, ScanPlan::ADC_BOTH}, // LD1
+    {0, ScanPlan::ADC_BOTH}, // LD2
+    {0, ScanPlan::ADC_BOTH}, // LD3
+    {1, ScanPlan::ADC_BOTH}, // RD1
+    {1, ScanPlan::ADC_1}, // RD2, pin 39
+    {1, ScanPlan::ADC_1}, // RD3, pin 38
+  };
+#endif
+
+#ifdef USE_CROSSTALK_COMPENSATION
+  // carry-over of each mux input from the one read before it, measured in setup (and by the xtalk command)
+  CrosstalkTable crosstalkTable;
+#endif
+
+#ifdef USE_SCAN_PLAN
+  // order of reads for a full scan, built in setup
+  ScanPlan scanPlan;
+  #ifdef USE_MUX_SETTLE_TABLE
+    // settle time of each mux address change, measured in setup (and by the settle command)
+    MuxSettleTable settleTable;
+  #endif
+#endif
+
+#ifdef USE_KEY_BANK
+  // steps all keys in one batched pass, with keys[] holding calibration / params
+  KeyBank keyBank;
+#endif
+
+#ifdef USE_SCAN_SCHEDULER
+  // reads moving keys every scan, resting keys and pedals every SCAN_SLOW_DIVIDER scans
+  ScanScheduler scheduler;
+#endif
+
+#ifdef USE_DRIFT_TRACKING
+  // follows drift in each key's resting / bottomed out adc values, one key per scan
+  DriftTracker driftTracker;
+#endif
+
+// reads and steps every key and pedal each scan, through the bank / scheduler / plan above
+KeyScan keyScan;
+
+#ifdef USE_BACKGROUND_ADC
+  // reads all keys from a timer interrupt, one frame per scan
+  AdcFrameScanner adcScanner;
+#endif
+
+// sampled once per loop, and passed to all keys
+ScanClock scanClock;
+// time of the last scan
+uint32_t lastScanUS = 0;
+
+// records raw adc values of every key and pedal, every scan, to the SD card (see AdcTrace.h)
+// replay with host_sim --replay
+AdcTraceWriter traceWriter;
+// binary stream of the print keys' state every scan, for "pm telemetry"
+TelemetryWriter telemetry;
+const char* traceFile = "/trace.bin";
+uint16_t traceFrame[n_keys + nPedals];
+
 int printkey = 0;
 bool printAllKeys = false;
 
@@ -265,10 +451,18 @@ const char* helpString = "Commands:\n"
                           "tc: toggle calibration of thresholds\n"
                           "ts: save updated thresholds to sd card\n"
                           "pp: print key parameters (including calibration results)\n"
-                          "pm: change print mode (stream, buffers, notes, none)\n"
+                          "pm: change print mode (stream, telemetry, buffers [bytes per scan], notes, none)\n"
                           "pk: set print key (0-(nKeys-1), +, -)\n"
                           "pka: toggle print attributes (applicable to stream mode)\n"
                           "pf: set print frequency (ms)\n"
+                          "prof: print profiling results ('prof reset' to clear them)\n"
+                          "trace: record raw adc values to the sd card (start, stop)\n"
+                          "plan: print the scan plan (conversions and mux changes per scan)\n"
+                          "settle: measure the settle time of each mux address change (keys at rest)\n"
+                          "xtalk: measure the carry-over between mux inputs (keys at rest)\n"
+                          "mq: print midi queue depth and drops ('mq reset' to clear them)\n"
+                          "lat: print note on latency (pitch), ('lat <pitch>' for one key, 'lat reset' to clear)\n"
+                          "drift: print how far keys' up/down adc values have followed drift\n"
                           "h / help: show this message\n"
                           ;
                           
@@ -280,6 +474,9 @@ void printHelp() {
 
 void setup() {
   Serial.begin(57600);
+  #ifdef USE_PROFILER
+    Profiler::begin();
+  #endif
   pinMode(LED_BUILTIN, OUTPUT);
   
   #ifdef USE_CALIBRATION_BUTTON
@@ -297,6 +494,14 @@ void setup() {
   sCmd.addCommand("pk", setPrintKey);
   sCmd.addCommand("pka", togglePrintAttributes);
   sCmd.addCommand("pf", setPrintFrequency);
+  sCmd.addCommand("prof", printProfile);
+  sCmd.addCommand("lat", printLatency);
+  sCmd.addCommand("mq", printMidiQueue);
+  sCmd.addCommand("drift", printDrift);
+  sCmd.addCommand("plan", printScanPlan);
+  sCmd.addCommand("settle", measureSettle);
+  sCmd.addCommand("xtalk", measureCrosstalk);
+  sCmd.addCommand("trace", setTrace);
   sCmd.setDefaultHandler(unrecognizedCmd);
 
   midiSender.initialize();
@@ -324,6 +529,53 @@ void setup() {
   int nAddressPins = sizeof(addressPinsL) / sizeof(addressPinsL[0]);
   int nSignalPins = sizeof(signalPins) / sizeof(signalPins[0]);
   dualAdcManager.begin(addressPinsL, addressPinsR, signalPins, nSignalPins);
+  #ifdef USE_CROSSTALK_COMPENSATION
+    // before anything reads the keys
+    crosstalkTable.calibrate(&dualAdcManager, planPins, nSignalPins, settle_delay);
+    crosstalkTable.apply(&dualAdcManager);
+  #endif
+  // time each sample by its conversion, rather than by the start of the scan
+  KeyHammer::setSampleClock([]() -> uint32_t { return dualAdcManager.getConversionUS(); });
+
+  #ifdef USE_KEY_BANK
+    // after loading params, so the bank picks up thresholds from the SD card
+    keyBank.begin(keys, n_keys);
+  #endif
+  #ifdef USE_DRIFT_TRACKING
+    // also after loading params, so drift is followed from the values on the SD card
+    driftTracker.begin(keys, n_keys);
+  #endif
+  #ifdef USE_SCAN_SCHEDULER
+    scheduler.begin(&dualAdcManager, keys, n_keys, pedals, nPedals);
+  #endif
+  #ifdef USE_SCAN_PLAN
+    if (!scanPlan.build(keyChannels, n_keys, planPins, nSignalPins)) {
+      Serial.printf("could not build scan plan: %s\n", scanPlan.getError());
+    }
+    #ifdef USE_MUX_SETTLE_TABLE
+      settleTable.characterise(&dualAdcManager, planPins, nSignalPins);
+      scanPlan.applySettleTable(&settleTable);
+      #ifdef USE_CROSSTALK_COMPENSATION
+        crosstalkTable.apply(&dualAdcManager);
+      #endif
+    #endif
+  #endif
+  keyScan.begin(keys, n_keys, pedals, nPedals, &midiSender);
+  #ifdef USE_KEY_BANK
+    keyScan.setBank(&keyBank);
+  #endif
+  #ifdef USE_SCAN_SCHEDULER
+    keyScan.setScheduler(&scheduler);
+  #endif
+  #ifdef USE_SCAN_PLAN
+    keyScan.setPlan(&scanPlan, &dualAdcManager, settle_delay);
+  #endif
+  #ifdef USE_BACKGROUND_ADC
+    // last, since from here on the muxes belong to the timer interrupt
+    if (!adcScanner.begin(&dualAdcManager, keys, n_keys, pedals, nPedals, ADC_FRAME_TICK_US, 250)) {
+      Serial.println("could not start background adc");
+    }
+  #endif
 }
 
 // can do setup on the other core too
@@ -336,18 +588,23 @@ void toggleCalibration () {
   for (int i = 0; i < n_keys; i++) {
     keys[i].toggleCalibration();
   }
+  // calibrating keys are stepped by keys[], and new thresholds need to be picked up afterwards
+  keyScan.loadParams();
 }
 
-// function for saving key parameters to SD card
-void saveKeyParams () {
+// write the current key parameters to the SD card
+bool writeKeyParams () {
   // first, update the key parameters in the ParamHandler object
   for (int i = 0; i < n_keys; i++) {
-    // read the value from the SD card
     ph.setAdcValKeyDown(i, keys[i].getAdcValKeyDown());
     ph.setAdcValKeyUp(i, keys[i].getAdcValKeyUp());
   }
-  // write key parameters to SD card
-  if (ph.writeParams()) {
+  return ph.writeParams();
+}
+
+// function for saving key parameters to SD card
+void saveKeyParams () {
+  if (writeKeyParams()) {
     Serial.print("\n");
     Serial.println("Key parameters saved to SD card");
     pausePrintStream();
@@ -372,15 +629,28 @@ void changePrintMode (const char *command) {
   
   char *arg = sCmd.next();
   if (arg != NULL) {
+    telemetry.end();
     if (strcmp(arg, "stream") == 0) {
       printInfo = true;
       keyPrintMode = PRINT_NONE;
       Serial.println("stream mode");
       pausePrintStream();
+    } else if (strcmp(arg, "telemetry") == 0) {
+      printInfo = false;
+      keyPrintMode = PRINT_NONE;
+      Serial.println("telemetry mode (binary, decode with telemetry_decode)");
+      startTelemetry();
     } else if (strcmp(arg, "buffers") == 0) {
       printInfo = false;
       keyPrintMode = PRINT_BUFFER;
-      Serial.println("buffer mode");
+      // optionally, the most bytes of buffer dumps printed each scan
+      char *budget = sCmd.next();
+      if ((budget != NULL) && isdigit(budget[0])) {
+        BufferDump::setBudget(atoi(budget));
+      }
+      // note ons while the queue was full weren't dumped
+      Serial.printf("buffer mode (%d bytes per scan), %lu dumps so far, %lu dropped\n", BufferDump::getBudget(),
+                    (unsigned long)BufferDump::getCaptured(), (unsigned long)BufferDump::getDropped());
       pausePrintStream();
     } else if (strcmp(arg, "notes") == 0) {
       printInfo = false;
@@ -393,7 +663,7 @@ void changePrintMode (const char *command) {
       Serial.println("printing disabled");
     } else {
       Serial.print("\n");
-      Serial.print("Second argument must be 'stream', 'buffers', 'notes', or 'none': ");
+      Serial.print("Second argument must be 'stream', 'telemetry', 'buffers', 'notes', or 'none': ");
       Serial.println(arg);
       pausePrintStream();
     }
@@ -415,6 +685,12 @@ void updateKeyPrintModes () {
       keys[i].setPrintMode(PRINT_NONE);
     }
   }
+  // keys dumping their buffers are stepped by keys[] rather than the bank
+  keyScan.loadParams();
+  // the telemetry schema follows the print keys
+  if (telemetry.isStreaming()) {
+    startTelemetry();
+  }
 }
 
 // function to print key settings/calibration results
@@ -498,7 +774,7 @@ void setPrintKey (const char *command) {
 
 }
 
-// key attributes for printing
+// key attributes for printing (in the same order as Telemetry::Attribute)
 enum KeyAttributes {
   RAW_ADC = 0,
   KEY_POSITION,
@@ -569,6 +845,10 @@ void togglePrintAttributes(const char *command) {
         pausePrintStream();
       }
     }
+    // the telemetry schema follows the attributes
+    if (telemetry.isStreaming()) {
+      startTelemetry();
+    }
   } else {
     Serial.print("\n");
     Serial.println("Current attribute states:");
@@ -581,32 +861,76 @@ void togglePrintAttributes(const char *command) {
 
 // print the state of a key (limited to the attributes that are enabled)
 void printKeyState(int i) {
+  int rawADC = keyScan.getRawADC(i);
+  float keyPosition = keyScan.getKeyPosition(i);
+  float keySpeed = keyScan.getKeySpeed(i);
+  float hammerPosition = keyScan.getHammerPosition(i);
+  float hammerSpeed = keyScan.getHammerSpeed(i);
+  int elapsedUS = keyScan.getElapsedUS(i);
   for (int attr = 0; attr < NUM_ATTRIBUTES; attr++) {
     if (attributeStates[attr]) {
       switch (attr) {
         case RAW_ADC:
-          Serial.printf("%s_%d-%d:%d,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getRawADC());
+          Serial.printf("%s_%d-%d:%d,", keyAttributeAbbrev[attr], i, keys[i].pitch, rawADC);
           break;
         case KEY_POSITION:
-          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getKeyPosition());
+          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keyPosition);
           break;
         case KEY_SPEED:
-          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getKeySpeed());
+          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keySpeed);
           break;
         case HAMMER_POSITION:
-          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getHammerPosition());
+          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, hammerPosition);
           break;
         case HAMMER_SPEED:
-          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getHammerSpeed());
+          Serial.printf("%s_%d-%d:%f,", keyAttributeAbbrev[attr], i, keys[i].pitch, hammerSpeed);
           break;
         case ELAPSED:
-          Serial.printf("%s_%d-%d:%d,", keyAttributeAbbrev[attr], i, keys[i].pitch, keys[i].getElapsedUS());
+          Serial.printf("%s_%d-%d:%d,", keyAttributeAbbrev[attr], i, keys[i].pitch, elapsedUS);
           break;
       }
     }
   }
 }
 
+static_assert(NUM_ATTRIBUTES == Telemetry::NUM_ATTRIBUTES, "print attributes must match the telemetry attributes");
+
+// (re)start the telemetry stream, with the print keys and the enabled attributes
+void startTelemetry() {
+  static uint8_t indices[n_keys];
+  static uint8_t pitches[n_keys];
+  int n = 0;
+  for (int i = 0; i < n_keys; i++) {
+    if ((i == printkey) || printAllKeys) {
+      indices[n] = i;
+      pitches[n] = keys[i].pitch;
+      n++;
+    }
+  }
+  uint8_t attributes = 0;
+  for (int attr = 0; attr < NUM_ATTRIBUTES; attr++) {
+    if (attributeStates[attr]) {
+      attributes |= 1 << attr;
+    }
+  }
+  if (!telemetry.begin(indices, pitches, n, attributes, 250)) {
+    Serial.println("telemetry frame too large, select fewer keys or attributes");
+  }
+}
+
+// add the state of the print keys to the telemetry stream
+void recordTelemetryFrame(uint32_t nowUS) {
+  telemetry.beginFrame(nowUS);
+  for (int i = 0; i < n_keys; i++) {
+    if ((i != printkey) && !printAllKeys) {
+      continue;
+    }
+    telemetry.addKey(keyScan.getRawADC(i), keyScan.getKeyPosition(i), keyScan.getKeySpeed(i),
+                     keyScan.getHammerPosition(i), keyScan.getHammerSpeed(i), keyScan.getElapsedUS(i));
+  }
+  telemetry.endFrame();
+}
+
 int printFreqMS = 200; // print frequency in ms
 
 void setPrintFrequency() {
@@ -629,6 +953,180 @@ void setPrintFrequency() {
   
 }
 
+// print (or reset) the time spent in each stage of the scan loop
+void printProfile() {
+  #ifdef USE_PROFILER
+    char *arg = sCmd.next();
+    if ((arg != NULL) && (strcmp(arg, "reset") == 0)) {
+      Profiler::reset();
+      Serial.print("\n");
+      Serial.println("profiler reset");
+    } else {
+      Serial.print("\n");
+      Profiler::print();
+    }
+    #ifdef USE_BACKGROUND_ADC
+      Serial.printf("background adc: %d conversions per frame, %lu frames, %lu dropped\n", adcScanner.getNumSlots(),
+                    (unsigned long)adcScanner.getFrameCount(), (unsigned long)adcScanner.getDroppedFrames());
+    #endif
+  #else
+    Serial.print("\n");
+    Serial.println("profiler not enabled, define USE_PROFILER in config.h");
+  #endif
+  pausePrintStream();
+}
+
+// start or stop recording a binary adc trace
+void setTrace() {
+  char *arg = sCmd.next();
+  Serial.print("\n");
+  if ((arg != NULL) && (strcmp(arg, "start") == 0)) {
+    AdcTrace::Channel channels[n_keys + nPedals];
+    for (int i = 0; i < n_keys; i++) {
+      channels[i] = AdcTrace::Channel{(uint8_t)keys[i].pitch, AdcTrace::KEY, 0};
+    }
+    for (int i = 0; i < nPedals; i++) {
+      channels[n_keys + i] = AdcTrace::Channel{(uint8_t)pedals[i].controlNumber, AdcTrace::PEDAL, 0};
+    }
+    if (traceWriter.begin(traceFile, channels, n_keys + nPedals, 250)) {
+      Serial.printf("recording trace to %s\n", traceFile);
+    } else {
+      Serial.printf("could not create %s\n", traceFile);
+    }
+  } else if ((arg != NULL) && (strcmp(arg, "stop") == 0)) {
+    traceWriter.end();
+    Serial.printf("trace stopped, %lu frames\n", (unsigned long)traceWriter.getFrameCount());
+  } else {
+    Serial.printf("recording = %d, %lu frames (use 'trace start' or 'trace stop')\n", traceWriter.isRecording(), (unsigned long)traceWriter.getFrameCount());
+  }
+  pausePrintStream();
+}
+
+// add the raw adc values of the current scan to the trace
+void recordTraceFrame(uint32_t nowUS) {
+  for (int i = 0; i < n_keys; i++) {
+    traceFrame[i] = abs(keyScan.getRawADC(i));
+  }
+  for (int i = 0; i < nPedals; i++) {
+    traceFrame[n_keys + i] = abs(pedals[i].getRawADC());
+  }
+  traceWriter.writeFrame(nowUS, traceFrame);
+}
+
+// print the conversions and mux changes of the scan plan
+void printScanPlan() {
+  Serial.print("\n");
+  #ifdef USE_SCAN_PLAN
+    scanPlan.printReport();
+  #else
+    Serial.println("scan plan not enabled, define USE_SCAN_PLAN in config.h");
+  #endif
+  pausePrintStream();
+}
+
+// measure the settle time of each mux address change again, and have the scan plan use it
+void measureSettle() {
+  Serial.print("\n");
+  #if defined(USE_SCAN_PLAN) && defined(USE_MUX_SETTLE_TABLE)
+    settleTable.characterise(&dualAdcManager, planPins, sizeof(planPins) / sizeof(planPins[0]));
+    scanPlan.applySettleTable(&settleTable);
+    #ifdef USE_CROSSTALK_COMPENSATION
+      crosstalkTable.apply(&dualAdcManager);
+    #endif
+    settleTable.print();
+    scanPlan.printReport();
+  #else
+    Serial.println("settle table not enabled, define USE_SCAN_PLAN and USE_MUX_SETTLE_TABLE in config.h");
+  #endif
+  pausePrintStream();
+}
+
+// measure the carry-over between mux inputs again, and correct reads with it
+void measureCrosstalk() {
+  Serial.print("\n");
+  #ifdef USE_CROSSTALK_COMPENSATION
+    crosstalkTable.calibrate(&dualAdcManager, planPins, sizeof(planPins) / sizeof(planPins[0]), settle_delay);
+    crosstalkTable.apply(&dualAdcManager);
+    crosstalkTable.print();
+  #else
+    Serial.println("crosstalk compensation not enabled, define USE_CROSSTALK_COMPENSATION in config.h");
+  #endif
+  pausePrintStream();
+}
+
+// print (or reset) the midi queue statistics
+void printMidiQueue() {
+  #ifdef USE_MIDI_QUEUE
+    char *arg = sCmd.next();
+    Serial.print("\n");
+    if (arg == NULL) {
+      MidiQueue::print();
+      Serial.printf("dropped by the sender (usb busy): %lu bytes\n", (unsigned long)midiSender.getDroppedBytes());
+    } else if (strcmp(arg, "reset") == 0) {
+      MidiQueue::reset();
+      Serial.println("midi queue statistics reset");
+    } else {
+      Serial.print("Second argument must be 'reset': ");
+      Serial.println(arg);
+    }
+  #else
+    Serial.print("\n");
+    Serial.println("midi queue not enabled, define USE_MIDI_QUEUE in config.h");
+  #endif
+  pausePrintStream();
+}
+
+#ifdef USE_DRIFT_TRACKING
+// look at one key's resting / bottomed out value, and save moved values now and then
+void trackDrift(uint32_t nowUS) {
+  int moved = driftTracker.step(nowUS, [](int i) {
+    return DriftTracker::KeyState{keyScan.getRawADC(i), keyScan.getKeySpeed(i), keyScan.isNoteOn(i)};
+  });
+  if (moved >= 0) {
+    keyScan.loadParams(moved);
+  }
+  // quietly, since it happens while playing
+  if (driftTracker.saveDue(nowUS)) {
+    writeKeyParams();
+    driftTracker.saved(nowUS);
+  }
+}
+#endif
+
+// print how far the keys' adc values have followed drift
+void printDrift() {
+  Serial.print("\n");
+  #ifdef USE_DRIFT_TRACKING
+    driftTracker.print();
+  #else
+    Serial.println("drift tracking not enabled, define USE_DRIFT_TRACKING in config.h");
+  #endif
+  pausePrintStream();
+}
+
+// print (or reset) the key to midi latency of recent note ons
+void printLatency() {
+  #ifdef USE_LATENCY_TRACKER
+    char *arg = sCmd.next();
+    Serial.print("\n");
+    if (arg == NULL) {
+      LatencyTracker::print();
+    } else if (strcmp(arg, "reset") == 0) {
+      LatencyTracker::reset();
+      Serial.println("latency reset");
+    } else if (isdigit(arg[0])) {
+      LatencyTracker::printKey(atoi(arg));
+    } else {
+      Serial.print("Second argument must be 'reset' or a pitch: ");
+      Serial.println(arg);
+    }
+  #else
+    Serial.print("\n");
+    Serial.println("latency tracking not enabled, define USE_LATENCY_TRACKER in config.h");
+  #endif
+  pausePrintStream();
+}
+
 // function for unrecognized commands
 void unrecognizedCmd (const char *command) {
   Serial.print("\n");
@@ -645,17 +1143,46 @@ void loop() {
     printInfoTriggered = true;
   }
 
-  if (keys[0].elapsedUS >= 250) {
+  uint32_t nowUS = scanClock.sample();
+  #ifdef USE_BACKGROUND_ADC
+    // scan whenever a new frame is complete, at the time the frame was read
+    const AdcFrame* adcFrame = adcScanner.acquireFrame();
+    bool scanDue = (adcFrame != NULL);
+    if (scanDue) {
+      nowUS = adcFrame->startUS;
+      dualAdcManager.setFrame(adcFrame);
+    }
+  #else
+    bool scanDue = (nowUS - lastScanUS >= 250);
+  #endif
+  if (scanDue) {
+    PROF_SCOPE(PROF_SCAN);
+    lastScanUS = nowUS;
+    // every midi message of this scan goes out in one usb transfer, at the end of the scan
+    keyScan.start();
     for (int i = 0; i < n_keys; i++) {
       if (printInfoTriggered & ((i == printkey) || printAllKeys )) {
         printKeyState(i);
         Serial.flush();
       }
-      keys[i].step();
     }
-    for (int i = 0; i < nPedals; i++) {
-      pedals[i].step();
+    keyScan.step(nowUS);
+    #ifdef USE_BACKGROUND_ADC
+      // done with the frame, the next one can be published
+      dualAdcManager.setFrame(NULL);
+      adcScanner.releaseFrame();
+    #endif
+    // hand the midi messages queued during the scan to their senders, and send them
+    keyScan.finish();
+    if (traceWriter.isRecording()) {
+      recordTraceFrame(nowUS);
+    }
+    if (telemetry.isStreaming()) {
+      recordTelemetryFrame(nowUS);
     }
+    #ifdef USE_DRIFT_TRACKING
+      trackDrift(nowUS);
+    #endif
 
     if (printInfoTriggered) {
       Serial.print('\n');
@@ -674,8 +1201,14 @@ void loop() {
     // do any loop end actions, such as reading any new MIDI messages
     midiSender.loopEnd();
   }
-  // check if there are any new commands
-  sCmd.readSerial();
+  // check if there are any new commands, and send what the serial port will take of the telemetry
+  // and buffer dumps
+  {
+    PROF_SCOPE(PROF_SERIAL);
+    sCmd.readSerial();
+    telemetry.drain();
+    BufferDump::drain();
+  }
 }
   
 
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+// maximum number of conversions in one frame (one per key, if no keys share a dual read)
+#define MAX_ADC_SLOTS MAX_SCAN_CHANNELS
+
+/**
+ * @brief One dual ADC conversion: the signal pins read by ADC0 and ADC1, and the mux addresses
+ */
+struct AdcSlot {
+    uint8_t signalPinIndex0;
+    uint8_t signalPinIndex1;
+    int8_t muxAddr0;
+    int8_t muxAddr1;
+
+    bool matches(int pinIndex0, int pinIndex1, int addr0, int addr1) const {
+        return (signalPinIndex0 == pinIndex0) && (signalPinIndex1 == pinIndex1)
+            && (muxAddr0 == addr0) && (muxAddr1 == addr1);
+    }
+};
+
+/**
+ * @brief One pass over every slot, read in the background (see AdcFrameScanner.h)
+ *
+ * values holds the ADC0 and ADC1 results of each slot: values[2 * slot] and values[2 * slot + 1], and
+ * slotUS the time each slot was converted.
+ */
+struct AdcFrame {
+    // time the first conversion started, and the last one was read, in microseconds
+    uint32_t startUS;
+    uint32_t endUS;
+    // number of frames completed before this one
+    uint32_t sequence;
+    uint16_t values[2 * MAX_ADC_SLOTS];
+    uint32_t slotUS[MAX_ADC_SLOTS];
+};
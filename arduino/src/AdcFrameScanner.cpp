@@ -0,0 +1,160 @@
+#include "AdcFrameScanner.h"
+
+AdcFrameScanner* AdcFrameScanner::_active = NULL;
+
+AdcFrameScanner::AdcFrameScanner() {
+    _adc = NULL;
+    _nSlots = 0;
+    _framePeriodUS = 0;
+    _nextFrameUS = 0;
+    _running = false;
+    _writeIndex = 0;
+    _fresh = false;
+    _held = false;
+    _frameCount = 0;
+    _droppedFrames = 0;
+    _slot = 0;
+    _converting = false;
+    _startNext = false;
+    _conversions = 0;
+    _sum0 = 0;
+    _sum1 = 0;
+}
+
+bool AdcFrameScanner::begin(DualAdcManager* adc, KeyHammer* keys, int nKeys, Pedal* pedals, int nPedals,
+                            int tickUS, int framePeriodUS) {
+    end();
+    _adc = adc;
+    // read everything once, in order, to capture the conversions a full scan makes
+    _adc->beginSlotCapture();
+    for (int i = 0; i < nKeys; i++) {
+        keys[i].getAdcFn()();
+    }
+    for (int i = 0; i < nPedals; i++) {
+        pedals[i].getAdcFn()();
+    }
+    _nSlots = _adc->endSlotCapture();
+    if (_nSlots == 0) {
+        return false;
+    }
+    _framePeriodUS = framePeriodUS;
+    _nextFrameUS = micros();
+    _writeIndex = 0;
+    _fresh = false;
+    _held = false;
+    _frameCount = 0;
+    _droppedFrames = 0;
+    _slot = 0;
+    _converting = false;
+    _startNext = false;
+    _active = this;
+    _running = true;
+    if (!_timer.begin(timerISR, tickUS)) {
+        _running = false;
+        _active = NULL;
+        return false;
+    }
+    return true;
+}
+
+void AdcFrameScanner::end() {
+    if (_running) {
+        _timer.end();
+        _running = false;
+        _active = NULL;
+    }
+}
+
+void AdcFrameScanner::timerISR() {
+    if (_active) {
+        _active->tick();
+    }
+}
+
+void AdcFrameScanner::tick() {
+    AdcFrame& frame = _frames[_writeIndex];
+    if (_startNext) {
+        // tick B: the muxes have settled, start converting
+        _adc->startConversion();
+        frame.slotUS[_slot] = _adc->getConversionUS();
+        if (_slot == 0) {
+            frame.startUS = frame.slotUS[0];
+        }
+        _startNext = false;
+        _converting = true;
+        _conversions = 0;
+        _sum0 = 0;
+        _sum1 = 0;
+        return;
+    }
+    // tick A: read the last conversion, then set up the next
+    if (_converting) {
+        int raw0;
+        int raw1;
+        _adc->readRawConversion(raw0, raw1);
+        _sum0 += raw0;
+        _sum1 += raw1;
+        if (++_conversions < _adc->oversampling()) {
+            // oversampling: the next conversion of the same pins, read on the next tick
+            _adc->restartConversion();
+            return;
+        }
+        int value0;
+        int value1;
+        _adc->finishConversion(_sum0, _sum1, value0, value1);
+        frame.values[2 * _slot] = value0;
+        frame.values[2 * _slot + 1] = value1;
+        _converting = false;
+        if (++_slot == _nSlots) {
+            completeFrame(micros());
+            _slot = 0;
+        }
+    }
+    if (_slot == 0 && _framePeriodUS > 0) {
+        uint32_t nowUS = micros();
+        if ((int32_t)(nowUS - _nextFrameUS) < 0) {
+            // wait for the next frame start
+            return;
+        }
+        _nextFrameUS += _framePeriodUS;
+        // don't try to catch up after falling behind
+        if ((int32_t)(nowUS - _nextFrameUS) >= 0) {
+            _nextFrameUS = nowUS + _framePeriodUS;
+        }
+    }
+    _adc->selectSlot(_slot);
+    _startNext = true;
+}
+
+void AdcFrameScanner::completeFrame(uint32_t nowUS) {
+    AdcFrame& frame = _frames[_writeIndex];
+    frame.endUS = nowUS;
+    frame.sequence = _frameCount++;
+    if (_held) {
+        // the simulation is still reading the other frame, so this one is overwritten
+        _droppedFrames++;
+        return;
+    }
+    if (_fresh) {
+        // the last complete frame was never acquired
+        _droppedFrames++;
+    }
+    _writeIndex ^= 1;
+    _fresh = true;
+}
+
+const AdcFrame* AdcFrameScanner::acquireFrame() {
+    const AdcFrame* frame = NULL;
+    noInterrupts();
+    if (_fresh) {
+        _fresh = false;
+        _held = true;
+        frame = &_frames[_writeIndex ^ 1];
+    }
+    interrupts();
+    return frame;
+}
+
+void AdcFrameScanner::releaseFrame() {
+    _held = false;
+}
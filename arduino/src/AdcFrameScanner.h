@@ -0,0 +1,109 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include <Arduino.h>
+#include "AdcFrame.h"
+#include "DualAdcManager.h"
+#include "KeyHammer.h"
+#include "Pedal.h"
+
+/**
+ * @brief Reads every key in the background, from a timer interrupt, into double buffered frames
+ *
+ * DualAdcManager::updateReadings waits for the muxes to settle and for each conversion to finish, so
+ * the cpu sits idle for most of the time spent reading the keys. Instead, an IntervalTimer interrupt
+ * steps through the conversions of a full scan (captured in begin), two ticks per conversion:
+ *   tick A: read the results of the last conversion, then set the muxes for the next one
+ *   tick B: start the next conversion (the muxes have had one tick to settle)
+ * With oversampling (DualAdcManager::setOversampling), tick A instead starts the next conversion of
+ * the same pins until it has read them all, one conversion per tick, so no tick waits on more than
+ * one conversion.
+ * so reading and the simulation overlap. Each complete pass is a frame, timestamped with the time of
+ * its first conversion.
+ *
+ * Frames are double buffered: the interrupt fills one frame while the simulation reads the other.
+ * acquireFrame returns the newest complete frame, which is then kept until releaseFrame. A frame
+ * completed while the simulation still holds the last one is dropped (counted by getDroppedFrames),
+ * which only happens when the simulation is slower than the scan.
+ *
+ * The simulation reads the frame through DualAdcManager::setFrame, so keys' adc functions are
+ * unchanged. While the scanner is running, all reads must go through a frame.
+ *
+ * On the host, IntervalTimer runs on the virtual clock, and the ADC is the mock ADC, so the whole
+ * pipeline runs in host_sim (--background).
+ */
+class AdcFrameScanner {
+public:
+    AdcFrameScanner();
+
+    /**
+     * @brief Capture the conversions of a full scan, and start reading in the background
+     *
+     * Reads every key (and pedal) once, so call after DualAdcManager::begin.
+     *
+     * @param adc The manager the key adc functions read from
+     * @param keys Array of keys, read in order
+     * @param nKeys Number of keys
+     * @param pedals Array of pedals, read after the keys
+     * @param nPedals Number of pedals
+     * @param tickUS Time between interrupts, at least the conversion time (two ticks per conversion)
+     * @param framePeriodUS Time between the starts of frames, or 0 to start each frame as soon as the
+     * last one is complete
+     */
+    bool begin(DualAdcManager* adc, KeyHammer* keys, int nKeys, Pedal* pedals = NULL, int nPedals = 0,
+               int tickUS = ADC_FRAME_TICK_US, int framePeriodUS = 0);
+
+    // stop the timer (the frame being read is discarded)
+    void end();
+
+    /**
+     * @brief Get the newest complete frame, if there is one that hasn't been acquired yet
+     *
+     * @return The frame, held until releaseFrame, or NULL if there is no new frame
+     */
+    const AdcFrame* acquireFrame();
+    void releaseFrame();
+
+    bool isRunning() const { return _running; }
+    int getNumSlots() const { return _nSlots; }
+    uint32_t getFrameCount() const { return _frameCount; }
+    uint32_t getDroppedFrames() const { return _droppedFrames; }
+
+    // the interrupt handler, one step of reading a frame
+    void tick();
+
+private:
+    DualAdcManager* _adc;
+    IntervalTimer _timer;
+    int _nSlots;
+    uint32_t _framePeriodUS;
+    // when the next frame may start, if _framePeriodUS is set
+    uint32_t _nextFrameUS;
+    volatile bool _running;
+
+    AdcFrame _frames[2];
+    // frame being filled by the interrupt, the other is the newest complete frame
+    volatile uint8_t _writeIndex;
+    // a complete frame that hasn't been acquired
+    volatile bool _fresh;
+    // the simulation holds the complete frame
+    volatile bool _held;
+    volatile uint32_t _frameCount;
+    volatile uint32_t _droppedFrames;
+
+    // conversion in progress, and whether the next tick starts it (true) or reads it (false)
+    int _slot;
+    bool _converting;
+    bool _startNext;
+    // conversions of the slot read so far, and the sums of their results (with oversampling)
+    int _conversions;
+    int _sum0;
+    int _sum1;
+
+    // the scanner the timer interrupt steps (IntervalTimer takes a plain function)
+    static AdcFrameScanner* _active;
+    static void timerISR();
+
+    void completeFrame(uint32_t nowUS);
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Binary ADC trace format (version 1)
+ *
+ * A trace holds the raw ADC value of every channel (key or pedal) for every scan, so that a
+ * recording of real playing can be replayed through the simulation on the host and give exactly the
+ * same midi output as the firmware did (see host/AdcTraceReader.h, and host_sim --replay).
+ *
+ * Layout, all little endian, with every part a multiple of 4 bytes so the file can be memory mapped
+ * and frames accessed in place:
+ *   Header
+ *   Channel[nChannels]
+ *   frames, each frameSize bytes: uint32_t timeUS, uint16_t values[nChannels], padding
+ * The number of frames is not stored, it is (file size - headerSize) / frameSize, so a trace that
+ * was cut short (e.g. power lost while recording) is still readable up to its last complete frame.
+ */
+namespace AdcTrace {
+    const char MAGIC[4] = {'P', 'T', 'R', 'C'};
+    const uint16_t VERSION = 1;
+
+    enum ChannelKind : uint8_t {
+        KEY = 0,
+        PEDAL = 1
+    };
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        // bytes before the first frame (Header and channel table)
+        uint16_t headerSize;
+        uint16_t nChannels;
+        uint16_t frameSize;
+        // nominal time between scans (the actual time of each scan is in its frame)
+        uint32_t scanPeriodUS;
+    };
+
+    struct Channel {
+        // midi pitch of the key, or control number of the pedal
+        uint8_t pitch;
+        uint8_t kind;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 16, "AdcTrace::Header must be packed");
+    static_assert(sizeof(Channel) == 4, "AdcTrace::Channel must be packed");
+
+    constexpr uint16_t headerSize(int nChannels) {
+        return sizeof(Header) + nChannels * sizeof(Channel);
+    }
+
+    constexpr uint16_t frameSize(int nChannels) {
+        return (sizeof(uint32_t) + nChannels * sizeof(uint16_t) + 3) & ~3;
+    }
+}
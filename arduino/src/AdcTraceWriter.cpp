@@ -0,0 +1,77 @@
+#include "AdcTraceWriter.h"
+#include <Arduino.h>
+#include <string.h>
+
+AdcTraceWriter::AdcTraceWriter() {
+    _recording = false;
+    _nChannels = 0;
+    _frameSize = 0;
+    _frameCount = 0;
+    _bufferUsed = 0;
+}
+
+bool AdcTraceWriter::begin(const char* path, const AdcTrace::Channel* channels, int nChannels, uint32_t scanPeriodUS) {
+    if (_recording) {
+        end();
+    }
+    if (AdcTrace::frameSize(nChannels) > BUFFER_SIZE_BYTES) {
+        return false;
+    }
+    // the SD card is initialised by ParamHandler
+    if (SD.exists(path)) {
+        SD.remove(path);
+    }
+    _file = SD.open(path, FILE_WRITE);
+    if (!_file) {
+        return false;
+    }
+    _nChannels = nChannels;
+    _frameSize = AdcTrace::frameSize(nChannels);
+    _frameCount = 0;
+    _bufferUsed = 0;
+
+    AdcTrace::Header header;
+    memcpy(header.magic, AdcTrace::MAGIC, sizeof(header.magic));
+    header.version = AdcTrace::VERSION;
+    header.headerSize = AdcTrace::headerSize(nChannels);
+    header.nChannels = nChannels;
+    header.frameSize = _frameSize;
+    header.scanPeriodUS = scanPeriodUS;
+    _file.write((const uint8_t*)&header, sizeof(header));
+    _file.write((const uint8_t*)channels, nChannels * sizeof(AdcTrace::Channel));
+    _recording = true;
+    return true;
+}
+
+void AdcTraceWriter::writeFrame(uint32_t timeUS, const uint16_t* values) {
+    if (!_recording) {
+        return;
+    }
+    if (_bufferUsed + _frameSize > BUFFER_SIZE_BYTES) {
+        flush();
+    }
+    uint8_t* frame = _buffer + _bufferUsed;
+    memcpy(frame, &timeUS, sizeof(timeUS));
+    memcpy(frame + sizeof(timeUS), values, _nChannels * sizeof(uint16_t));
+    // zero the padding, so traces of the same data are identical
+    int used = sizeof(timeUS) + _nChannels * sizeof(uint16_t);
+    memset(frame + used, 0, _frameSize - used);
+    _bufferUsed += _frameSize;
+    _frameCount++;
+}
+
+void AdcTraceWriter::end() {
+    if (!_recording) {
+        return;
+    }
+    flush();
+    _file.close();
+    _recording = false;
+}
+
+void AdcTraceWriter::flush() {
+    if (_bufferUsed > 0) {
+        _file.write(_buffer, _bufferUsed);
+        _bufferUsed = 0;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "config.h"
+#include <SD.h>
+#include "AdcTrace.h"
+
+/**
+ * @brief Records raw ADC values for every scan to a binary trace file on the SD card
+ *
+ * See AdcTrace.h for the format. Frames are collected in a RAM buffer and written to the card a
+ * block at a time, so most scans only pay for a copy, but the scans that write a block take longer.
+ *
+ * Usage:
+ *   writer.begin("/trace.bin", channels, nChannels, 250);
+ *   // each scan
+ *   writer.writeFrame(nowUS, values);
+ *   // when done
+ *   writer.end();
+ */
+class AdcTraceWriter {
+public:
+    AdcTraceWriter();
+
+    /**
+     * @brief Create (or replace) a trace file and write its header
+     *
+     * @param channels One entry per value in each frame
+     * @return false if the SD card or file can't be opened
+     */
+    bool begin(const char* path, const AdcTrace::Channel* channels, int nChannels, uint32_t scanPeriodUS);
+
+    /**
+     * @brief Add a frame, with one raw ADC value per channel
+     */
+    void writeFrame(uint32_t timeUS, const uint16_t* values);
+
+    /**
+     * @brief Write any buffered frames and close the file
+     */
+    void end();
+
+    bool isRecording() const { return _recording; }
+    uint32_t getFrameCount() const { return _frameCount; }
+
+private:
+    // a multiple of the SD card's 512 byte blocks
+    static const int BUFFER_SIZE_BYTES = 4096;
+
+    File _file;
+    bool _recording;
+    int _nChannels;
+    int _frameSize;
+    uint32_t _frameCount;
+    uint8_t _buffer[BUFFER_SIZE_BYTES];
+    int _bufferUsed;
+
+    void flush();
+};
@@ -0,0 +1,103 @@
+#include "BufferDump.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+namespace {
+    BufferDump::Snapshot snapshots[BufferDump::QUEUE];
+    // free running indices, masked by QUEUE: snapshots from tail to head are waiting to be printed
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t captured = 0;
+    uint32_t dropped = 0;
+
+    int budget = BUFFER_DUMP_BYTES_PER_SCAN;
+    int budgetLeft = BUFFER_DUMP_BYTES_PER_SCAN;
+
+    // row of the tail snapshot being printed, and what's left of it to write
+    int row = 0;
+    char line[192];
+    int lineLength = 0;
+    int linePos = 0;
+
+    // format the next row of the tail snapshot into line, false if there are no more rows
+    bool nextLine() {
+        while (tail != head) {
+            const BufferDump::Snapshot& s = snapshots[tail % BufferDump::QUEUE];
+            if (row < s.n) {
+                lineLength = snprintf(line, sizeof(line),
+                                      "pitch:%d,noteCount:%d,noteOnHammerSpeed:%f,noteOnVelocity:%d,rawADC:%d,"
+                                      "hammerPosition:%f,elapsedUs:%d,iteration:%d,\n",
+                                      s.pitch, s.noteCount, s.noteOnHammerSpeed, s.noteOnVelocity, s.rawADC[row],
+                                      s.hammerPosition[row], s.elapsedUS[row], s.iteration[row]);
+                lineLength = min(lineLength, (int)sizeof(line) - 1);
+                linePos = 0;
+                row++;
+                return true;
+            }
+            // done with this snapshot
+            tail++;
+            row = 0;
+        }
+        return false;
+    }
+}
+
+namespace BufferDump {
+
+Snapshot* acquire() {
+    if (head - tail >= (uint32_t)QUEUE) {
+        dropped++;
+        return NULL;
+    }
+    return &snapshots[head % QUEUE];
+}
+
+void commit() {
+    head++;
+    captured++;
+}
+
+void startScan() {
+    budgetLeft = budget;
+}
+
+int drain() {
+    int written = 0;
+    while (budgetLeft > 0) {
+        if ((linePos == lineLength) && !nextLine()) {
+            break;
+        }
+        int n = min(min(lineLength - linePos, budgetLeft), Serial.availableForWrite());
+        if (n <= 0) {
+            break;
+        }
+        Serial.write((const uint8_t*)line + linePos, n);
+        linePos += n;
+        budgetLeft -= n;
+        written += n;
+    }
+    return written;
+}
+
+void setBudget(int bytesPerScan) {
+    budget = max(bytesPerScan, 1);
+    budgetLeft = min(budgetLeft, budget);
+}
+
+int getBudget() {
+    return budget;
+}
+
+int depth() {
+    return head - tail;
+}
+
+uint32_t getCaptured() {
+    return captured;
+}
+
+uint32_t getDropped() {
+    return dropped;
+}
+
+}
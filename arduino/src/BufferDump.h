@@ -0,0 +1,52 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+/**
+ * @brief Queue of key buffer snapshots, printed over serial a little at a time between scans
+ *
+ * In PRINT_BUFFER mode, a key's sample buffers are printed shortly after each of its note ons, one
+ * row per sample (BUFFER_SIZE rows of "pitch:..,noteCount:..,..,iteration:.."). Printing them straight
+ * away takes tens of milliseconds, which stalls every other key. Instead the key copies its buffers
+ * into a free snapshot (see KeyHammer::dumpBuffers) and carries on, and drain prints the queued
+ * snapshots a row at a time, writing at most the budget set with setBudget (BUFFER_DUMP_BYTES_PER_SCAN
+ * by default) each scan, and only what the serial port takes without blocking.
+ *
+ * The queue holds BUFFER_DUMP_QUEUE snapshots: a note on while all are waiting to be printed isn't
+ * captured, and is counted by getDropped. Snapshots are written and printed on the same core.
+ */
+namespace BufferDump {
+    const int QUEUE = BUFFER_DUMP_QUEUE;
+
+    struct Snapshot {
+        int pitch;
+        int noteCount;
+        float noteOnHammerSpeed;
+        int noteOnVelocity;
+        // number of rows
+        int n;
+        int rawADC[BUFFER_SIZE];
+        float hammerPosition[BUFFER_SIZE];
+        int elapsedUS[BUFFER_SIZE];
+        int iteration[BUFFER_SIZE];
+    };
+
+    // a free snapshot to fill, then commit, or NULL (and counted as dropped) if the queue is full
+    Snapshot* acquire();
+    void commit();
+
+    // start of a scan: the byte budget is available again
+    void startScan();
+    // print queued rows, within the budget for this scan, without blocking, returns bytes written
+    int drain();
+
+    // bytes printed per scan at most
+    void setBudget(int bytesPerScan);
+    int getBudget();
+
+    // snapshots waiting (including the one being printed)
+    int depth();
+    uint32_t getCaptured();
+    uint32_t getDropped();
+}
@@ -0,0 +1,88 @@
+#include "CrosstalkTable.h"
+#include <Arduino.h>
+
+CrosstalkTable::CrosstalkTable() {
+    _nPins = 0;
+    _nMeasured = 0;
+    _settleDelayUS = 0;
+}
+
+void CrosstalkTable::calibrate(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins, int settleDelayUS) {
+    nPins = min(nPins, MAX_SIGNAL_PINS);
+    _nPins = 0;
+    _nMeasured = 0;
+    _settleDelayUS = settleDelayUS;
+    // measure the raw values
+    adc->clearCrosstalk();
+    for (int p = 0; p < nPins; p++) {
+        _bus[p] = pins[p].bus;
+        // fully settled value of each input
+        int settled[nAddresses];
+        for (int addr = 0; addr < nAddresses; addr++) {
+            settled[addr] = 0;
+            for (int r = 0; r < CROSSTALK_REPEATS; r++) {
+                settled[addr] += ScanPlan::readPin(adc, pins, nPins, p, addr, MUX_SETTLE_MAX_US);
+            }
+            settled[addr] /= CROSSTALK_REPEATS;
+        }
+        bool measured[nAddresses];
+        int32_t sum = 0;
+        int nPinMeasured = 0;
+        for (int addr = 0; addr < nAddresses; addr++) {
+            // least squares fit of (settled - value) = c * (value - last)
+            float sxy = 0;
+            float sxx = 0;
+            for (int from = 0; from < nAddresses; from++) {
+                if ((from == addr) || (abs(settled[from] - settled[addr]) < CROSSTALK_MIN_STEP)) {
+                    continue;
+                }
+                for (int r = 0; r < CROSSTALK_REPEATS; r++) {
+                    int last = ScanPlan::readPin(adc, pins, nPins, p, from, MUX_SETTLE_MAX_US);
+                    int value = ScanPlan::readPin(adc, pins, nPins, p, addr, settleDelayUS);
+                    float x = value - last;
+                    sxy += (settled[addr] - value) * x;
+                    sxx += x * x;
+                }
+            }
+            measured[addr] = sxx > 0;
+            if (measured[addr]) {
+                float coeff = constrain(sxy / sxx, 0.0f, 7.0f);
+                _coeffs[p][addr] = (int16_t)(coeff * (1 << DualAdcManager::CROSSTALK_Q) + 0.5f);
+                sum += _coeffs[p][addr];
+                nPinMeasured++;
+                _nMeasured++;
+            }
+        }
+        // inputs that read much the same as all the others get the mean of their mux
+        for (int addr = 0; addr < nAddresses; addr++) {
+            if (!measured[addr]) {
+                _coeffs[p][addr] = (nPinMeasured > 0) ? sum / nPinMeasured : 0;
+            }
+        }
+    }
+    _nPins = nPins;
+    // the muxes have been moved, so nothing cached is valid
+    adc->invalidate();
+}
+
+void CrosstalkTable::apply(DualAdcManager* adc) {
+    for (int p = 0; p < _nPins; p++) {
+        adc->setCrosstalk(p, _bus[p], _coeffs[p]);
+    }
+}
+
+void CrosstalkTable::print() {
+    if (!isCalibrated()) {
+        Serial.println("crosstalk not calibrated");
+        return;
+    }
+    Serial.printf("-- CROSSTALK (k / (1 - k) by mux address, settle delay %dus) --\n", _settleDelayUS);
+    for (int p = 0; p < _nPins; p++) {
+        Serial.printf("signal pin %2d:", p);
+        for (int addr = 0; addr < nAddresses; addr++) {
+            Serial.printf(" %.3f", getCoefficient(p, addr));
+        }
+        Serial.printf("\n");
+    }
+    Serial.printf("measured inputs: %d of %d\n", _nMeasured, _nPins * nAddresses);
+}
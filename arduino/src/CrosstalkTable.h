@@ -0,0 +1,60 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "DualAdcManager.h"
+#include "ScanPlan.h"
+
+/**
+ * @brief Carry-over from the last mux input read on a pin, measured per mux input
+ *
+ * With a short settle delay, a read of a mux input still holds part of the voltage of the input the
+ * mux was last on: value = (1 - k) * settled + k * last. calibrate measures k for each input of each
+ * signal pin's mux: the mux is fully settled at another input, moved to this one, and read after the
+ * settle delay the scan uses, then read again once fully settled. The coefficient k / (1 - k) is a
+ * least squares fit over every other input (and CROSSTALK_REPEATS tries) whose settled value is at
+ * least CROSSTALK_MIN_STEP away, so it can be measured. Inputs with no such neighbour get the mean of
+ * their mux.
+ *
+ * apply hands the coefficients to DualAdcManager::setCrosstalk, which corrects every value as it is
+ * converted, so the scan can run with little or no settle delay.
+ *
+ * Takes a few hundred milliseconds for a full board, with the muxes and ADCs to itself (so not while
+ * the background scanner is running). Keys should be at rest.
+ */
+class CrosstalkTable {
+public:
+    CrosstalkTable();
+
+    /**
+     * @brief Measure the carry-over of every input of every signal pin's mux
+     *
+     * @param pins Bus and ADCs of each signal pin, by signal pin index (as passed to ScanPlan::build)
+     * @param nPins Number of signal pins
+     * @param settleDelayUS Settle delay the keys are read with
+     */
+    void calibrate(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins, int settleDelayUS);
+
+    // correct reads from now on (see DualAdcManager::setCrosstalk)
+    void apply(DualAdcManager* adc);
+
+    bool isCalibrated() const { return _nPins > 0; }
+    // carry-over coefficient k / (1 - k) of a mux input
+    float getCoefficient(int pin, int muxAddr) const {
+        return (float)_coeffs[pin][muxAddr] / (1 << DualAdcManager::CROSSTALK_Q);
+    }
+    // inputs measured (the rest were filled in)
+    int getNumMeasured() const { return _nMeasured; }
+
+    // print the coefficient of each input, one row per signal pin
+    void print();
+
+private:
+    static const int nAddresses = 1 << N_ADDRESS_PINS;
+
+    int16_t _coeffs[MAX_SIGNAL_PINS][nAddresses];
+    uint8_t _bus[MAX_SIGNAL_PINS];
+    int _nPins;
+    int _nMeasured;
+    int _settleDelayUS;
+};
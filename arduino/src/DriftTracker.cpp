@@ -0,0 +1,109 @@
+#include "DriftTracker.h"
+#include <Arduino.h>
+#include <math.h>
+
+DriftTracker::DriftTracker() {
+    _keys = NULL;
+    _nKeys = 0;
+    _next = 0;
+    _moves = 0;
+    _unsaved = false;
+    _savedUS = 0;
+    _activeUS = 0;
+}
+
+void DriftTracker::begin(KeyHammer* keys, int nKeys) {
+    _keys = keys;
+    _nKeys = min(nKeys, MAX_BANK_KEYS);
+    _next = 0;
+    for (int i = 0; i < _nKeys; i++) {
+        _up[i] = _upStart[i] = _keys[i].getAdcValKeyUp();
+        _down[i] = _downStart[i] = _keys[i].getAdcValKeyDown();
+        _upAverage[i] = _up[i];
+        _downAverage[i] = _down[i];
+        _movedUS[i] = 0;
+    }
+    _moves = 0;
+    _unsaved = false;
+}
+
+bool DriftTracker::update(int i, uint32_t nowUS, const KeyState& s) {
+    KeyHammer& key = _keys[i];
+    if (!key.isEnabled() || key.isCalibrating()) {
+        _activeUS = nowUS;
+        return false;
+    }
+    // changed elsewhere (e.g. calibration), start again from the new values
+    if (key.getAdcValKeyUp() != _up[i]) {
+        _up[i] = _upStart[i] = key.getAdcValKeyUp();
+        _upAverage[i] = _up[i];
+    }
+    if (key.getAdcValKeyDown() != _down[i]) {
+        _down[i] = _downStart[i] = key.getAdcValKeyDown();
+        _downAverage[i] = _down[i];
+    }
+
+    // values are signed so that adcValKeyDown > adcValKeyUp (see KeyHammer::updateADCParams)
+    float window = max((_down[i] - _up[i]) * (float)DRIFT_WINDOW_FRACTION, (float)key.getRestBand());
+    bool still = fabsf(s.keySpeed) <= DRIFT_MAX_SPEED;
+    if (still && !s.noteOn && (abs(s.rawADC - _up[i]) <= window)) {
+        _upAverage[i] += DRIFT_EWMA_ALPHA * (s.rawADC - _upAverage[i]);
+        int bits = stepTowards(i, _up[i], _upAverage[i], nowUS);
+        if (bits != 0) {
+            key.setAdcValKeyUp(_up[i] + bits);
+            _up[i] = key.getAdcValKeyUp();
+            return true;
+        }
+        return false;
+    }
+    _activeUS = nowUS;
+    if (still && s.noteOn && (abs(s.rawADC - _down[i]) <= window)) {
+        _downAverage[i] += DRIFT_EWMA_ALPHA * (s.rawADC - _downAverage[i]);
+        int bits = stepTowards(i, _down[i], _downAverage[i], nowUS);
+        if (bits != 0) {
+            key.setAdcValKeyDown(_down[i] + bits);
+            _down[i] = key.getAdcValKeyDown();
+            return true;
+        }
+    }
+    return false;
+}
+
+int DriftTracker::stepTowards(int i, int value, float average, uint32_t nowUS) {
+    if (nowUS - _movedUS[i] < DRIFT_STEP_MS * 1000UL) {
+        return 0;
+    }
+    float error = average - value;
+    if (fabsf(error) < 1) {
+        return 0;
+    }
+    // a fraction of the way, so faster drift is followed faster, but at least one bit
+    int bits = (int)(error * DRIFT_STEP_FRACTION);
+    if (bits == 0) {
+        bits = (error > 0) ? 1 : -1;
+    }
+    _movedUS[i] = nowUS;
+    _moves += abs(bits);
+    _unsaved = true;
+    return bits;
+}
+
+bool DriftTracker::saveDue(uint32_t nowUS) const {
+    return _unsaved && (nowUS - _savedUS >= DRIFT_SAVE_INTERVAL_S * 1000000UL)
+           && (nowUS - _activeUS >= DRIFT_SAVE_QUIET_MS * 1000UL);
+}
+
+void DriftTracker::saved(uint32_t nowUS) {
+    _unsaved = false;
+    _savedUS = nowUS;
+}
+
+void DriftTracker::print() {
+    Serial.printf("drift: %lu bits moved, %s\n", (unsigned long)_moves, _unsaved ? "not saved yet" : "saved");
+    for (int i = 0; i < _nKeys; i++) {
+        if (getUpDrift(i) != 0 || getDownDrift(i) != 0) {
+            Serial.printf("key %d (pitch %d): adcValKeyUp %d (%+d), adcValKeyDown %d (%+d)\n", i, _keys[i].pitch,
+                          _up[i], getUpDrift(i), _down[i], getDownDrift(i));
+        }
+    }
+}
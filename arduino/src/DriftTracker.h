@@ -0,0 +1,108 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "KeyHammer.h"
+
+/**
+ * @brief Follows slow drift in each key's resting (adcValKeyUp) and bottomed out (adcValKeyDown) adc
+ * values, e.g. hall sensors warming up over a long evening, without stopping for calibration
+ *
+ * One key is looked at per scan, in turn. A key with no note sounding, moving slower than
+ * DRIFT_MAX_SPEED, and within DRIFT_WINDOW_FRACTION of its travel of adcValKeyUp, is resting: its
+ * raw value goes into a running average (an exponentially weighted moving average, weight
+ * DRIFT_EWMA_ALPHA) of where the key rests. Likewise for a key held down with a note sounding, near
+ * adcValKeyDown. Once an average is a whole adc bit away from the key's value, the value is moved
+ * DRIFT_STEP_FRACTION of the way towards it (at least one bit), at most once per DRIFT_STEP_MS per key:
+ * faster drift is followed in bigger steps, while a bad sample or two, only nudging the average, can't
+ * move the thresholds far. Values lag drift by about its rate times the average's time constant (the
+ * scans taken to look at every key, over DRIFT_EWMA_ALPHA). Moving a value recalculates that key's thresholds (KeyHammer::updateADCParams);
+ * step returns the key so that a KeyBank can pick them up too (KeyBank::loadParams).
+ *
+ * Values changed elsewhere (calibration, the sd card) are taken as the new starting point. Keys that
+ * are calibrating or disabled are left alone.
+ *
+ * Moved values should be saved (ParamHandler), but writing to the sd card stalls the scan, so
+ * saveDue is only true once every DRIFT_SAVE_INTERVAL_S at most, and after DRIFT_SAVE_QUIET_MS of
+ * every key resting.
+ */
+class DriftTracker {
+public:
+    // what the tracker needs of a key, from whichever of KeyBank / KeyHammer steps it
+    struct KeyState {
+        int rawADC;
+        float keySpeed;
+        bool noteOn;
+    };
+
+    DriftTracker();
+
+    /**
+     * @brief Start tracking an array of keys, from their current adc values
+     *
+     * @param keys Array of KeyHammer objects, whose adc values are moved
+     * @param nKeys Number of keys (at most MAX_BANK_KEYS)
+     */
+    void begin(KeyHammer* keys, int nKeys);
+
+    /**
+     * @brief Look at the next key, once per scan
+     *
+     * @param nowUS Time of the current scan (see ScanClock.h)
+     * @param state Function taking a key index, returning its KeyState, e.g. from KeyBank or KeyHammer
+     * @return Index of the key whose adc values were moved, or -1 if none were
+     */
+    template <class StateFn>
+    int step(uint32_t nowUS, StateFn state);
+
+    // moved values are waiting to be saved, and it's a good time to save them
+    bool saveDue(uint32_t nowUS) const;
+    // values were saved (or the save was given up on)
+    void saved(uint32_t nowUS);
+
+    // adc bits moved since begin, over all keys
+    uint32_t getMoves() const { return _moves; }
+    // how far a key's values have moved since begin (or since they were last changed elsewhere)
+    int getUpDrift(int i) const { return _up[i] - _upStart[i]; }
+    int getDownDrift(int i) const { return _down[i] - _downStart[i]; }
+
+    // print the keys whose values have moved, and whether a save is waiting
+    void print();
+
+private:
+    KeyHammer* _keys;
+    int _nKeys;
+    // key looked at on the next step
+    int _next;
+
+    // values as last seen or set, and where they started
+    int _up[MAX_BANK_KEYS];
+    int _down[MAX_BANK_KEYS];
+    int _upStart[MAX_BANK_KEYS];
+    int _downStart[MAX_BANK_KEYS];
+    // running averages of the resting / bottomed out raw values
+    float _upAverage[MAX_BANK_KEYS];
+    float _downAverage[MAX_BANK_KEYS];
+    // time each key's values were last moved
+    uint32_t _movedUS[MAX_BANK_KEYS];
+
+    uint32_t _moves;
+    bool _unsaved;
+    uint32_t _savedUS;
+    // time a key was last seen neither resting nor calibrated away
+    uint32_t _activeUS;
+
+    bool update(int i, uint32_t nowUS, const KeyState& s);
+    // bits to move a value towards its average, if the key is due a move
+    int stepTowards(int i, int value, float average, uint32_t nowUS);
+};
+
+template <class StateFn>
+int DriftTracker::step(uint32_t nowUS, StateFn state) {
+    if (_nKeys == 0) {
+        return -1;
+    }
+    int i = _next;
+    _next = (_next + 1) % _nKeys;
+    return update(i, nowUS, state(i)) ? i : -1;
+}
@@ -4,6 +4,10 @@
 // Constructor
 DualAdcManager::DualAdcManager() {
     _adcNeedsUpdate = true;
+    clearCrosstalk();
+    for (int p = 0; p < MAX_SIGNAL_PINS; p++) {
+        _oversampling[p] = ADC_OVERSAMPLING;
+    }
     
     #ifdef TEENSY
     _adc = NULL;
@@ -31,6 +35,37 @@ void DualAdcManager::begin(int addressPins0[], int addressPins1[],
         digitalWrite(_addressPins0[i], LOW);
         digitalWrite(_addressPins1[i], LOW);
     }
+    // all low is address 0, which address changes are written relative to
+    _currentMuxAddr0 = 0;
+    _currentMuxAddr1 = 0;
+
+    #if defined(TEENSY) && !defined(HOST_BUILD)
+    // group each bank's address pins by port (on teensy 4.1 the left bank, 35-37, is on one port)
+    for (int bank = 0; bank < 2; bank++) {
+        const int* pins = (bank == 0) ? _addressPins0 : _addressPins1;
+        _nMuxPorts[bank] = 0;
+        for (int i = 0; i < N_ADDRESS_PINS; i++) {
+            volatile uint32_t* toggle = portToggleRegister(pins[i]);
+            int p = 0;
+            while ((p < _nMuxPorts[bank]) && (_muxPorts[bank][p].toggle != toggle)) {
+                p++;
+            }
+            MuxPort& port = _muxPorts[bank][p];
+            if (p == _nMuxPorts[bank]) {
+                port.toggle = toggle;
+                for (int addr = 0; addr < (1 << N_ADDRESS_PINS); addr++) {
+                    port.bits[addr] = 0;
+                }
+                _nMuxPorts[bank]++;
+            }
+            for (int addr = 0; addr < (1 << N_ADDRESS_PINS); addr++) {
+                if (MUX_ADDRESSES[addr][i]) {
+                    port.bits[addr] |= digitalPinToBitMask(pins[i]);
+                }
+            }
+        }
+    }
+    #endif
     
     // Configure signal pins as inputs
     for(uint8_t i = 0; i < numSignalPins; i++) {
@@ -45,6 +80,7 @@ void DualAdcManager::begin(int addressPins0[], int addressPins1[],
     // default is averaging 4 samples, which takes 16-17us (with other settings default)
     // takes around 7us for 1 sample
     // analogReadAveraging(1);
+    // instead, setOversampling averages back to back fast conversions where less noise is needed
     _adc->adc0->setAveraging(1);
     _adc->adc1->setAveraging(1);
       // it can be any of the ADC_CONVERSION_SPEED enum: VERY_LOW_SPEED, LOW_SPEED,
@@ -64,20 +100,44 @@ void DualAdcManager::begin(int addressPins0[], int addressPins1[],
 
 // Set mux configuration
 void DualAdcManager::setMuxConfig(int muxAddr0, int muxAddr1) {
+    setMuxAddr0(muxAddr0);
+    setMuxAddr1(muxAddr1);
+}
+
+void DualAdcManager::setMuxAddr0(int muxAddr0) {
     if (muxAddr0 != _currentMuxAddr0) {
+        writeMuxAddr(0, _currentMuxAddr0, muxAddr0);
         _currentMuxAddr0 = muxAddr0;
         _adcNeedsUpdate = true; // Mark for update
-        for(uint8_t i = 0; i < N_ADDRESS_PINS; i++) {
-            digitalWrite(_addressPins0[i], MUX_ADDRESSES[muxAddr0][i]);
-        }
     }
+}
+
+void DualAdcManager::setMuxAddr1(int muxAddr1) {
     if (muxAddr1 != _currentMuxAddr1) {
+        writeMuxAddr(1, _currentMuxAddr1, muxAddr1);
         _currentMuxAddr1 = muxAddr1;
         _adcNeedsUpdate = true; // Mark for update
-        for(uint8_t i = 0; i < N_ADDRESS_PINS; i++) {
-            digitalWrite(_addressPins1[i], MUX_ADDRESSES[muxAddr1][i]);
+    }
+}
+
+void DualAdcManager::writeMuxAddr(int bank, int fromAddr, int toAddr) {
+    #if defined(TEENSY) && !defined(HOST_BUILD)
+    // toggle the pins that differ, all of a port's pins changing at once
+    for (int p = 0; p < _nMuxPorts[bank]; p++) {
+        const MuxPort& port = _muxPorts[bank][p];
+        uint32_t bits = port.bits[fromAddr] ^ port.bits[toAddr];
+        if (bits) {
+            *port.toggle = bits;
+        }
+    }
+    #else
+    const int* pins = (bank == 0) ? _addressPins0 : _addressPins1;
+    for(uint8_t i = 0; i < N_ADDRESS_PINS; i++) {
+        if (MUX_ADDRESSES[fromAddr][i] != MUX_ADDRESSES[toAddr][i]) {
+            digitalWrite(pins[i], MUX_ADDRESSES[toAddr][i]);
         }
     }
+    #endif
 }
 
 void DualAdcManager::setAdcPinConfig(int signalPinIndex0, int signalPinIndex1) {
@@ -91,17 +151,38 @@ void DualAdcManager::setAdcPinConfig(int signalPinIndex0, int signalPinIndex1) {
     }
 }
 
+void DualAdcManager::setOversampling(int signalPinIndex, int factor) {
+    _oversampling[signalPinIndex] = constrain(factor, 1, MAX_OVERSAMPLING);
+}
+
 // Perform readings if needed
 void DualAdcManager::updateReadings(int settleDelayUS) {
+    PROF_MUX_GROUP((_currentMuxAddr0 << 4) | _currentMuxAddr1);
+    PROF_SCOPE(PROF_ADC);
     // Wait for mux to settle
     // 1us is enough over 30cm long (26awg) cables and 5v powered 74hc4051, 3v powered 49e sensors
     // 2us needed for 3v powered hc4051
     // 5 or 6us needed for 3v powered 74hc4051 with 60cm long cables
-    delayMicroseconds(settleDelayUS);
+    delayMicroseconds(settleDelayUS + _extraSettleUS);
+    _extraSettleUS = 0;
+    _conversionCount++;
+    _conversionUS = micros();
+    if (_capturingSlots && (_nSlots < MAX_ADC_SLOTS)) {
+        _slots[_nSlots++] = AdcSlot{(uint8_t)_currentSignalPinIndex0, (uint8_t)_currentSignalPinIndex1,
+                                    (int8_t)_currentMuxAddr0, (int8_t)_currentMuxAddr1};
+    }
 
-    ADC::Sync_result result = _adc->analogSynchronizedRead(_signalPins[_currentSignalPinIndex0], _signalPins[_currentSignalPinIndex1]);
-    _lastValue0 = (int)result.result_adc0;
-    _lastValue1 = (int)result.result_adc1;
+    // integrate and dump: sum the oversampled conversions, then divide (rounding) back to one value
+    const int factor = oversampling();
+    int sum0 = 0;
+    int sum1 = 0;
+    for (int n = 0; n < factor; n++) {
+        ADC::Sync_result result = _adc->analogSynchronizedRead(_signalPins[_currentSignalPinIndex0], _signalPins[_currentSignalPinIndex1]);
+        sum0 += (int)result.result_adc0;
+        sum1 += (int)result.result_adc1;
+    }
+    _lastValue0 = correct(_currentSignalPinIndex0, _currentMuxAddr0, _currentMuxAddr1, decimate(sum0, factor));
+    _lastValue1 = correct(_currentSignalPinIndex1, _currentMuxAddr0, _currentMuxAddr1, decimate(sum1, factor));
     // non-synchronized read:
     // _lastValue0 = _adc->adc0->analogRead(_signalPins[_currentSignalPinIndex0]);
     // _lastValue1 = _adc->adc1->analogRead(_signalPins[_currentSignalPinIndex1]);
@@ -116,6 +197,10 @@ int DualAdcManager::readDualGetAdcValue0(
             int muxAddr0,
             int muxAddr1,
             int settleDelayUS) {
+    if (_frame) {
+        readFrame(adcPinIndex0, adcPinIndex1, muxAddr0, muxAddr1);
+        return _lastValue0;
+    }
     setMuxConfig(muxAddr0, muxAddr1);
     setAdcPinConfig(adcPinIndex0, adcPinIndex1);
     if (_adcNeedsUpdate) {
@@ -131,6 +216,10 @@ int DualAdcManager::readDualGetAdcValue1(
             int muxAddr0,
             int muxAddr1,
             int settleDelayUS) {
+    if (_frame) {
+        readFrame(adcPinIndex0, adcPinIndex1, muxAddr0, muxAddr1);
+        return _lastValue1;
+    }
     setMuxConfig(muxAddr0, muxAddr1);
     setAdcPinConfig(adcPinIndex0, adcPinIndex1);
     if (_adcNeedsUpdate) {
@@ -139,6 +228,130 @@ int DualAdcManager::readDualGetAdcValue1(
     return _lastValue1;
 }
 
+void DualAdcManager::beginSlotCapture() {
+    _nSlots = 0;
+    _capturingSlots = true;
+    // the first read must convert, to be captured
+    _adcNeedsUpdate = true;
+}
+
+int DualAdcManager::endSlotCapture() {
+    _capturingSlots = false;
+    return _nSlots;
+}
+
+void DualAdcManager::setFrame(const AdcFrame* frame) {
+    _frame = frame;
+    _frameSlot = -1;
+    // reads after the frame is cleared must convert
+    _adcNeedsUpdate = true;
+}
+
+void DualAdcManager::readFrame(int adcPinIndex0, int adcPinIndex1, int muxAddr0, int muxAddr1) {
+    // the second key of a pair reads the slot the first key just read
+    if ((_frameSlot >= 0) && _slots[_frameSlot].matches(adcPinIndex0, adcPinIndex1, muxAddr0, muxAddr1)) {
+        return;
+    }
+    // keys read the slots in the order they were captured, so this is almost always the next slot
+    for (int n = 0; n < _nSlots; n++) {
+        int slot = (_frameSlot + 1 + n) % _nSlots;
+        if (_slots[slot].matches(adcPinIndex0, adcPinIndex1, muxAddr0, muxAddr1)) {
+            _frameSlot = slot;
+            _lastValue0 = _frame->values[2 * slot];
+            _lastValue1 = _frame->values[2 * slot + 1];
+            _frameConversionUS = _frame->slotUS[slot];
+            return;
+        }
+    }
+    // not captured, so not in the frame
+    _lastValue0 = 0;
+    _lastValue1 = 0;
+}
+
+void DualAdcManager::selectSlot(int slot) {
+    const AdcSlot& s = _slots[slot];
+    setMuxConfig(s.muxAddr0, s.muxAddr1);
+    setAdcPinConfig(s.signalPinIndex0, s.signalPinIndex1);
+}
+
+void DualAdcManager::startConversion() {
+    _conversionUS = micros();
+    _startMuxAddr0 = _currentMuxAddr0;
+    _startMuxAddr1 = _currentMuxAddr1;
+    _adc->startSynchronizedSingleRead(_signalPins[_currentSignalPinIndex0], _signalPins[_currentSignalPinIndex1]);
+}
+
+bool DualAdcManager::isConversionComplete() {
+    return _adc->adc0->isComplete() && _adc->adc1->isComplete();
+}
+
+void DualAdcManager::readConversion(int& value0, int& value1) {
+    const int factor = oversampling();
+    int sum0 = 0;
+    int sum1 = 0;
+    for (int n = 0; n < factor; n++) {
+        // the first conversion was started by startConversion, the rest back to back
+        if (n > 0) {
+            restartConversion();
+        }
+        int raw0;
+        int raw1;
+        readRawConversion(raw0, raw1);
+        sum0 += raw0;
+        sum1 += raw1;
+    }
+    finishConversion(sum0, sum1, value0, value1);
+}
+
+void DualAdcManager::readRawConversion(int& raw0, int& raw1) {
+    while (!isConversionComplete()) {
+    }
+    ADC::Sync_result result = _adc->readSynchronizedSingle();
+    raw0 = (int)result.result_adc0;
+    raw1 = (int)result.result_adc1;
+}
+
+void DualAdcManager::restartConversion() {
+    // the values keep the time and mux addresses of the first conversion
+    _adc->startSynchronizedSingleRead(_signalPins[_currentSignalPinIndex0], _signalPins[_currentSignalPinIndex1]);
+}
+
+void DualAdcManager::finishConversion(int sum0, int sum1, int& value0, int& value1) {
+    const int factor = oversampling();
+    value0 = correct(_currentSignalPinIndex0, _startMuxAddr0, _startMuxAddr1, decimate(sum0, factor));
+    value1 = correct(_currentSignalPinIndex1, _startMuxAddr0, _startMuxAddr1, decimate(sum1, factor));
+    _conversionCount++;
+}
+
+void DualAdcManager::setCrosstalk(int signalPinIndex, int bus, const int16_t* coeffs) {
+    _pinBus[signalPinIndex] = coeffs ? bus : -1;
+    for (int addr = 0; addr < (1 << N_ADDRESS_PINS); addr++) {
+        _crosstalk[signalPinIndex][addr] = coeffs ? coeffs[addr] : 0;
+    }
+    _lastPinValue[signalPinIndex] = 0;
+    _lastPinAddr[signalPinIndex] = -1;
+}
+
+void DualAdcManager::clearCrosstalk() {
+    for (int p = 0; p < MAX_SIGNAL_PINS; p++) {
+        setCrosstalk(p, 0, NULL);
+    }
+}
+
+int DualAdcManager::correct(int signalPinIndex, int muxAddr0, int muxAddr1, int value) {
+    int bus = _pinBus[signalPinIndex];
+    if (bus < 0) {
+        return value;
+    }
+    int addr = (bus == 0) ? muxAddr0 : muxAddr1;
+    if ((addr != _lastPinAddr[signalPinIndex]) && (_lastPinAddr[signalPinIndex] >= 0)) {
+        value += (_crosstalk[signalPinIndex][addr] * (value - _lastPinValue[signalPinIndex])) >> CROSSTALK_Q;
+    }
+    _lastPinAddr[signalPinIndex] = addr;
+    _lastPinValue[signalPinIndex] = value;
+    return value;
+}
+
 // Function to create a reader for a single ADC channel
 // int (*DualAdcManager::createAdcReader(uint8_t adcPinIndex0,
 //             uint8_t adcPinIndex1,
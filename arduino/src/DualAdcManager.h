@@ -2,6 +2,8 @@
 
 #include "config.h"
 #include <elapsedMillis.h>
+#include "Profiler.h"
+#include "AdcFrame.h"
 
 #ifdef TEENSY
 #include "ADC.h"
@@ -76,8 +78,8 @@ private:
     
     int _lastValue0;
     int _lastValue1;
-    int _currentSignalPinIndex0;
-    int _currentSignalPinIndex1;
+    int _currentSignalPinIndex0 = 0;
+    int _currentSignalPinIndex1 = 0;
     
     // Current address configuration
     int _currentMuxAddr0 = -1;
@@ -91,6 +93,55 @@ private:
     
     // duration for which ADC read is valid
     int _validReadDurationUS = 500;
+
+    // extra settle delay for the next conversion, see addSettleDelay
+    int _extraSettleUS = 0;
+    // number of conversions (pairs of simultaneous reads) so far
+    uint32_t _conversionCount = 0;
+    // time the last values were converted (when the ADCs sampled their inputs)
+    uint32_t _conversionUS = 0;
+
+    // conversions in the order keys read them, see beginSlotCapture
+    AdcSlot _slots[MAX_ADC_SLOTS];
+    int _nSlots = 0;
+    bool _capturingSlots = false;
+    // frame that reads come from instead of the ADCs, see setFrame
+    const AdcFrame* _frame = NULL;
+    // slot of the last value taken from the frame, and the time it was converted (kept apart from
+    // _conversionUS, which the background scanner writes while the simulation reads the frame)
+    int _frameSlot = -1;
+    uint32_t _frameConversionUS = 0;
+
+    // carry-over correction (see setCrosstalk): coefficient of each mux input of each pin, and the bus
+    // driving each pin's mux (-1 if the pin isn't corrected)
+    int16_t _crosstalk[MAX_SIGNAL_PINS][1 << N_ADDRESS_PINS];
+    int8_t _pinBus[MAX_SIGNAL_PINS];
+    // last value converted on each pin, and the mux input it was read at
+    int _lastPinValue[MAX_SIGNAL_PINS];
+    int8_t _lastPinAddr[MAX_SIGNAL_PINS];
+    // conversions averaged per read of each pin, see setOversampling
+    uint8_t _oversampling[MAX_SIGNAL_PINS];
+    // one value from the sum of factor conversions, rounded
+    static int decimate(int sum, int factor) { return (sum + factor / 2) / factor; }
+    // mux addresses when the pending conversion started (the other bus may move on while it runs)
+    int _startMuxAddr0 = -1;
+    int _startMuxAddr1 = -1;
+    int correct(int signalPinIndex, int muxAddr0, int muxAddr1, int value);
+
+    void readFrame(int adcPinIndex0, int adcPinIndex1, int muxAddr0, int muxAddr1);
+
+    #if defined(TEENSY) && !defined(HOST_BUILD)
+    // address pins of a bank, grouped by GPIO port, so changing address is one write per port
+    struct MuxPort {
+        volatile uint32_t* toggle;
+        // bits of the port's pins that are high at each address
+        uint32_t bits[1 << N_ADDRESS_PINS];
+    };
+    MuxPort _muxPorts[2][N_ADDRESS_PINS];
+    uint8_t _nMuxPorts[2] = {0, 0};
+    #endif
+    // change the address pins of a bank from one address to another
+    void writeMuxAddr(int bank, int fromAddr, int toAddr);
     
     #ifdef TEENSY
     ADC* _adc;
@@ -118,6 +169,17 @@ public:
      */
     void setMuxConfig(int muxAddr0, int muxAddr1);
 
+    /**
+     * @brief Set the address of one bank of multiplexers, leaving the other alone
+     *
+     * Only the address pins that change are written, with a single write to each GPIO port they
+     * are on, so one bank can be moved on while a conversion reads the other.
+     */
+    void setMuxAddr0(int muxAddr0);
+    void setMuxAddr1(int muxAddr1);
+    int getMuxAddr0() const { return _currentMuxAddr0; }
+    int getMuxAddr1() const { return _currentMuxAddr1; }
+
     /**
      * @brief Choose (by index) the ADC pins to read
      * 
@@ -171,6 +233,107 @@ public:
         int settleDelayUS
     );
 
+    /**
+     * @brief Force the next read to convert, even if the configuration hasn't changed
+     *
+     * Used at the start of each scan, so a value cached from the previous scan is never returned.
+     */
+    void invalidate() { _adcNeedsUpdate = true; }
+
+    /**
+     * @brief Wait an extra settleDelayUS before the next conversion
+     *
+     * Keys are read in an order that sets each mux ahead of time, while the other side is being
+     * read, so no settle delay is needed. When reads are skipped (see ScanScheduler) the mux may only
+     * just have been set, and needs time to settle.
+     */
+    void addSettleDelay(int settleDelayUS) { _extraSettleUS = max(_extraSettleUS, settleDelayUS); }
+
+    uint32_t getConversionCount() const { return _conversionCount; }
+
+    /**
+     * @brief Time, in microseconds, of the conversion the last values came from
+     *
+     * The second key of a pair gets the cached value, and the same time as the first. Values taken
+     * from a frame (see setFrame) have the time their slot was converted.
+     */
+    uint32_t getConversionUS() const { return _frame ? _frameConversionUS : _conversionUS; }
+
+    /**
+     * @brief Record the configuration of each conversion, until endSlotCapture
+     *
+     * Read every key once in order between beginSlotCapture and endSlotCapture, to get the list of
+     * conversions that a full scan makes (used by AdcFrameScanner).
+     */
+    void beginSlotCapture();
+    // returns the number of slots captured
+    int endSlotCapture();
+    int getNumSlots() const { return _nSlots; }
+    const AdcSlot& getSlot(int slot) const { return _slots[slot]; }
+
+    /**
+     * @brief Take reads from a frame read in the background, rather than the ADCs
+     *
+     * While a frame is set, readDualGetAdcValue0/1 return the values of the captured slot with the
+     * same configuration, and never touch the mux address pins (the background scanner owns them).
+     * Pass NULL to read the ADCs again.
+     */
+    void setFrame(const AdcFrame* frame);
+
+    //// conversions without blocking, for the background scanner (see AdcFrameScanner.h) and
+    //// pipelined scans (see ScanPlan::read)
+    // set the muxes and pins for a captured slot
+    void selectSlot(int slot);
+    // start converting the selected pins on both ADCs
+    void startConversion();
+    // whether both ADCs have finished the conversion started by startConversion
+    bool isConversionComplete();
+    // read the results of the conversion started by startConversion, waiting for it to complete
+    void readConversion(int& value0, int& value1);
+    // the same one conversion at a time, for oversampling without waiting (the background scanner):
+    // read one conversion's results, start another of the same pins, and make the values from the
+    // sums of oversampling() conversions
+    void readRawConversion(int& raw0, int& raw1);
+    void restartConversion();
+    void finishConversion(int sum0, int sum1, int& value0, int& value1);
+
+    // fractional bits of crosstalk coefficients
+    static const int CROSSTALK_Q = 12;
+
+    /**
+     * @brief Correct the values read on a signal pin for carry-over from the input its mux was last on
+     *
+     * Reading a mux input before the mux has settled leaves part of the last input's voltage on the
+     * pin: value = (1 - k) * settled + k * last. With coeffs[addr] = k / (1 - k) for the input at each
+     * address (in CROSSTALK_Q fixed point, measured by CrosstalkTable), each conversion that reads the
+     * pin at a new address adds back coeffs[addr] * (value - last), one multiply-add per value.
+     *
+     * @param bus Which address pins drive the pin's mux (0: addressPins0, 1: addressPins1)
+     * @param coeffs One per mux address, or NULL to stop correcting the pin
+     */
+    void setCrosstalk(int signalPinIndex, int bus, const int16_t* coeffs);
+    // stop correcting every pin
+    void clearCrosstalk();
+
+    /**
+     * @brief Average several conversions into each value read from a signal pin's muxes
+     *
+     * Hardware averaging is slow (see begin), so instead each read converts factor times back to back
+     * with the fast settings, and the values are summed and divided by factor (a boxcar / first order
+     * CIC decimator, in integer arithmetic). Values keep the same scale, with less noise, so the
+     * filters can be shorter. A read of two pins converts as many times as the higher of the two
+     * factors. The time of each value (see getConversionUS) is the start of its first conversion, a
+     * fixed offset for each factor, so sample intervals are unchanged. With startConversion /
+     * readConversion the extra conversions run in readConversion; the background scanner instead runs
+     * one per interrupt (see restartConversion), so a frame takes factor times as many ticks.
+     *
+     * @param factor Conversions per read, 1 (the default, ADC_OVERSAMPLING) to MAX_OVERSAMPLING
+     */
+    void setOversampling(int signalPinIndex, int factor);
+    int getOversampling(int signalPinIndex) const { return _oversampling[signalPinIndex]; }
+    // conversions per read of the pins currently selected
+    int oversampling() const { return max(_oversampling[_currentSignalPinIndex0], _oversampling[_currentSignalPinIndex1]); }
+
     // getter functions for retrieving the last (cached) ADC values
     int getAdcValue1() { return _lastValue0; }
     int getAdcValue2() { return _lastValue1; }
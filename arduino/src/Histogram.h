@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Count, min, max and sum of a series of durations (or any other unsigned values)
+ */
+struct RunningStats {
+    uint32_t count = 0;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t sum = 0;
+
+    void add(uint32_t value) {
+        count++;
+        sum += value;
+        if (value < min) {
+            min = value;
+        }
+        if (value > max) {
+            max = value;
+        }
+    }
+
+    void reset() { *this = RunningStats(); }
+    float mean() const { return count ? (float)sum / count : 0; }
+};
+
+/**
+ * @brief Histogram with power of 2 buckets, i.e. bucket b counts values in [2^b, 2^(b+1))
+ *
+ * Cheap enough to update in the scan loop (a count leading zeros and an increment), and small
+ * (32 buckets), at the cost of percentiles only being known to within a factor of 2.
+ */
+class Histogram {
+public:
+    static const int N_BUCKETS = 32;
+
+    void add(uint32_t value) {
+        _stats.add(value);
+        _buckets[bucketOf(value)]++;
+    }
+
+    void reset() {
+        _stats.reset();
+        for (int b = 0; b < N_BUCKETS; b++) {
+            _buckets[b] = 0;
+        }
+    }
+
+    const RunningStats& stats() const { return _stats; }
+    uint32_t bucket(int b) const { return _buckets[b]; }
+
+    /**
+     * @brief Upper bound on a percentile, e.g. percentile(0.99) for p99
+     *
+     * Returns the top of the bucket holding the percentile (capped at the max value seen).
+     */
+    uint32_t percentile(float p) const {
+        if (_stats.count == 0) {
+            return 0;
+        }
+        uint32_t target = (uint32_t)(p * _stats.count);
+        uint32_t cumulative = 0;
+        for (int b = 0; b < N_BUCKETS; b++) {
+            cumulative += _buckets[b];
+            if (cumulative > target) {
+                uint32_t top = (b == N_BUCKETS - 1) ? UINT32_MAX : ((1UL << (b + 1)) - 1);
+                return (top < _stats.max) ? top : _stats.max;
+            }
+        }
+        return _stats.max;
+    }
+
+    static int bucketOf(uint32_t value) {
+        return value ? 31 - __builtin_clz(value) : 0;
+    }
+
+private:
+    RunningStats _stats;
+    uint32_t _buckets[N_BUCKETS] = {};
+};
@@ -0,0 +1,343 @@
+#include "KeyBank.h"
+#include <Arduino.h>
+
+KeyBank::KeyBank() {
+    _keys = NULL;
+    _nKeys = 0;
+    _iteration = 0;
+    _lastStepUS = 0;
+    _historyHead = 0;
+    _historyCount = 0;
+    for (int w = 0; w < KEY_BANK_WORDS; w++) {
+        _active[w] = 0;
+        _armed[w] = 0;
+        _noteOn[w] = 0;
+        _noteOnThresholdPassed[w] = 0;
+        _aboveOnsetLevel[w] = 0;
+        _idle[w] = 0;
+    }
+}
+
+void KeyBank::begin(KeyHammer* keys, int nKeys) {
+    _keys = keys;
+    _nKeys = min(nKeys, MAX_BANK_KEYS);
+    for (int i = 0; i < _nKeys; i++) {
+        _adcFn[i] = _keys[i].getAdcFn();
+        loadParams(i);
+        _rawADC[i] = _keys[i].getAdcValKeyUp();
+        _keyPosition[i] = SimMath::positionFromInt(_keys[i].getAdcValKeyUp());
+        _keySpeed[i] = 0;
+        _hammerPosition[i] = _keyPosition[i];
+        _speedScaler[i] = SimMath::SpeedScaler();
+        _hammerSpeed[i] = 0;
+        _noteOnThresholdElapsedUS[i] = 0;
+        _inBandCount[i] = 0;
+        _heldCount[i] = 0;
+        _sampleUS[i] = 0;
+        _elapsedUS[i] = 0;
+        clearFlag(_idle, i);
+        _posS0[i] = 0;
+        _posS1[i] = 0;
+        _speedS0[i] = 0;
+        _speedS1[i] = 0;
+        setFlag(_armed, i);
+    }
+    _posCoeffs = RunningLinearFit::coeffsFor(0);
+    _speedCoeffs = RunningLinearFit::coeffsFor(0);
+    _iteration = 0;
+    _historyHead = 0;
+    _historyCount = 0;
+}
+
+void KeyBank::loadParams(int i) {
+    KeyHammer& key = _keys[i];
+    // same convention as KeyHammer::getAdcValue: negative adc values are used if adcValKeyUp > adcValKeyDown
+    _adcSign[i] = (key.getAdcValKeyUp() < 0) ? -1 : 1;
+    _gravity[i] = SimMath::gravityFromFloat(key.getGravity());
+    _hammerSpeedScaler[i] = SimMath::scalerFromFloat(key.getHammerSpeedScaler());
+    _noteOnThreshold[i] = SimMath::positionFromInt(key.getNoteOnThreshold());
+    _noteOffThreshold[i] = SimMath::positionFromInt(key.getNoteOffThreshold());
+    _keyResetThreshold[i] = SimMath::positionFromInt(key.getKeyResetThreshold());
+    _onsetLevel[i] = key.getOnsetLevel();
+    _adcValKeyUp[i] = key.getAdcValKeyUp();
+    _restBand[i] = key.getRestBand();
+    // keys dumping their buffers are stepped by their KeyHammer, which keeps them (see KeyHammer::dumpBuffers)
+    if (key.isEnabled() && !key.isCalibrating() && (key.getPrintMode() != PRINT_BUFFER)) {
+        setFlag(_active, i);
+    } else {
+        clearFlag(_active, i);
+        _heldCount[i] = 0;
+    }
+}
+
+void KeyBank::loadParams() {
+    for (int i = 0; i < _nKeys; i++) {
+        loadParams(i);
+    }
+}
+
+void KeyBank::step(uint32_t nowUS) {
+    step(nowUS, NULL, NULL, NULL);
+}
+
+void KeyBank::step(uint32_t nowUS, const int* samples, const uint32_t* sampled, const uint32_t* sampleUS) {
+    if (_iteration == 0) {
+        _lastStepUS = nowUS;
+    }
+    int scanElapsedUS = nowUS - _lastStepUS;
+    _lastStepUS = nowUS;
+    readKeys(nowUS, scanElapsedUS, samples, sampled, sampleUS);
+    #ifdef USE_IDLE_FAST_PATH
+    if (_iteration > BUFFER_SIZE) {
+        updateIdle();
+    }
+    #endif
+
+    updateKeys();
+    updateKeySpeeds();
+    _historyHead = (_historyHead + 1) % _historyLength;
+    if (_historyCount < _historyLength) {
+        _historyCount++;
+    }
+    if (_iteration > BUFFER_SIZE) {
+        updateHammers();
+        checkNoteOns();
+        checkNoteOffs();
+    }
+    _iteration++;
+}
+
+void KeyBank::readKeys(uint32_t nowUS, int scanElapsedUS, const int* samples, const uint32_t* sampled, const uint32_t* sampleUS) {
+    // keys read here are timed by the conversion they came from, if known
+    uint32_t (*sampleClock)(void) = samples ? NULL : KeyHammer::getSampleClock();
+    // keys must be read in order, so that DualAdcManager can reuse the second value of each read
+    int* slot = _adcHistory[_historyHead];
+    for (int i = 0; i < _nKeys; i++) {
+        PROF_KEY(_keys[i].pitch);
+        if (sampled && !getFlag(sampled, i)) {
+            // the held (or skipped) sample stands in for one a scan after the last
+            _elapsedUS[i] = scanElapsedUS;
+            _sampleUS[i] += scanElapsedUS;
+            if (getFlag(_active, i)) {
+                // hold the last value, until fillSkipped replaces it
+                _heldCount[i]++;
+            } else {
+                _keys[i].skip();
+            }
+            slot[i] = _rawADC[i];
+            continue;
+        }
+        if (getFlag(_active, i)) {
+            int sample = _adcSign[i] * (samples ? samples[i] : _adcFn[i]());
+            if (_heldCount[i] > 0) {
+                fillSkipped(i, sample);
+            }
+            _rawADC[i] = sample;
+            #ifdef USE_LATENCY_TRACKER
+            // same as KeyHammer: the raw adc value crossing the onset level marks the start of a press
+            if ((_rawADC[i] > _onsetLevel[i]) != getFlag(_aboveOnsetLevel, i)) {
+                toggleFlag(_aboveOnsetLevel, i);
+                if (getFlag(_aboveOnsetLevel, i)) {
+                    LAT_ONSET(_keys[i].pitch, sampleUS ? sampleUS[i] : (sampleClock ? sampleClock() : nowUS));
+                }
+            }
+            #endif
+        } else {
+            // calibrating/disabled keys are handled (cold path) by their KeyHammer
+            // history is still kept up to date, so the filters are valid when the key rejoins the bank
+            if (samples) {
+                _keys[i].step(nowUS, samples[i], sampleUS ? sampleUS[i] : nowUS);
+            } else {
+                _keys[i].step(nowUS);
+            }
+            _rawADC[i] = _keys[i].getRawADC();
+        }
+        uint32_t timeUS = sampleUS ? sampleUS[i] : (sampleClock ? sampleClock() : nowUS);
+        _elapsedUS[i] = (_iteration == 0) ? 0 : (int)(timeUS - _sampleUS[i]);
+        _sampleUS[i] = timeUS;
+        slot[i] = _rawADC[i];
+    }
+    // the remaining stages run over all keys at once
+    PROF_KEY(-1);
+}
+
+void KeyBank::fillSkipped(int i, int sample) {
+    // the last _heldCount samples all hold the last value read, replace them with a straight line
+    // from that value to the new sample, and correct the filter sums to match
+    const int held = _heldCount[i];
+    const int last = _rawADC[i];
+    const int posCount = min(_historyCount, SavGolayFilters::posFilterLength);
+    const int speedCount = min(_historyCount, SavGolayFilters::speedFilterLength);
+    for (int m = 1; m <= held; m++) {
+        // m scans back, newest in the window is at index count - 1
+        int j = held + 1 - m;
+        int delta = (sample - last) * j / (held + 1);
+        if (m <= posCount) {
+            RunningLinearFit::correct(_posS0[i], _posS1[i], posCount - m, delta);
+        }
+        if (m <= speedCount) {
+            RunningLinearFit::correct(_speedS0[i], _speedS1[i], speedCount - m, delta);
+        }
+        _adcHistory[(_historyHead + _historyLength - m) % _historyLength][i] += delta;
+    }
+    _heldCount[i] = 0;
+}
+
+void KeyBank::updateIdle() {
+    // the filter windows must hold nothing but resting samples before a key goes idle
+    const int window = _historyLength - 1;
+    for (int i = 0; i < _nKeys; i++) {
+        if (abs(_rawADC[i] - _adcValKeyUp[i]) > _restBand[i]) {
+            _inBandCount[i] = 0;
+            clearFlag(_idle, i);
+            continue;
+        }
+        if (_inBandCount[i] < window) {
+            _inBandCount[i]++;
+        }
+        // the hammer is resting on the key when it was last stepped
+        if ((_inBandCount[i] >= window) && !getFlag(_noteOn, i) && getFlag(_armed, i)
+            && !getFlag(_noteOnThresholdPassed, i) && (_hammerPosition[i] <= _keyPosition[i])) {
+            setFlag(_idle, i);
+        }
+    }
+}
+
+void KeyBank::updateKeys() {
+    PROF_SCOPE(PROF_FILTER);
+    // update the running sums of the position filter with the new sample, equivalent to applying
+    // SavGolayFilters::posFilter to the most recent samples
+    const int n = _nKeys;
+    const int length = SavGolayFilters::posFilterLength;
+    // number of samples in the window before this one
+    const int count = min(_historyCount, length);
+    const int* newest = _adcHistory[_historyHead];
+    const int* leaving = _adcHistory[(_historyHead + _historyLength - length) % _historyLength];
+    for (int i = 0; i < n; i++) {
+        RunningLinearFit::slide(_posS0[i], _posS1[i], count, length, newest[i], leaving[i]);
+    }
+    if (count < length) {
+        _posCoeffs = RunningLinearFit::coeffsFor(count + 1);
+    }
+    for (int i = 0; i < n; i++) {
+        _keyPosition[i] = RunningLinearFit::endValue(_posS0[i], _posS1[i], _posCoeffs);
+    }
+}
+
+void KeyBank::updateKeySpeeds() {
+    PROF_SCOPE(PROF_FILTER);
+    const int n = _nKeys;
+    const int length = SavGolayFilters::speedFilterLength;
+    const int count = min(_historyCount, length);
+    const int* newest = _adcHistory[_historyHead];
+    const int* leaving = _adcHistory[(_historyHead + _historyLength - length) % _historyLength];
+    for (int i = 0; i < n; i++) {
+        RunningLinearFit::slide(_speedS0[i], _speedS1[i], count, length, newest[i], leaving[i]);
+    }
+    if (count < length) {
+        _speedCoeffs = RunningLinearFit::coeffsFor(count + 1);
+    }
+    // slope is in adc bits per sample, convert to adc bits per microsecond with each key's own
+    // sample interval
+    for (int i = 0; i < n; i++) {
+        _keySpeed[i] = _speedScaler[i].speed(RunningLinearFit::slope(_speedS0[i], _speedS1[i], _speedCoeffs), _elapsedUS[i]);
+    }
+}
+
+void KeyBank::updateHammers() {
+    PROF_SCOPE(PROF_HAMMER);
+    for (int w = 0; w < KEY_BANK_WORDS; w++) {
+        uint32_t mask = _active[w] & _armed[w] & ~_idle[w];
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            mask &= mask - 1;
+            int i = (w << 5) + bit;
+            const int32_t elapsed = SimMath::clampElapsed(_elapsedUS[i]);
+            SimMath::speed_t hammerSpeed = _hammerSpeed[i] - SimMath::gravityStep(_gravity[i], elapsed);
+            SimMath::position_t hammerPosition = _hammerPosition[i] + SimMath::travel(hammerSpeed, elapsed);
+            // check for interaction with key
+            if (hammerPosition < _keyPosition[i]) {
+                hammerPosition = _keyPosition[i];
+                hammerSpeed = _keySpeed[i];
+            }
+            _hammerSpeed[i] = hammerSpeed;
+            _hammerPosition[i] = hammerPosition;
+        }
+    }
+}
+
+void KeyBank::checkNoteOns() {
+    PROF_SCOPE(PROF_NOTES);
+    for (int w = 0; w < KEY_BANK_WORDS; w++) {
+        uint32_t mask = _active[w] & _armed[w] & ~_idle[w];
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            mask &= mask - 1;
+            int i = (w << 5) + bit;
+            if (_hammerPosition[i] > _noteOnThreshold[i]) {
+                // start the clock the first time the hammer passes the threshold
+                if (!getFlag(_noteOnThresholdPassed, i)) {
+                    _noteOnThresholdElapsedUS[i] = 0;
+                    setFlag(_noteOnThresholdPassed, i);
+                    LAT_THRESHOLD(_keys[i].pitch, _sampleUS[i]);
+                } else {
+                    _noteOnThresholdElapsedUS[i] += _elapsedUS[i];
+                }
+                // same rule as KeyHammer::checkNoteOn: note on after 10ms, or when the key stops moving down
+                if ((_noteOnThresholdElapsedUS[i] > 10000) || (_keySpeed[i] <= 0)) {
+                    noteOn(i);
+                }
+            }
+        }
+    }
+}
+
+void KeyBank::noteOn(int i) {
+    SimMath::speed_t velocity = _hammerSpeed[i];
+    int velocityIndex = SimMath::velocityIndex(velocity, _hammerSpeedScaler[i]);
+    velocityIndex = min(velocityIndex, velocityMapLength - 1);
+    velocityIndex = max(velocityIndex, 0);
+    KeyHammer& key = _keys[i];
+    {
+        PROF_SCOPE(PROF_MIDI);
+        MIDI_NOTE_ON(key.getMidiSender(), key.pitch, velocityMap[velocityIndex], 2, _sampleUS[i]);
+    }
+    if (key.getPrintMode() == PRINT_NOTES) {
+        Serial.printf("\n ON-%d: hammerSpeed_bits_us %f, velocity %d \n", key.pitch, SimMath::speedToFloat(velocity), velocityMap[velocityIndex]);
+    }
+    setFlag(_noteOn, i);
+    clearFlag(_noteOnThresholdPassed, i);
+    clearFlag(_armed, i);
+    _hammerPosition[i] = _noteOnThreshold[i];
+    _hammerSpeed[i] = -_hammerSpeed[i];
+}
+
+void KeyBank::checkNoteOffs() {
+    PROF_SCOPE(PROF_NOTES);
+    // only keys with a note sounding need checking
+    for (int w = 0; w < KEY_BANK_WORDS; w++) {
+        uint32_t mask = _active[w] & _noteOn[w];
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            mask &= mask - 1;
+            int i = (w << 5) + bit;
+            if (!getFlag(_armed, i) && (_keyPosition[i] < _keyResetThreshold[i])) {
+                setFlag(_armed, i);
+                // reset hammer position / speed when key is re-armed
+                _hammerPosition[i] = _keyPosition[i];
+                _hammerSpeed[i] = _keySpeed[i];
+            }
+            if (_keyPosition[i] < _noteOffThreshold[i]) {
+                KeyHammer& key = _keys[i];
+                {
+                    PROF_SCOPE(PROF_MIDI);
+                    MIDI_NOTE_OFF(key.getMidiSender(), key.pitch, 64, 2, _sampleUS[i]);
+                }
+                if (key.getPrintMode() == PRINT_NOTES) {
+                    Serial.printf("OFF-%d: keySpeed_bits_us %f \n", key.pitch, getKeySpeed(i));
+                }
+                clearFlag(_noteOn, i);
+            }
+        }
+    }
+}
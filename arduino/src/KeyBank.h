@@ -0,0 +1,171 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "KeyHammer.h"
+#include "SavGolayFilters.h"
+#include "RunningLinearFit.h"
+
+// number of 32 bit words needed to hold one flag per key
+#define KEY_BANK_WORDS ((MAX_BANK_KEYS + 31) / 32)
+
+/**
+ * @brief Steps a whole bank of keys in one batched pass
+ *
+ * KeyHammer keeps all of the state for one key in one object, so stepping 84 keys means jumping
+ * between 84 objects (each with several buffers) per scan. KeyBank instead keeps the hot simulation
+ * state in contiguous arrays, one per field, and runs each stage of the simulation (updateKey,
+ * updateKeySpeed, updateHammer, checkNoteOn, checkNoteOff) as a tight loop over all keys.
+ *
+ * The KeyHammer objects are still used for the cold state: calibration, parameters, printing.
+ * Keys that are calibrating (or disabled), or are dumping their buffers (PRINT_BUFFER), are stepped
+ * by their KeyHammer object instead of the bank.
+ * Resting keys (see KeyHammer::updateIdle) still have their filters updated, but skip the hammer
+ * simulation and note on checks.
+ * Each key keeps the time of its own samples (see KeyHammer::setSampleClock), so speeds and the
+ * hammer simulation use the time between that key's conversions, not between scans.
+ * After changing parameters on a KeyHammer (e.g. after calibration), call loadParams so that the
+ * bank picks up the changes.
+ */
+class KeyBank {
+    static_assert(POS_FILTER_ORDER == 1 && SPEED_FILTER_ORDER == 1,
+                  "KeyBank only runs polyorder 1 default filters, undefine USE_KEY_BANK to use other orders");
+public:
+    KeyBank();
+
+    /**
+     * @brief Take over the simulation of an array of keys
+     *
+     * @param keys Array of KeyHammer objects, used for parameters/calibration/printing
+     * @param nKeys Number of keys (at most MAX_BANK_KEYS)
+     */
+    void begin(KeyHammer* keys, int nKeys);
+
+    /**
+     * @brief Reload simulation parameters (thresholds, gravity, etc.) for one key
+     *
+     * Also picks up whether the key is enabled/calibrating, or is in PRINT_BUFFER mode.
+     */
+    void loadParams(int keyIndex);
+
+    /**
+     * @brief Reload simulation parameters for all keys
+     */
+    void loadParams();
+
+    /**
+     * @brief Read all keys and step the simulation for all of them
+     *
+     * @param nowUS Time of the current scan (see ScanClock.h)
+     */
+    void step(uint32_t nowUS);
+
+    /**
+     * @brief Step the simulation for all keys, with keys already read (see ScanScheduler.h)
+     *
+     * Keys not sampled on this scan hold their last value. When a key is next sampled, the held
+     * values are replaced by a straight line to the new sample, in the history and the filter sums.
+     *
+     * @param nowUS Time of the current scan (see ScanClock.h)
+     * @param samples Value of each key, as returned by its adc function
+     * @param sampled One bit per key, set if the key was read on this scan (NULL if all were)
+     * @param sampleUS Time each sample was converted (NULL to use the time of the scan)
+     */
+    void step(uint32_t nowUS, const int* samples, const uint32_t* sampled, const uint32_t* sampleUS = NULL);
+
+    int getNumKeys() const { return _nKeys; }
+    int getRawADC(int i) const { return _rawADC[i]; }
+    float getKeyPosition(int i) const { return SimMath::positionToFloat(_keyPosition[i]); }
+    float getKeySpeed(int i) const { return SimMath::speedToFloat(_keySpeed[i]); }
+    float getHammerPosition(int i) const { return SimMath::positionToFloat(_hammerPosition[i]); }
+    float getHammerSpeed(int i) const { return SimMath::speedToFloat(_hammerSpeed[i]); }
+    int getElapsedUS(int i) const { return _elapsedUS[i]; }
+    // keys stepped by their KeyHammer (e.g. calibrating) sound notes and go idle on their own
+    bool isNoteOn(int i) const { return getFlag(_active, i) ? getFlag(_noteOn, i) : _keys[i].isNoteOn(); }
+    bool isIdle(int i) const { return getFlag(_active, i) ? getFlag(_idle, i) : _keys[i].isIdle(); }
+
+private:
+    // one more than the longest filter, so the sample leaving each filter window is still available
+    // after the new sample has been written
+    static constexpr int _historyLength = 1 + (
+        SavGolayFilters::posFilterLength > SavGolayFilters::speedFilterLength
+        ? SavGolayFilters::posFilterLength : SavGolayFilters::speedFilterLength);
+
+    // cold state
+    KeyHammer* _keys;
+    int _nKeys;
+    int _iteration;
+    uint32_t _lastStepUS;
+
+    //// hot state, one array per field
+    // reading
+    int (*_adcFn[MAX_BANK_KEYS])(void);
+    int _adcSign[MAX_BANK_KEYS];
+    int _rawADC[MAX_BANK_KEYS];
+    // time of each key's last sample, and since the one before
+    uint32_t _sampleUS[MAX_BANK_KEYS];
+    int _elapsedUS[MAX_BANK_KEYS];
+    // history of adc values, ordered [sample][key], so that each step touches contiguous memory
+    // all keys are pushed on each step, so one head index is shared by all keys
+    int _adcHistory[_historyLength][MAX_BANK_KEYS];
+    int _historyHead;
+    int _historyCount;
+    // running sums for the position/speed filters (polyorder 1 sav golay filters, see RunningLinearFit.h)
+    int32_t _posS0[MAX_BANK_KEYS];
+    int32_t _posS1[MAX_BANK_KEYS];
+    int32_t _speedS0[MAX_BANK_KEYS];
+    int32_t _speedS1[MAX_BANK_KEYS];
+    // shared by all keys, since all keys have the same number of samples
+    RunningLinearFit::Coeffs _posCoeffs;
+    RunningLinearFit::Coeffs _speedCoeffs;
+    // simulation, in the same types as KeyHammer (float, or fixed point with USE_FIXED_POINT, see SimMath.h)
+    SimMath::position_t _keyPosition[MAX_BANK_KEYS];
+    SimMath::speed_t _keySpeed[MAX_BANK_KEYS];
+    SimMath::position_t _hammerPosition[MAX_BANK_KEYS];
+    SimMath::speed_t _hammerSpeed[MAX_BANK_KEYS];
+    SimMath::gravity_t _gravity[MAX_BANK_KEYS];
+    SimMath::scaler_t _hammerSpeedScaler[MAX_BANK_KEYS];
+    SimMath::position_t _noteOnThreshold[MAX_BANK_KEYS];
+    SimMath::position_t _noteOffThreshold[MAX_BANK_KEYS];
+    SimMath::position_t _keyResetThreshold[MAX_BANK_KEYS];
+    // converts each key's speed filter output to speed per microsecond
+    SimMath::SpeedScaler _speedScaler[MAX_BANK_KEYS];
+    // raw adc level marking the start of a press, for latency measurement (see LatencyTracker.h)
+    int _onsetLevel[MAX_BANK_KEYS];
+    // idle fast path (see KeyHammer::updateIdle): resting value, noise band either side of it, and
+    // consecutive samples inside the band
+    int _adcValKeyUp[MAX_BANK_KEYS];
+    int _restBand[MAX_BANK_KEYS];
+    uint16_t _inBandCount[MAX_BANK_KEYS];
+    // scans in a row a key has not been sampled, with its last value held (see ScanScheduler.h)
+    uint16_t _heldCount[MAX_BANK_KEYS];
+    // time since hammer passed noteOnThreshold, in microseconds
+    uint32_t _noteOnThresholdElapsedUS[MAX_BANK_KEYS];
+
+    // flags, one bit per key
+    // keys stepped by the bank (enabled and not calibrating)
+    uint32_t _active[KEY_BANK_WORDS];
+    uint32_t _armed[KEY_BANK_WORDS];
+    uint32_t _noteOn[KEY_BANK_WORDS];
+    uint32_t _noteOnThresholdPassed[KEY_BANK_WORDS];
+    uint32_t _aboveOnsetLevel[KEY_BANK_WORDS];
+    // resting keys, which skip the hammer simulation and note checks
+    uint32_t _idle[KEY_BANK_WORDS];
+
+    static bool getFlag(const uint32_t* flags, int i) { return (flags[i >> 5] >> (i & 31)) & 1; }
+    static void setFlag(uint32_t* flags, int i) { flags[i >> 5] |= (1UL << (i & 31)); }
+    static void clearFlag(uint32_t* flags, int i) { flags[i >> 5] &= ~(1UL << (i & 31)); }
+    static void toggleFlag(uint32_t* flags, int i) { flags[i >> 5] ^= (1UL << (i & 31)); }
+
+    // stages, each a loop over all keys
+    void readKeys(uint32_t nowUS, int scanElapsedUS, const int* samples, const uint32_t* sampled, const uint32_t* sampleUS);
+    void fillSkipped(int i, int sample);
+    void updateIdle();
+    void updateKeys();
+    void updateKeySpeeds();
+    void updateHammers();
+    void checkNoteOns();
+    void checkNoteOffs();
+
+    void noteOn(int i);
+};
@@ -9,10 +9,11 @@
 // set up map of velocities, mapping from hammer speed to midi value
 // hammer speed seems to range from ~0.005 to ~0.05 adc bits per microsecond
 // ~5 to ~50 adc bits per millisecond, ~5000 to ~50,000 adc bits per second
-const int velocityMapLength = 1024;
 const float logBase = 5; // base used for log multiplier, with 1 setting the multiplier to always 1
 int velocityMap[velocityMapLength];
 
+uint32_t (*KeyHammer::sampleClock)(void) = NULL;
+
 
 // use a constructor initializer list for adc, otherwise the reference won't work
 KeyHammer::KeyHammer (int(*adcFnPtr)(void), MidiSender* midiSender, int pitch, int adcValKeyDown=430, int adcValKeyUp=50, float hammer_travel=4.5, float maxHammerSpeed_m_s=2.5)
@@ -20,19 +21,18 @@ KeyHammer::KeyHammer (int(*adcFnPtr)(void), MidiSender* midiSender, int pitch, i
   
   updateADCParams();
   
-  keyPosition = adcValKeyUp;
-  lastKeyPosition = adcValKeyUp;
+  keyPosition = SimMath::positionFromInt(adcValKeyUp);
+  lastKeyPosition = keyPosition;
   rawADC = adcValKeyUp;
-  keySpeed = 0.0;
-  hammerPosition = adcValKeyUp;
-  hammerSpeed = 0.0;
+  keySpeed = 0;
+  hammerPosition = keyPosition;
+  hammerSpeed = 0;
 
   noteOn = false;
   keyArmed = true;
 
-  scaleFilterWeights(SavGolayFilters::posFilter, SavGolayFilters::posFilterLength);
-
-  elapsedUS = 0;
+  // the generated position filters already sum to 1, so there is no need to scale them here
+  // (they are constexpr, and with USE_FIXED_POINT the integer copies are made at compile time)
 
   // initialize velocity map
   if (velocityMap[velocityMapLength-1] == 0) {
@@ -57,6 +57,9 @@ void KeyHammer::updateADCParams () {
   noteOnThreshold = adcValKeyDown + 0.06 * (adcValKeyDown - adcValKeyUp);
   noteOffThreshold = adcValKeyDown - 0.5 * (adcValKeyDown - adcValKeyUp);
   keyResetThreshold = adcValKeyDown - 0.5 * (adcValKeyDown - adcValKeyUp);
+  onsetLevel = adcValKeyUp + LATENCY_ONSET_FRACTION * (adcValKeyDown - adcValKeyUp);
+  // noise band around the resting value, from the spread of resting samples seen during calibration
+  restBand = max(IDLE_BAND_MIN, (int)ceilf(IDLE_BAND_STDS * c_up_sample_std));
 
   // gravity calculation
   // gravity in metres per microsecond^2
@@ -65,11 +68,11 @@ void KeyHammer::updateADCParams () {
   float gravity_mm = gravity_m * 1000;
   // gravity in adc bits per microsecond^2
   // hammer travel is in mm
-  gravity = gravity_mm  / hammer_travel * (adcValKeyDown - adcValKeyUp);
+  gravity = SimMath::gravityFromFloat(gravity_mm  / hammer_travel * (adcValKeyDown - adcValKeyUp));
 
   float maxHammerSpeed_bits_us = convert_m_s2bits_us(maxHammerSpeed_m_s);
 
-  hammerSpeedScaler = velocityMapLength / maxHammerSpeed_bits_us;
+  hammerSpeedScaler = SimMath::scalerFromFloat(velocityMapLength / maxHammerSpeed_bits_us);
 }
 
 
@@ -77,17 +80,16 @@ void KeyHammer::toggleCalibration () {
   if (! calibrating) {
     c_mode = CalibMode::UP;
     calibrating = true;
-    c_elapsedMS = 0;
+    idle = false;
+    inBandCount = 0;
+    // c_startUS is set by the first calibration step
     c_sample_t = 0;
+    c_stats.reset();
   }
   else {
     calibrating = false;
-    c_elapsedMS = 0;
-    // add samples to stats object
-    Array_Stats<float> downStats(c_reservoir, min(c_sample_t, c_sample_n));
-    //  in later versions of Statistical, this is median()
-    c_down_sample_med = downStats.Quartile(2);
-    c_down_sample_std = downStats.Standard_Deviation();
+    c_down_sample_med = c_stats.quantile();
+    c_down_sample_std = c_stats.std();
     if ((abs(c_up_sample_med - c_down_sample_med) > (20 * c_up_sample_std)) && (c_sample_t >= c_sample_n)) {
       adcValKeyDown = c_down_sample_med;
       adcValKeyUp = c_up_sample_med;
@@ -101,30 +103,26 @@ void KeyHammer::toggleCalibration () {
 }
 
 void KeyHammer::calibrationSample () {
-  if (c_sample_t < c_sample_n) {
-    c_reservoir[c_sample_t] = rawADC;
-  } else {
-    int m = random(0, c_sample_t + 1);
-    if (m < c_sample_n) {
-      c_reservoir[m] = rawADC;      
-    }
-  }
+  c_stats.add(rawADC);
   c_sample_t += 1;
 }
 
 void KeyHammer::stepCalibration () {
   updateKey();
+  if ((c_mode == CalibMode::UP) && (c_sample_t == 0)) {
+    // time calibration from its first sample: a key stepped by a KeyBank until now has a stale clock
+    c_startUS = nowUS;
+    lastStepUS = nowUS;
+  }
   updateElapsed();
   if (c_mode == CalibMode::UP) {
     calibrationSample();
-    if (c_elapsedMS > 1000) {
-      // use Array_Stats to calculate statistics
-      Array_Stats<float> upStats(c_reservoir, min(c_sample_t, c_sample_n));
-      //  in later versions of Statistical, this is median()
-      c_up_sample_med = upStats.Quartile(2);
-      c_up_sample_std = upStats.Standard_Deviation();
+    if (nowUS - c_startUS > 1000000) {
+      c_up_sample_med = c_stats.quantile();
+      c_up_sample_std = c_stats.std();
       c_mode = CalibMode::DOWN;
       c_sample_t = 0;
+      c_stats.reset();
     }
   } else if (
             (rawADC > (c_up_sample_med + 15 * c_up_sample_std))
@@ -132,25 +130,87 @@ void KeyHammer::stepCalibration () {
           ) {
     calibrationSample();
   }
-  elapsedUS = 0;
 }
 
 
 
 void KeyHammer::updateElapsed () {
-  elapsedUSBuffer.push(elapsedUS);
+  uint32_t elapsed = nowUS - lastStepUS;
+  // samples filled in for skipped scans are evenly spaced
+  uint32_t spacing = elapsed / (skippedSamples + 1);
+  for (int j = 0; j < skippedSamples; j++) {
+    elapsedUSBuffer.push(spacing);
+  }
+  elapsedUSBuffer.push(elapsed - skippedSamples * spacing);
+  skippedSamples = 0;
+  lastStepUS = nowUS;
 }
 
 void KeyHammer::updateKey () {
-  lastKeyPosition = keyPosition;
+  readSample();
+  updateKeyPosition();
+}
+
+void KeyHammer::readSample () {
+  int lastRawADC = rawADC;
   rawADC = getAdcValue();
-  adcBuffer.push(rawADC);
-  keyPosition = applyFilter(adcBuffer, SavGolayFilters::posFilter, SavGolayFilters::posFilterLength);
+  // from here on the key's time is when the sample was converted
+  if (hasSuppliedSample) {
+    nowUS = suppliedSampleUS;
+  } else if (sampleClock) {
+    nowUS = sampleClock();
+  }
+  if (iteration == 0) {
+    lastStepUS = nowUS;
+  }
+  PROF_SCOPE(PROF_FILTER);
+  // fill in any skipped scans with a straight line from the last sample (see skip)
+  // updateElapsed then adds the matching elapsed times
+  for (int j = 1; j <= skippedSamples; j++) {
+    pushSample(lastRawADC + (rawADC - lastRawADC) * j / (skippedSamples + 1));
+  }
+  pushSample(rawADC);
+}
+
+void KeyHammer::pushSample (int sample) {
+  // samples leaving the filter windows (only used once the windows are full)
+  int size = adcBuffer.size();
+  int posLeaving = (size >= posFit.length()) ? adcBuffer[size - posFit.length()] : 0;
+  int speedLeaving = (size >= speedFit.length()) ? adcBuffer[size - speedFit.length()] : 0;
+  adcBuffer.push(sample);
+  posFit.push(sample, posLeaving);
+  speedFit.push(sample, speedLeaving);
+}
+
+void KeyHammer::updateKeyPosition () {
+  PROF_SCOPE(PROF_FILTER);
+  lastKeyPosition = keyPosition;
+  if (POS_FILTER_ORDER == 1) {
+    // equivalent to applying the position filter to adcBuffer
+    keyPosition = posFit.endValue();
+  } else {
+    keyPosition = applyFilter(adcBuffer, SimMath::posFilter, SavGolayFilters::posFilterLength);
+  }
 
 }
 
 void KeyHammer::updateKeySpeed () {
-  keySpeed = applyFilter(adcBuffer, SavGolayFilters::speedFilter, SavGolayFilters::speedFilterLength) / (float)elapsedUSBuffer.last();
+  PROF_SCOPE(PROF_FILTER);
+  // filter output is in adc bits per sample
+  SimMath::filter_acc_t perSample;
+  if (SPEED_FILTER_ORDER == 1) {
+    // equivalent to applying the speed filter to adcBuffer
+    perSample = speedFit.slope();
+  } else {
+    perSample = applyFilter(adcBuffer, SimMath::speedFilter, SavGolayFilters::speedFilterLength);
+  }
+  keySpeed = speedScaler.speed(perSample, elapsedUSBuffer.last());
+  #ifdef USE_FIXED_POINT
+  // meanStrikeKeySpeed is only used for printing, so don't pay for the float division unless printing notes
+  if (printMode != PRINT_NOTES) {
+    return;
+  }
+  #endif
   // track the mean key speed since last indication of the start of a key press or 'strike'
   // that indication could be keySpeed > 0, along with one of...
   // - hammer key interaction
@@ -164,16 +224,18 @@ void KeyHammer::updateKeySpeed () {
   } else {
     // update meanStrikeKeySpeed
     meanStrikeKeySpeedSamples += 1;
-    meanStrikeKeySpeed = keySpeed / meanStrikeKeySpeedSamples + meanStrikeKeySpeed * (meanStrikeKeySpeedSamples - 1) / meanStrikeKeySpeedSamples;
+    meanStrikeKeySpeed = SimMath::speedToFloat(keySpeed) / meanStrikeKeySpeedSamples + meanStrikeKeySpeed * (meanStrikeKeySpeedSamples - 1) / meanStrikeKeySpeedSamples;
   }
 
 }
 
 void KeyHammer::updateHammer () {
+  PROF_SCOPE(PROF_HAMMER);
   // TODO: position should be updated using the mean of old and new speeds
   // see circuitpy code
-  hammerSpeed = hammerSpeed - gravity * elapsedUSBuffer.last();
-  hammerPosition = hammerPosition + hammerSpeed * elapsedUSBuffer.last();
+  int elapsed = SimMath::clampElapsed(elapsedUSBuffer.last());
+  hammerSpeed = hammerSpeed - SimMath::gravityStep(gravity, elapsed);
+  hammerPosition = hammerPosition + SimMath::travel(hammerSpeed, elapsed);
   // check for interaction with key
   if (hammerPosition < keyPosition) {
           hammerPosition = keyPosition;
@@ -192,71 +254,116 @@ void KeyHammer::updateHammer () {
 }
 
 void KeyHammer::checkNoteOn () {
+  PROF_SCOPE(PROF_NOTES);
   // check for note ons
   // do something with noteOnThresholdElapsedUS... set to 0 when hammer passes threshold for the first time noteOnThresholdPassed
 
-  if (keyArmed && (hammerPosition > noteOnThreshold)) {
+  if (keyArmed && (hammerPosition > SimMath::positionFromInt(noteOnThreshold))) {
     // if this is the first time the hammer has passed the noteOnThreshold, start the clock
     if (! noteOnThresholdPassed) {
-      noteOnThresholdElapsedUS = 0;
+      noteOnThresholdUS = nowUS;
       noteOnThresholdPassed = true;
+      LAT_THRESHOLD(pitch, nowUS);
     }
     // we generate a note on after the hammer has passed the noteOnThreshold if
     // - more than 10ms have elapsed, or
     // - the key is no longer moving down
-    if ((noteOnThresholdElapsedUS > 10000) || (keySpeed <= 0)) {
+    if ((nowUS - noteOnThresholdUS > 10000) || (keySpeed <= 0)) {
       // do something with hammer speed to get velocity
       velocity = hammerSpeed;
       // velocity = meanStrikeKeySpeed;
-      velocityIndex = round(velocity * hammerSpeedScaler);
+      velocityIndex = SimMath::velocityIndex(velocity, hammerSpeedScaler);
       velocityIndex = min(velocityIndex, velocityMapLength-1);
       // sometimes negative values for velocityIndex occur, probably due to a mismatch between thresholds and actual ADC range
       velocityIndex = max(velocityIndex, 0);
-      midiSender->sendNoteOn(pitch, velocityMap[velocityIndex], 2);
+      {
+        PROF_SCOPE(PROF_MIDI);
+        MIDI_NOTE_ON(midiSender, pitch, velocityMap[velocityIndex], 2, nowUS);
+      }
       // useful when testing
       // midiSender->sendNoteOn(50 + noteCount % 12, 64, 2);
       noteOn = true;
       noteOnThresholdPassed = false;
       keyArmed = false;
       if (printMode == PRINT_NOTES){
-        Serial.printf("\n ON-%d: hammerSpeed_bits_us %f, hammerSpeed_m_s %f, meanStrikeKeySpeed_m_s %f, meanKeySamples %d, velocity %d \n", pitch, velocity, convert_bits_us2m_s(velocity), convert_bits_us2m_s(meanStrikeKeySpeed), meanStrikeKeySpeedSamples, velocityMap[velocityIndex]);
+        Serial.printf("\n ON-%d: hammerSpeed_bits_us %f, hammerSpeed_m_s %f, meanStrikeKeySpeed_m_s %f, meanKeySamples %d, velocity %d \n", pitch, SimMath::speedToFloat(velocity), convert_bits_us2m_s(SimMath::speedToFloat(velocity)), convert_bits_us2m_s(meanStrikeKeySpeed), meanStrikeKeySpeedSamples, velocityMap[velocityIndex]);
       }
       // maybe print the buffer on note on?
       // could be useful for understanding adc/key/hammer behaviour
       bufferPrinted = false;
-      noteOnElapsedUS = 0;
+      noteOnUS = nowUS;
       lastNoteOnHammerSpeed = hammerSpeed;
       lastNoteOnVelocity = velocityMap[velocityIndex];
       noteCount++;
-      hammerPosition = noteOnThreshold;
+      hammerPosition = SimMath::positionFromInt(noteOnThreshold);
       hammerSpeed = -hammerSpeed;
     }
   }
 }
 
 void KeyHammer::checkNoteOff () {
+  PROF_SCOPE(PROF_NOTES);
   if (noteOn){
-    if ((! keyArmed) && (keyPosition < keyResetThreshold)) {
+    if ((! keyArmed) && (keyPosition < SimMath::positionFromInt(keyResetThreshold))) {
       keyArmed = true;
       // reset hammer position / speed when key is re-armed
       hammerPosition = keyPosition;
       hammerSpeed = keySpeed;
     }
 
-    if (keyPosition < noteOffThreshold) {
-      midiSender->sendNoteOff(pitch, 64, 2);
+    if (keyPosition < SimMath::positionFromInt(noteOffThreshold)) {
+      {
+        PROF_SCOPE(PROF_MIDI);
+        MIDI_NOTE_OFF(midiSender, pitch, 64, 2, nowUS);
+      }
       if (printMode == PRINT_NOTES){
-        Serial.printf("OFF-%d: adcValue %d, keySpeed_bits_us %f, keySpeed_m_s \n", pitch, keySpeed, convert_bits_us2m_s(keySpeed));
+        Serial.printf("OFF-%d: keySpeed_bits_us %f, keySpeed_m_s %f \n", pitch, getKeySpeed(), convert_bits_us2m_s(getKeySpeed()));
       }
       noteOn = false;
     }
   }
 }
 
+bool KeyHammer::updateIdle () {
+  if (abs(rawADC - adcValKeyUp) > restBand) {
+    inBandCount = 0;
+    idle = false;
+    return false;
+  }
+  if (inBandCount < BUFFER_SIZE) {
+    inBandCount++;
+  }
+  // only go idle once the filter windows hold nothing but resting samples, so the key position and
+  // speed have settled, and nothing is left to simulate
+  if (!idle) {
+    idle = (iteration > BUFFER_SIZE)
+           && (inBandCount >= max(SavGolayFilters::posFilterLength, SavGolayFilters::speedFilterLength))
+           && !noteOn && keyArmed && !noteOnThresholdPassed && hammerKeyInteraction;
+  }
+  return idle;
+}
+
 void KeyHammer::stepHammer () {
-  updateKey();
-  // call updateElapsed after updateKey because reading the ADC value is the slowest part of the loop
+  // the sample is always pushed, so the filters have their full history if the key wakes up
+  readSample();
+  // call updateElapsed after reading because reading the ADC value is the slowest part of the loop
   updateElapsed();
+  #ifdef USE_LATENCY_TRACKER
+  // the raw adc value crossing onsetLevel marks the start of a press
+  if ((rawADC > onsetLevel) != aboveOnsetLevel) {
+    aboveOnsetLevel = !aboveOnsetLevel;
+    if (aboveOnsetLevel) {
+      LAT_ONSET(pitch, nowUS);
+    }
+  }
+  #endif
+  #ifdef USE_IDLE_FAST_PATH
+  if (updateIdle()) {
+    hammerPositionBuffer.push(hammerPosition);
+    return;
+  }
+  #endif
+  updateKeyPosition();
   updateKeySpeed();
   if (iteration > BUFFER_SIZE) {
     if (keyArmed) {
@@ -264,17 +371,21 @@ void KeyHammer::stepHammer () {
       checkNoteOn();
     }
     checkNoteOff();
-    if ((printMode == PRINT_BUFFER) && (noteOnElapsedUS > 10000) && (!bufferPrinted)) {
-      printBuffers();
+    if ((printMode == PRINT_BUFFER) && (nowUS - noteOnUS > 10000) && (!bufferPrinted)) {
+      dumpBuffers();
       bufferPrinted = true;
     }
   }
-  elapsedUS = 0;
 }
 
 
-void KeyHammer::step () {
+void KeyHammer::step (uint32_t now) {
   if (enabled) {
+    PROF_KEY(pitch);
+    nowUS = now;
+    if (iteration == 0) {
+      lastStepUS = now;
+    }
     iterationBuffer.push(iteration);
     if (calibrating) {
       stepCalibration();
@@ -286,11 +397,30 @@ void KeyHammer::step () {
   }
 }
 
+void KeyHammer::step (uint32_t now, int sample) {
+  step(now, sample, now);
+}
+
+void KeyHammer::step (uint32_t now, int sample, uint32_t sampleUS) {
+  suppliedSample = sample;
+  suppliedSampleUS = sampleUS;
+  hasSuppliedSample = true;
+  step(now);
+  hasSuppliedSample = false;
+}
+
+void KeyHammer::skip () {
+  if (enabled && (iteration > 0)) {
+    skippedSamples++;
+  }
+}
+
 int KeyHammer::getAdcValue () {
+  int value = hasSuppliedSample ? suppliedSample : adcFnPtr();
   if (adcValKeyUp < 0) {
-    return -adcFnPtr();
+    return -value;
   }
-  return adcFnPtr();
+  return value;
 }
 
 void KeyHammer::generateVelocityMap () {
@@ -303,22 +433,10 @@ void KeyHammer::generateVelocityMap () {
   }
 }
 
-void KeyHammer::scaleFilterWeights(float* filter, size_t N) {
-    float sum = 0;
-    // size_t is an unsigned integer type, so use it for i also
-    // (but if i never negative, it would be fine anyway)
-    for (size_t i = 0; i < N; i++) {
-        sum += filter[i];
-    }
-    for (size_t i = 0; i < N; i++) {
-        filter[i] /= sum;
-    }
-}
-
 
 template <typename T, size_t bufferLength>
-float KeyHammer::applyFilter(CircularBuffer<T, bufferLength>& buffer, const float* filter, size_t filterLength) {
-  float filteredValue = 0;
+SimMath::filter_acc_t KeyHammer::applyFilter(CircularBuffer<T, bufferLength>& buffer, const SimMath::coeff_t* filter, size_t filterLength) {
+  SimMath::filter_acc_t filteredValue = 0;
   int bufferSize = buffer.size();
   int startIndex = max(0, bufferSize - filterLength);
   for (int i = 0; i < filterLength; i++) {
@@ -331,37 +449,24 @@ float KeyHammer::applyFilter(CircularBuffer<T, bufferLength>& buffer, const floa
 }
 
 
-void KeyHammer::printBuffers () {
-  int delayUS = 15;
-    for (int i = 0; i < (int)adcBuffer.size(); ++i) {
-      Serial.printf("pitch:%d,", pitch);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("noteCount:%d,", noteCount);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("noteOnHammerSpeed:%f,", lastNoteOnHammerSpeed);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("noteOnVelocity:%d,", lastNoteOnVelocity);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("rawADC:%d,", adcBuffer[i]);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("hammerPosition:%f,", hammerPositionBuffer[i]);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("elapsedUs:%d,", elapsedUSBuffer[i]);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("iteration:%d,", iterationBuffer[i]);
-      delayMicroseconds(delayUS);
-      Serial.flush();
-      Serial.printf("\n");
-      delayMicroseconds(delayUS);
-      Serial.flush();
-    }
+// copy the buffers for BufferDump to print between scans, rather than printing them here
+void KeyHammer::dumpBuffers () {
+  BufferDump::Snapshot* snapshot = BufferDump::acquire();
+  if (snapshot == NULL) {
+    return;
+  }
+  snapshot->pitch = pitch;
+  snapshot->noteCount = noteCount;
+  snapshot->noteOnHammerSpeed = SimMath::speedToFloat(lastNoteOnHammerSpeed);
+  snapshot->noteOnVelocity = lastNoteOnVelocity;
+  snapshot->n = adcBuffer.size();
+  for (int i = 0; i < snapshot->n; ++i) {
+    snapshot->rawADC[i] = adcBuffer[i];
+    snapshot->hammerPosition[i] = SimMath::positionToFloat(hammerPositionBuffer[i]);
+    snapshot->elapsedUS[i] = elapsedUSBuffer[i];
+    snapshot->iteration[i] = iterationBuffer[i];
+  }
+  BufferDump::commit();
 }
 
 void KeyHammer::printKeyParams() {
@@ -379,7 +484,7 @@ void KeyHammer::printKeyParams() {
   Serial.printf("c_down_sample_med: %d \n", c_down_sample_med);
   Serial.printf("c_down_sample_std: %f \n", c_down_sample_std);
   Serial.printf("samples collected: %d \n", c_sample_t);
-  Serial.printf("samples used: %d \n", c_sample_n);
+  Serial.printf("samples needed: %d \n", c_sample_n);
   //updatedKeyDownThreshold
   Serial.printf("updatedKeyDownThreshold: %d \n", updatedKeyDownThreshold);
   Serial.flush();
@@ -4,11 +4,25 @@
 
 #pragma once
 #include "config.h"
+#include <Arduino.h>
 #include <CircularBuffer.hpp>
-#include <elapsedMillis.h>
 #include "MidiSender.h"
-#include "Statistical.h"
+#include "StreamingStats.h"
 #include "SavGolayFilters.h"
+#include "SimMath.h"
+#include "RunningLinearFit.h"
+#include "Profiler.h"
+#include "LatencyTracker.h"
+#include "MidiQueue.h"
+#include "BufferDump.h"
+
+// velocity map, mapping from hammer speed (scaled by hammerSpeedScaler) to midi velocity
+// shared by all keys, defined in KeyHammer.cpp
+const int velocityMapLength = 1024;
+extern int velocityMap[velocityMapLength];
+
+static_assert(SavGolayFilters::posFilterLength <= BUFFER_SIZE && SavGolayFilters::speedFilterLength <= BUFFER_SIZE,
+              "adcBuffer must hold at least one filter window");
 
 enum PrintMode {
   PRINT_NONE,
@@ -26,9 +40,11 @@ class KeyHammer
     // a pointer to a function that will return the position of the key
     // see here: https://forum.arduino.cc/t/function-as-a-parameter-in-class-object-function-pointer-in-library/461967/7
     int(*adcFnPtr)(void);
+    // conversion time of the value the last adc function call returned, see setSampleClock
+    static uint32_t (*sampleClock)(void);
     // a circular buffer to store the last n adc values
     CircularBuffer<int, BUFFER_SIZE> adcBuffer;
-    CircularBuffer<float, BUFFER_SIZE> hammerPositionBuffer;
+    CircularBuffer<SimMath::position_t, BUFFER_SIZE> hammerPositionBuffer;
     CircularBuffer<int, BUFFER_SIZE> elapsedUSBuffer;
     CircularBuffer<int, BUFFER_SIZE> iterationBuffer;
 
@@ -41,82 +57,122 @@ class KeyHammer
     MidiSender* midiSender;
     int adcValKeyDown;
     int adcValKeyUp;
-    float keyPosition;
-    // key and hammer speeds are measured in adc bits per microsecond
-    float keySpeed;
+    // positions are in adc bits, key and hammer speeds are measured in adc bits per microsecond
+    // (float, or fixed point if USE_FIXED_POINT is defined, see SimMath.h)
+    SimMath::position_t keyPosition;
+    SimMath::speed_t keySpeed;
   private:
     int noteOnThreshold;
     // threshold for key to trigger noteoff
     int noteOffThreshold;
     // threshold for key to reset
     int keyResetThreshold;
+    // raw adc level marking the start of a press, for latency measurement (see LatencyTracker.h)
+    int onsetLevel;
+    bool aboveOnsetLevel = false;
+
+    // idle fast path: a key whose raw adc value stays within restBand of adcValKeyUp, with no note
+    // sounding and the hammer resting on it, only has its samples pushed (see updateIdle)
+    int restBand;
+    // consecutive samples inside the rest band
+    int inBandCount = 0;
+    bool idle = false;
+    bool updateIdle();
     int sensorMin;
     int sensorMax;
     
     int rawADC;
-    int lastKeyPosition;
+    SimMath::position_t lastKeyPosition;
+    // sample supplied with step (e.g. read by ScanScheduler), used instead of calling adcFnPtr
+    int suppliedSample;
+    // and the time it was converted
+    uint32_t suppliedSampleUS;
+    bool hasSuppliedSample = false;
+    // scans skipped (see skip) since the last sample, filled in when the next sample arrives
+    int skippedSamples = 0;
+    void pushSample(int sample);
 
-    float hammerPosition;
-    float hammerSpeed;
+    SimMath::position_t hammerPosition;
+    SimMath::speed_t hammerSpeed;
     float hammer_travel;
     float maxHammerSpeed_m_s;
-    float gravity;
+    SimMath::gravity_t gravity;
     // scale gravity applied to hammer, e.g. 0.1 will be 10% of 'normal' gravity
     float gravityScaler = 0.5;
 
     bool noteOn;
     bool keyArmed;
-    float velocity;
+    SimMath::speed_t velocity;
     int velocityIndex;
 
     // used to put hammer speed on an appropriate scale for indexing into velocityMap
-    float hammerSpeedScaler;
+    SimMath::scaler_t hammerSpeedScaler;
+    // converts speed filter output to speed per microsecond
+    SimMath::SpeedScaler speedScaler;
 
     // track number of simulation iterations
     int iteration = 0;
 
-    bool bufferPrinted = false;
-    float lastNoteOnHammerSpeed;
+    // cleared by each note on, so a key that hasn't played yet has nothing to dump
+    bool bufferPrinted = true;
+    SimMath::speed_t lastNoteOnHammerSpeed;
     int lastNoteOnVelocity = -1;
     int noteCount = 0;
 
     // whether or not to print note on/offs
     PrintMode printMode;
     
-    // fn to scale the weights of a filter so they sum to 1
-    void scaleFilterWeights(float* filter, size_t N);
+    // polyorder 1 sav golay filters are least squares line fits, which can be updated in constant
+    // time per sample rather than applying the filters to adcBuffer (see RunningLinearFit.h)
+    RunningLinearFit posFit{SavGolayFilters::posFilterLength};
+    RunningLinearFit speedFit{SavGolayFilters::speedFilterLength};
     // fn to apply a filter to the most recent samples in a circular buffer
     template <typename T, size_t bufferLength>
-    float KeyHammer::applyFilter(CircularBuffer<T, bufferLength>& buffer, const float* filter, size_t filterLength);
+    SimMath::filter_acc_t applyFilter(CircularBuffer<T, bufferLength>& buffer, const SimMath::coeff_t* filter, size_t filterLength);
 
     // calibration related
+    // samples needed in the down stage for the key down value to be updated
     int c_sample_n = 100;
-    float c_reservoir[100];
+    // median/std of the samples in the current stage, updated as they come in
+    StreamingStats c_stats;
     int c_sample_t;
     bool calibrating = false;
     CalibMode c_mode;
     int c_start;
     int c_up_sample_med;
-    float c_up_sample_std;
+    float c_up_sample_std = 0;
     int c_down_sample_med;
     float c_down_sample_std;
 
     bool updatedKeyDownThreshold = false;
 
-    elapsedMillis c_elapsedMS;
+    // time calibration (or the current calibration stage) started
+    uint32_t c_startUS = 0;
     void stepCalibration();
     void calibrationSample();
     void updateADCParams();
+    void readSample();
+    void updateKeyPosition();
     void updateKeySpeed();
     void updateHammer();
     void checkNoteOn();
     void checkNoteOff();
     void stepKey();
-    void printBuffers();
+    void dumpBuffers();
     float convert_m_s2bits_us(float m_s);
     float convert_bits_us2m_s(float bits_us);
     
   protected:
+    // timestamps, in microseconds, from the scan clock (see ScanClock.h)
+    // time of the current sample (its conversion, see setSampleClock, or else the current scan)
+    uint32_t nowUS = 0;
+    // time of the previous sample
+    uint32_t lastStepUS = 0;
+    // time of the last note on
+    uint32_t noteOnUS = 0;
+    // time the hammer passed noteOnThreshold
+    uint32_t noteOnThresholdUS = 0;
+
     void updateElapsed();
     void updateKey();
     virtual void stepHammer();
@@ -124,7 +180,21 @@ class KeyHammer
 
   public:
     KeyHammer(int(*adcFnPtr)(void), MidiSender* midiSender,int pitch, int adcValKeyDown, int adcValKeyUp, float hammer_travel, float maxHammerSpeed_m_s);
-    void step();
+    // step the simulation, with nowUS the time of the current scan (see ScanClock.h)
+    void step(uint32_t nowUS);
+    // step with a sample that has already been read (the value adcFnPtr would have returned), at the
+    // time it was converted (or the time of the scan, if not given)
+    void step(uint32_t nowUS, int sample);
+    void step(uint32_t nowUS, int sample, uint32_t sampleUS);
+    // function returning the conversion time of the value the last adc function call returned (e.g.
+    // DualAdcManager::getConversionUS), shared by all keys. Samples are then timed by when they were
+    // converted rather than when the scan started, so elapsed times are the true sample intervals
+    // (keys sharing a conversion get the same time). NULL (the default) times samples by the scan
+    static void setSampleClock(uint32_t (*sampleClock)(void)) { KeyHammer::sampleClock = sampleClock; }
+    static uint32_t (*getSampleClock())(void) { return sampleClock; }
+    // the key was not sampled this scan (see ScanScheduler). The next sample is joined to the last
+    // by a straight line, so the filters still see one sample per scan
+    void skip();
     // operation mode switches between operation as a hammer simulation key, a key, or a pedal
     int getAdcValue(void);
     // generateVelocityMap is used to fill values in for a blank velocity map.
@@ -137,11 +207,6 @@ class KeyHammer
     int controlNumber;
     void toggleCalibration();
 
-    elapsedMicros elapsedUS;
-    // for keeping track of time since last note on
-    elapsedMicros noteOnElapsedUS;
-    // for keeping track of time since noteOnThreshold passed by hammer
-    elapsedMicros noteOnThresholdElapsedUS;
     // to check if we have generated a note on since the last time the hammer passed the noteOnThreshold
     bool noteOnThresholdPassed = false;
 
@@ -154,12 +219,31 @@ class KeyHammer
     // keep track of n samples contributing to the mean key strike speed, enabling iterative update
     int meanStrikeKeySpeedSamples = 0;
 
-    float getKeyPosition() const { return keyPosition; }
-    float getKeySpeed() const { return keySpeed; }
-    float getHammerPosition() const { return hammerPosition; }
-    float getHammerSpeed() const { return hammerSpeed; }
+    float getKeyPosition() const { return SimMath::positionToFloat(keyPosition); }
+    float getKeySpeed() const { return SimMath::speedToFloat(keySpeed); }
+    float getHammerPosition() const { return SimMath::positionToFloat(hammerPosition); }
+    float getHammerSpeed() const { return SimMath::speedToFloat(hammerSpeed); }
     int getRawADC() const { return rawADC; }
     int getElapsedUS() const { return elapsedUSBuffer.last(); }
+    // simulation parameters, derived from adcValKeyUp/adcValKeyDown by updateADCParams
+    // (used by KeyBank, which keeps its own copies of these in contiguous arrays)
+    int getNoteOnThreshold() const { return noteOnThreshold; }
+    int getNoteOffThreshold() const { return noteOffThreshold; }
+    int getKeyResetThreshold() const { return keyResetThreshold; }
+    int getOnsetLevel() const { return onsetLevel; }
+    int getRestBand() const { return restBand; }
+    bool isIdle() const { return idle && !calibrating; }
+    float getGravity() const { return SimMath::gravityToFloat(gravity); }
+    float getHammerSpeedScaler() const { return SimMath::scalerToFloat(hammerSpeedScaler); }
+    int(*getAdcFn())(void) { return adcFnPtr; }
+    MidiSender* getMidiSender() const { return midiSender; }
+    PrintMode getPrintMode() const { return printMode; }
+    bool isCalibrating() const { return calibrating; }
+    // resting median and standard deviation from the UP stage of the last calibration
+    int getCalibrationUpMedian() const { return c_up_sample_med; }
+    float getCalibrationUpStd() const { return c_up_sample_std; }
+    bool isNoteOn() const { return noteOn; }
+
     
     void setPrintMode(PrintMode mode) { printMode = mode; }
     void printKeyParams(); // includes calibration results
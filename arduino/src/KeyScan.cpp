@@ -0,0 +1,114 @@
+#include "KeyScan.h"
+#include "BufferDump.h"
+#include "LatencyTracker.h"
+#include "MidiQueue.h"
+#include "Profiler.h"
+
+KeyScan::KeyScan() {
+    _keys = NULL;
+    _nKeys = 0;
+    _pedals = NULL;
+    _nPedals = 0;
+    _midiSender = NULL;
+    _bank = NULL;
+    _scheduler = NULL;
+    _plan = NULL;
+    _adc = NULL;
+    _settleDelayUS = 0;
+}
+
+void KeyScan::begin(KeyHammer* keys, int nKeys, Pedal* pedals, int nPedals, MidiSender* midiSender) {
+    _keys = keys;
+    _nKeys = nKeys;
+    _pedals = pedals;
+    _nPedals = nPedals;
+    _midiSender = midiSender;
+}
+
+void KeyScan::setPlan(ScanPlan* plan, DualAdcManager* adc, int settleDelayUS) {
+    _plan = plan;
+    _adc = adc;
+    _settleDelayUS = settleDelayUS;
+}
+
+void KeyScan::start() {
+    _midiSender->beginBatch();
+    BufferDump::startScan();
+}
+
+void KeyScan::step(uint32_t nowUS) {
+    stepKeys(nowUS);
+    stepPedals(nowUS);
+}
+
+void KeyScan::stepKeys(uint32_t nowUS) {
+    if (_plan) {
+        if (_bank) {
+            _plan->read(_adc, _settleDelayUS);
+            _bank->step(nowUS, _plan->getValues(), NULL, _plan->getSampleTimes());
+        } else {
+            // each key is stepped while the next conversion runs
+            KeyHammer* keys = _keys;
+            _plan->read(_adc, _settleDelayUS, [keys, nowUS](int key, int value, uint32_t sampleUS) {
+                keys[key].step(nowUS, value, sampleUS);
+            });
+        }
+        return;
+    }
+    if (_scheduler) {
+        if (_bank) {
+            KeyBank* bank = _bank;
+            _scheduler->scan([bank](int i) { return bank->isIdle(i); });
+            _bank->step(nowUS, _scheduler->getSamples(), _scheduler->getSampledMask(), _scheduler->getSampleTimes());
+        } else {
+            KeyHammer* keys = _keys;
+            _scheduler->scan([keys](int i) { return keys[i].isIdle(); });
+            for (int i = 0; i < _nKeys; i++) {
+                if (_scheduler->isSampled(i)) {
+                    _keys[i].step(nowUS, _scheduler->getSample(i), _scheduler->getSampleUS(i));
+                } else {
+                    _keys[i].skip();
+                }
+            }
+        }
+        return;
+    }
+    if (_bank) {
+        _bank->step(nowUS);
+    } else {
+        for (int i = 0; i < _nKeys; i++) {
+            _keys[i].step(nowUS);
+        }
+    }
+}
+
+void KeyScan::stepPedals(uint32_t nowUS) {
+    for (int i = 0; i < _nPedals; i++) {
+        if (!_scheduler) {
+            _pedals[i].step(nowUS);
+        } else if (_scheduler->isPedalSampled(i)) {
+            _pedals[i].step(nowUS, _scheduler->getPedalSample(i));
+        } else {
+            _pedals[i].skip();
+        }
+    }
+}
+
+void KeyScan::finish() {
+    PROF_SCOPE(PROF_MIDI);
+    MIDI_DRAIN();
+    _midiSender->flushBatch();
+    LAT_FLUSHED(micros());
+}
+
+void KeyScan::loadParams(int i) {
+    if (_bank) {
+        _bank->loadParams(i);
+    }
+}
+
+void KeyScan::loadParams() {
+    if (_bank) {
+        _bank->loadParams();
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "KeyHammer.h"
+#include "KeyBank.h"
+#include "Pedal.h"
+#include "DualAdcManager.h"
+#include "ScanScheduler.h"
+#include "ScanPlan.h"
+#include "MidiSender.h"
+
+/**
+ * @brief One scan of every key and pedal: read them, step the simulation, and send the midi messages
+ *
+ * The sketch's loop and host_sim both scan through this, so the host runs exactly the wiring the
+ * firmware does. Keys are read and stepped by whichever of these is set, in this order:
+ * - a ScanPlan (setPlan): every key read in plan order, stepped by the bank, or each key stepped by
+ *   its KeyHammer while the next conversion runs
+ * - a ScanScheduler (setScheduler): moving keys read every scan, resting keys and pedals every
+ *   SCAN_SLOW_DIVIDER scans, stepped by the bank or by each KeyHammer
+ * - otherwise each key's adc function, stepped by the bank or by each KeyHammer
+ * The sketch sets them from config.h (USE_SCAN_PLAN, USE_SCAN_SCHEDULER, USE_KEY_BANK); host_sim
+ * from its command line.
+ *
+ * The state of each key (e.g. for telemetry, traces and the DriftTracker) comes from the bank if
+ * there is one, otherwise from the key.
+ */
+class KeyScan {
+public:
+    KeyScan();
+
+    /**
+     * @brief Scan an array of keys and pedals, sending through their midi senders
+     *
+     * @param midiSender The sender whose batch holds each scan's messages (see MidiSender::beginBatch)
+     */
+    void begin(KeyHammer* keys, int nKeys, Pedal* pedals, int nPedals, MidiSender* midiSender);
+
+    // step keys with a KeyBank (begun on the same keys), NULL to step each KeyHammer
+    void setBank(KeyBank* bank) { _bank = bank; }
+    // read keys with a ScanScheduler (begun on the same keys and pedals), NULL to read every key
+    void setScheduler(ScanScheduler* scheduler) { _scheduler = scheduler; }
+    // read keys in the order of a ScanPlan (built from the same keys), NULL to use their adc functions
+    void setPlan(ScanPlan* plan, DualAdcManager* adc, int settleDelayUS);
+
+    // start a scan: every midi message until finish goes out in one usb transfer
+    void start();
+    /**
+     * @brief Read and step every key and pedal
+     *
+     * @param nowUS Time of the current scan (see ScanClock.h)
+     */
+    void step(uint32_t nowUS);
+    // hand the midi messages queued during the scan to their senders, and send them
+    void finish();
+
+    KeyBank* getBank() const { return _bank; }
+    int getRawADC(int i) const { return _bank ? _bank->getRawADC(i) : _keys[i].getRawADC(); }
+    float getKeyPosition(int i) const { return _bank ? _bank->getKeyPosition(i) : _keys[i].getKeyPosition(); }
+    float getKeySpeed(int i) const { return _bank ? _bank->getKeySpeed(i) : _keys[i].getKeySpeed(); }
+    float getHammerPosition(int i) const { return _bank ? _bank->getHammerPosition(i) : _keys[i].getHammerPosition(); }
+    float getHammerSpeed(int i) const { return _bank ? _bank->getHammerSpeed(i) : _keys[i].getHammerSpeed(); }
+    int getElapsedUS(int i) const { return _bank ? _bank->getElapsedUS(i) : _keys[i].getElapsedUS(); }
+    bool isNoteOn(int i) const { return _bank ? _bank->isNoteOn(i) : _keys[i].isNoteOn(); }
+    bool isIdle(int i) const { return _bank ? _bank->isIdle(i) : _keys[i].isIdle(); }
+
+    // a key's parameters changed (e.g. calibration or drift), so the bank picks them up
+    void loadParams(int i);
+    void loadParams();
+
+private:
+    KeyHammer* _keys;
+    int _nKeys;
+    Pedal* _pedals;
+    int _nPedals;
+    MidiSender* _midiSender;
+    KeyBank* _bank;
+    ScanScheduler* _scheduler;
+    ScanPlan* _plan;
+    DualAdcManager* _adc;
+    int _settleDelayUS;
+
+    void stepKeys(uint32_t nowUS);
+    void stepPedals(uint32_t nowUS);
+};
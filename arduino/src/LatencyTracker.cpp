@@ -0,0 +1,205 @@
+#include "LatencyTracker.h"
+
+#ifdef USE_LATENCY_TRACKER
+
+#include <Arduino.h>
+#include <algorithm>
+
+namespace {
+    const char* segmentNames[LatencyTracker::N_SEGMENTS] = {
+        "onset>threshold",
+        "threshold>sent",
+        "onset>sent"
+    };
+
+    struct KeyLatency {
+        // timestamps of the note on in progress
+        uint32_t onsetUS;
+        uint32_t thresholdUS;
+        bool onsetSeen;
+        bool thresholdSeen;
+        // handed to the midi sender, waiting for the batch to be flushed
+        bool pending;
+        // ring of the most recent note ons
+        uint32_t onsetToThreshold[LatencyTracker::WINDOW];
+        uint32_t thresholdToSent[LatencyTracker::WINDOW];
+        int head;
+        int count;
+    };
+
+    KeyLatency keys[LatencyTracker::N_KEYS];
+    uint32_t incompleteCount = 0;
+    // keys with a pending note on
+    int pendingCount = 0;
+    // scratch space for sorting the windows of all keys
+    uint32_t sortBuffer[LatencyTracker::N_KEYS * LatencyTracker::WINDOW];
+
+    bool validPitch(int pitch) {
+        return (pitch >= 0) && (pitch < LatencyTracker::N_KEYS);
+    }
+
+    // nearest rank percentile of a sorted array
+    uint32_t percentile(const uint32_t* sorted, int n, float p) {
+        int rank = (int)ceilf(p * n);
+        return sorted[constrain(rank - 1, 0, n - 1)];
+    }
+
+    // copy the window of a key into out, returns the number of values copied
+    int copyWindow(int pitch, LatencyTracker::Segment segment, uint32_t* out) {
+        int n = LatencyTracker::count(pitch);
+        for (int i = 0; i < n; i++) {
+            out[i] = LatencyTracker::latency(pitch, i, segment);
+        }
+        return n;
+    }
+}
+
+namespace LatencyTracker {
+
+void reset() {
+    for (int k = 0; k < N_KEYS; k++) {
+        keys[k] = KeyLatency();
+    }
+    incompleteCount = 0;
+    pendingCount = 0;
+}
+
+void onset(int pitch, uint32_t us) {
+    if (validPitch(pitch)) {
+        keys[pitch].onsetUS = us;
+        keys[pitch].onsetSeen = true;
+    }
+}
+
+void threshold(int pitch, uint32_t us) {
+    if (validPitch(pitch)) {
+        keys[pitch].thresholdUS = us;
+        keys[pitch].thresholdSeen = true;
+    }
+}
+
+void pending(int pitch) {
+    if (validPitch(pitch) && !keys[pitch].pending) {
+        keys[pitch].pending = true;
+        pendingCount++;
+    }
+}
+
+void flushed(uint32_t us) {
+    for (int k = 0; (k < N_KEYS) && (pendingCount > 0); k++) {
+        if (keys[k].pending) {
+            keys[k].pending = false;
+            pendingCount--;
+            sent(k, us);
+        }
+    }
+}
+
+void sent(int pitch, uint32_t us) {
+    if (!validPitch(pitch)) {
+        return;
+    }
+    KeyLatency& key = keys[pitch];
+    if (key.onsetSeen && key.thresholdSeen) {
+        // the onset can only be after the threshold if the key was pressed again while the hammer
+        // was still past the threshold, in which case there is no onset -> threshold latency
+        uint32_t onsetUS = ((int32_t)(key.thresholdUS - key.onsetUS) < 0) ? key.thresholdUS : key.onsetUS;
+        key.onsetToThreshold[key.head] = key.thresholdUS - onsetUS;
+        key.thresholdToSent[key.head] = us - key.thresholdUS;
+        key.head = (key.head + 1) % WINDOW;
+        if (key.count < WINDOW) {
+            key.count++;
+        }
+    } else {
+        incompleteCount++;
+    }
+    key.onsetSeen = false;
+    key.thresholdSeen = false;
+}
+
+int count(int pitch) {
+    return validPitch(pitch) ? keys[pitch].count : 0;
+}
+
+uint32_t latency(int pitch, int i, Segment segment) {
+    const KeyLatency& key = keys[pitch];
+    int index = (key.head - 1 - i + WINDOW) % WINDOW;
+    switch (segment) {
+        case ONSET_TO_THRESHOLD:
+            return key.onsetToThreshold[index];
+        case THRESHOLD_TO_SENT:
+            return key.thresholdToSent[index];
+        default:
+            return key.onsetToThreshold[index] + key.thresholdToSent[index];
+    }
+}
+
+uint32_t incomplete() {
+    return incompleteCount;
+}
+
+Summary summarize(int pitch, Segment segment) {
+    Summary summary = {};
+    int n = 0;
+    if (pitch < 0) {
+        for (int k = 0; k < N_KEYS; k++) {
+            n += copyWindow(k, segment, sortBuffer + n);
+        }
+    } else if (validPitch(pitch)) {
+        n = copyWindow(pitch, segment, sortBuffer);
+    }
+    if (n == 0) {
+        return summary;
+    }
+    std::sort(sortBuffer, sortBuffer + n);
+    summary.count = n;
+    summary.min = sortBuffer[0];
+    summary.p50 = percentile(sortBuffer, n, 0.5f);
+    summary.p90 = percentile(sortBuffer, n, 0.9f);
+    summary.p99 = percentile(sortBuffer, n, 0.99f);
+    summary.max = sortBuffer[n - 1];
+    return summary;
+}
+
+void print() {
+    Serial.printf("-- LATENCY (us, last %d note ons per key) --\n", WINDOW);
+    Serial.println("segment: count, min, p50, p90, p99, max");
+    for (int s = 0; s < N_SEGMENTS; s++) {
+        Summary summary = summarize(-1, (Segment)s);
+        Serial.printf("%s: %d, %lu, %lu, %lu, %lu, %lu\n", segmentNames[s], summary.count,
+                      (unsigned long)summary.min, (unsigned long)summary.p50, (unsigned long)summary.p90,
+                      (unsigned long)summary.p99, (unsigned long)summary.max);
+    }
+    Serial.printf("incomplete note ons: %lu\n", (unsigned long)incompleteCount);
+    Serial.println("-- PER KEY (p50 / max) --");
+    for (int k = 0; k < N_KEYS; k++) {
+        if (keys[k].count == 0) {
+            continue;
+        }
+        Serial.printf("pitch %d: %d", k, keys[k].count);
+        for (int s = 0; s < N_SEGMENTS; s++) {
+            Summary summary = summarize(k, (Segment)s);
+            Serial.printf(" %s %lu/%lu", segmentNames[s], (unsigned long)summary.p50, (unsigned long)summary.max);
+        }
+        Serial.println();
+    }
+    Serial.flush();
+}
+
+void printKey(int pitch) {
+    if (!validPitch(pitch)) {
+        Serial.println("invalid pitch");
+        return;
+    }
+    Serial.printf("-- LATENCY pitch %d (us, most recent first) --\n", pitch);
+    Serial.printf("%s, %s, %s\n", segmentNames[ONSET_TO_THRESHOLD], segmentNames[THRESHOLD_TO_SENT], segmentNames[ONSET_TO_SENT]);
+    for (int i = 0; i < count(pitch); i++) {
+        Serial.printf("%lu, %lu, %lu\n", (unsigned long)latency(pitch, i, ONSET_TO_THRESHOLD),
+                      (unsigned long)latency(pitch, i, THRESHOLD_TO_SENT), (unsigned long)latency(pitch, i, ONSET_TO_SENT));
+    }
+    Serial.flush();
+}
+
+} // namespace LatencyTracker
+
+#endif
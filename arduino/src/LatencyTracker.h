@@ -0,0 +1,86 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+#ifdef USE_LATENCY_TRACKER
+
+/**
+ * @brief Key to midi latency of each note on, split into stages
+ *
+ * For every note on, three timestamps (microseconds) are recorded against the key's pitch:
+ * - onset: the raw ADC value first crossed the key's onset level (LATENCY_ONSET_FRACTION of the
+ *   way from adcValKeyUp to adcValKeyDown), i.e. the player started pressing the key
+ * - threshold: the hammer first passed noteOnThreshold
+ * - sent: the note on was handed to its midi sender (pending), and the batch it was in was sent to
+ *   USB (MidiSender::flushBatch), i.e. it left the scan
+ *
+ * The last LATENCY_WINDOW note ons of each key are kept, giving rolling latencies for
+ * onset -> threshold (filter lag and hammer flight), threshold -> sent (the note on deferral and
+ * the rest of the scan), and onset -> sent (the total).
+ *
+ * Record with the LAT_* macros below, which compile to nothing unless USE_LATENCY_TRACKER is
+ * defined (see config.h).
+ */
+namespace LatencyTracker {
+    const int N_KEYS = 128;
+    const int WINDOW = LATENCY_WINDOW;
+
+    enum Segment {
+        ONSET_TO_THRESHOLD,
+        THRESHOLD_TO_SENT,
+        ONSET_TO_SENT,
+        N_SEGMENTS
+    };
+
+    // summary of the latencies in a window, in microseconds
+    struct Summary {
+        int count;
+        uint32_t min;
+        uint32_t p50;
+        uint32_t p90;
+        uint32_t p99;
+        uint32_t max;
+    };
+
+    void reset();
+
+    // raw ADC crossed the onset level (only the latest crossing before a note on is kept)
+    void onset(int pitch, uint32_t us);
+    // hammer passed noteOnThreshold
+    void threshold(int pitch, uint32_t us);
+    // note on sent to USB, completes the record if onset and threshold were seen
+    void sent(int pitch, uint32_t us);
+    // note on handed to the midi sender, sent when the batch is flushed
+    void pending(int pitch);
+    // the batch was flushed: every pending note on is sent
+    void flushed(uint32_t us);
+
+    // number of note ons in the window for a key, and the latency of the i-th most recent one
+    int count(int pitch);
+    uint32_t latency(int pitch, int i, Segment segment);
+    // note ons that were sent without an onset or threshold timestamp (so not recorded)
+    uint32_t incomplete();
+
+    // summary of one key's window, or of the windows of all keys with pitch -1
+    Summary summarize(int pitch, Segment segment);
+
+    // print a summary for all keys, then each key with any note ons, over serial
+    void print();
+    // print the individual note ons in one key's window
+    void printKey(int pitch);
+}
+
+#define LAT_ONSET(pitch, us) LatencyTracker::onset(pitch, us)
+#define LAT_THRESHOLD(pitch, us) LatencyTracker::threshold(pitch, us)
+#define LAT_PENDING(pitch) LatencyTracker::pending(pitch)
+#define LAT_FLUSHED(us) LatencyTracker::flushed(us)
+
+#else
+
+#define LAT_ONSET(pitch, us)
+#define LAT_THRESHOLD(pitch, us)
+#define LAT_PENDING(pitch)
+#define LAT_FLUSHED(us)
+
+#endif
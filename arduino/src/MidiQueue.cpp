@@ -0,0 +1,97 @@
+#include "MidiQueue.h"
+
+#ifdef USE_MIDI_QUEUE
+
+#include <Arduino.h>
+#include "Histogram.h"
+
+namespace {
+    MidiQueue::Event events[MidiQueue::SIZE];
+    // free running indices, masked into events: head is only written by push, tail only by drain
+    volatile uint32_t head = 0;
+    volatile uint32_t tail = 0;
+
+    // written by push
+    volatile uint32_t droppedCount = 0;
+    volatile uint32_t maxDepth = 0;
+    // written by drain: messages waiting at each drain, and the time from sample to sender
+    Histogram depthHistogram;
+    Histogram waitHistogram;
+}
+
+namespace MidiQueue {
+
+bool push(MidiSender* sender, Type type, int data1, int data2, int channel, uint32_t us) {
+    uint32_t h = head;
+    uint32_t depth = h - tail;
+    if (depth >= (uint32_t)SIZE) {
+        droppedCount++;
+        return false;
+    }
+    events[h & (SIZE - 1)] = Event{us, sender, type, (uint8_t)data1, (uint8_t)data2, (uint8_t)channel};
+    // the event must be written before drain can see it
+    __sync_synchronize();
+    head = h + 1;
+    if (depth + 1 > maxDepth) {
+        maxDepth = depth + 1;
+    }
+    return true;
+}
+
+int drain() {
+    uint32_t t = tail;
+    uint32_t h = head;
+    // read the events only after seeing the head that published them
+    __sync_synchronize();
+    depthHistogram.add(h - t);
+    uint32_t nowUS = micros();
+    for (; t != h; t++) {
+        const Event& e = events[t & (SIZE - 1)];
+        switch (e.type) {
+            case NOTE_ON:
+                e.sender->sendNoteOn(e.data1, e.data2, e.channel);
+                LAT_PENDING(e.data1);
+                break;
+            case NOTE_OFF:
+                e.sender->sendNoteOff(e.data1, e.data2, e.channel);
+                break;
+            case CONTROL_CHANGE:
+                e.sender->sendControlChange(e.data1, e.data2, e.channel);
+                break;
+        }
+        waitHistogram.add(nowUS - e.us);
+    }
+    int sent = h - tail;
+    // the slots can only be reused once the events have been sent
+    __sync_synchronize();
+    tail = t;
+    return sent;
+}
+
+int depth() {
+    return head - tail;
+}
+
+void reset() {
+    droppedCount = 0;
+    maxDepth = 0;
+    depthHistogram.reset();
+    waitHistogram.reset();
+}
+
+void print() {
+    const RunningStats& depth = depthHistogram.stats();
+    const RunningStats& wait = waitHistogram.stats();
+    Serial.printf("-- MIDI QUEUE (%d messages) --\n", SIZE);
+    Serial.printf("sent: %lu, dropped (queue full): %lu\n", (unsigned long)wait.count, (unsigned long)droppedCount);
+    Serial.printf("depth at drain: mean %.2f, p99 %lu, max %lu (max while filling %lu)\n", depth.mean(),
+                  (unsigned long)depthHistogram.percentile(0.99), (unsigned long)depth.max, (unsigned long)maxDepth);
+    if (wait.count > 0) {
+        Serial.printf("sample to sender (us): min %lu, mean %.1f, p99 %lu, max %lu\n", (unsigned long)wait.min, wait.mean(),
+                      (unsigned long)waitHistogram.percentile(0.99), (unsigned long)wait.max);
+    }
+}
+
+}
+
+#endif
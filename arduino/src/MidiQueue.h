@@ -0,0 +1,73 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "MidiSender.h"
+#include "LatencyTracker.h"
+
+#ifdef USE_MIDI_QUEUE
+
+static_assert((MIDI_QUEUE_SIZE & (MIDI_QUEUE_SIZE - 1)) == 0, "MIDI_QUEUE_SIZE must be a power of two");
+
+/**
+ * @brief Fixed size queue of midi messages, between the simulation and the midi senders
+ *
+ * Sending a message (e.g. usbMIDI.sendNoteOn) from inside the scan stalls the scan when USB is busy,
+ * so a chord makes the scan period jump. Instead the simulation only pushes each message, with the
+ * time of the sample that caused it and the sender it is for, and drain hands them all to their
+ * senders once per scan (before MidiSender::loopEnd flushes them to USB in one go).
+ *
+ * Lock free for one producer and one consumer: push only writes the head, drain only writes the tail,
+ * so drain can also run in an interrupt or on the other core. When the queue is full the message is
+ * dropped and counted (see print).
+ *
+ * Send with the MIDI_* macros below, which send straight away unless USE_MIDI_QUEUE is defined (see
+ * config.h). Note ons are recorded as pending (LAT_PENDING) when they are handed to their sender, and
+ * as sent once the batch is flushed (LAT_FLUSHED, after MidiSender::flushBatch).
+ */
+namespace MidiQueue {
+    const int SIZE = MIDI_QUEUE_SIZE;
+
+    enum Type : uint8_t {
+        NOTE_ON,
+        NOTE_OFF,
+        CONTROL_CHANGE
+    };
+
+    struct Event {
+        // time of the sample the message came from, in microseconds
+        uint32_t us;
+        MidiSender* sender;
+        Type type;
+        // pitch, or control number
+        uint8_t data1;
+        // velocity, or control value
+        uint8_t data2;
+        uint8_t channel;
+    };
+
+    // producer: queue a message, false if the queue was full (and the message dropped)
+    bool push(MidiSender* sender, Type type, int data1, int data2, int channel, uint32_t us);
+    // consumer: hand every queued message to its sender, returns the number sent
+    int drain();
+
+    // messages waiting to be sent
+    int depth();
+    void reset();
+    // print messages sent and dropped, the queue depth and the time messages waited, over serial
+    void print();
+}
+
+#define MIDI_NOTE_ON(sender, pitch, velocity, channel, us) MidiQueue::push(sender, MidiQueue::NOTE_ON, pitch, velocity, channel, us)
+#define MIDI_NOTE_OFF(sender, pitch, velocity, channel, us) MidiQueue::push(sender, MidiQueue::NOTE_OFF, pitch, velocity, channel, us)
+#define MIDI_CONTROL_CHANGE(sender, control, value, channel, us) MidiQueue::push(sender, MidiQueue::CONTROL_CHANGE, control, value, channel, us)
+#define MIDI_DRAIN() MidiQueue::drain()
+
+#else
+
+#define MIDI_NOTE_ON(sender, pitch, velocity, channel, us) do { (sender)->sendNoteOn(pitch, velocity, channel); LAT_PENDING(pitch); } while (0)
+#define MIDI_NOTE_OFF(sender, pitch, velocity, channel, us) (sender)->sendNoteOff(pitch, velocity, channel)
+#define MIDI_CONTROL_CHANGE(sender, control, value, channel, us) (sender)->sendControlChange(control, value, channel)
+#define MIDI_DRAIN()
+
+#endif
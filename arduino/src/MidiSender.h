@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.h"
+#include <stdint.h>
 
 class MidiSender {
 public:
@@ -9,6 +10,19 @@ public:
     virtual void sendControlChange(int controlNumber, int controlValue, int channel) = 0;
     virtual void initialize() = 0;
     virtual void loopEnd() = 0;
+
+    /**
+     * @brief Start a batch: messages sent from now until flushBatch are collected and go out together
+     *
+     * Used for every message of one scan, so the notes of a chord arrive in the same usb transfer.
+     * Outside a batch each message is sent straight away. Senders that can't batch send straight away
+     * regardless.
+     */
+    virtual void beginBatch() {}
+    // send the messages collected since beginBatch, in as few usb packets as possible, and end the batch
+    virtual void flushBatch() {}
+    // bytes that usb couldn't take in time and were dropped, for senders that count them
+    virtual uint32_t getDroppedBytes() const { return 0; }
     virtual ~MidiSender() = default;
 };
 
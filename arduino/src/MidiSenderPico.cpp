@@ -10,15 +10,27 @@ Adafruit_USBD_MIDI usb_midi;
 MIDI_CREATE_INSTANCE(Adafruit_USBD_MIDI, usb_midi, MIDI);
 
 void MidiSenderPico::sendNoteOn(int pitch, int velocity, int channel) {
-    MIDI.sendNoteOn(pitch, velocity, channel);
+    if (_batching) {
+        append(0x90 | ((channel - 1) & 0x0F), pitch, velocity);
+    } else {
+        MIDI.sendNoteOn(pitch, velocity, channel);
+    }
 }
 
 void MidiSenderPico::sendNoteOff(int pitch, int velocity, int channel) {
-    MIDI.sendNoteOff(pitch, velocity, channel);
+    if (_batching) {
+        append(0x80 | ((channel - 1) & 0x0F), pitch, velocity);
+    } else {
+        MIDI.sendNoteOff(pitch, velocity, channel);
+    }
 }
 
 void MidiSenderPico::sendControlChange(int controlNumber, int controlValue, int channel) {
-    MIDI.sendControlChange(controlNumber, controlValue, channel);
+    if (_batching) {
+        append(0xB0 | ((channel - 1) & 0x0F), controlNumber, controlValue);
+    } else {
+        MIDI.sendControlChange(controlNumber, controlValue, channel);
+    }
 }
 
 void MidiSenderPico::initialize() {
@@ -35,4 +47,49 @@ void MidiSenderPico::initialize() {
 void MidiSenderPico::loopEnd() {
     MIDI.read();
 }
+
+void MidiSenderPico::beginBatch() {
+    _batching = true;
+    _batchLength = 0;
+}
+
+void MidiSenderPico::append(uint8_t status, uint8_t data1, uint8_t data2) {
+    if (_batchLength + 3 > batchBytes) {
+        // a full packet, send it and start the next
+        write(_batch, _batchLength);
+        _batchLength = 0;
+    }
+    _batch[_batchLength++] = status;
+    _batch[_batchLength++] = data1 & 0x7F;
+    _batch[_batchLength++] = data2 & 0x7F;
+}
+
+// tinyusb only takes what fits in its fifo, which empties as the host collects each transfer (once
+// per usb frame), so keep writing the rest until it's all taken, or give up and count what's left
+void MidiSenderPico::write(const uint8_t* bytes, int length) {
+    uint32_t startUS = micros();
+    int written = 0;
+    while (written < length) {
+        written += tud_midi_stream_write(0, bytes + written, length - written);
+        if (written < length) {
+            if (!tud_mounted() || (micros() - startUS >= MIDI_WRITE_TIMEOUT_US)) {
+                _droppedBytes += length - written;
+                return;
+            }
+            // lets tinyusb finish the transfer in progress
+            yield();
+        }
+    }
+}
+
+// the MIDI library writes each message to tinyusb on its own, and tinyusb starts a transfer after
+// each write. Written in one go, tinyusb packs the whole batch into 4 byte usb-midi events in its
+// fifo and starts a single transfer
+void MidiSenderPico::flushBatch() {
+    if (_batchLength > 0) {
+        write(_batch, _batchLength);
+    }
+    _batching = false;
+    _batchLength = 0;
+}
 #endif
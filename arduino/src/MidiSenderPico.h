@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include "MidiSender.h"
 
 class MidiSenderPico : public MidiSender {
@@ -9,4 +10,20 @@ public:
     void sendControlChange(int controlNumber, int controlValue, int channel) override;
     void initialize() override;
     void loopEnd() override;
+    void beginBatch() override;
+    void flushBatch() override;
+    uint32_t getDroppedBytes() const override { return _droppedBytes; }
+
+private:
+    // add a message to the batch
+    void append(uint8_t status, uint8_t data1, uint8_t data2);
+    // hand bytes to tinyusb, waiting up to MIDI_WRITE_TIMEOUT_US for room in its fifo
+    void write(const uint8_t* bytes, int length);
+
+    // 3 byte messages, one full speed usb-midi packet worth (16 messages, of 4 bytes each)
+    static const int batchBytes = 48;
+    uint8_t _batch[batchBytes];
+    int _batchLength = 0;
+    bool _batching = false;
+    uint32_t _droppedBytes = 0;
 };
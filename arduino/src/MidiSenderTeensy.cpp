@@ -10,15 +10,18 @@
 
 void MidiSenderTeensy::sendNoteOn(int pitch, int velocity, int channel) {
     usbMIDI.sendNoteOn(pitch, velocity, channel);
+    sent();
 }
 
 void MidiSenderTeensy::sendNoteOff(int pitch, int velocity, int channel) {
     usbMIDI.sendNoteOff(pitch, velocity, channel);
+    sent();
 }
 
 //?
 void MidiSenderTeensy::sendControlChange(int controlNumber, int controlValue, int channel) {
     usbMIDI.sendControlChange(controlNumber, controlValue, channel);
+    sent();
 }
 
 void MidiSenderTeensy::initialize() {
@@ -29,4 +32,26 @@ void MidiSenderTeensy::loopEnd() {
     while (usbMIDI.read()) {
     }
 }
+// usbMIDI packs each message into its transmit packet (16 to a full speed packet, 128 high speed),
+// which is only sent when full, on send_now, or after a timeout
+void MidiSenderTeensy::sent() {
+    if (_batching) {
+        _batchCount++;
+    } else {
+        usbMIDI.send_now();
+    }
+}
+
+void MidiSenderTeensy::beginBatch() {
+    _batching = true;
+    _batchCount = 0;
+}
+
+void MidiSenderTeensy::flushBatch() {
+    if (_batchCount > 0) {
+        usbMIDI.send_now();
+    }
+    _batching = false;
+    _batchCount = 0;
+}
 #endif
@@ -10,4 +10,14 @@ public:
     void sendControlChange(int controlNumber, int controlValue, int channel) override;
     void initialize() override;
     void loopEnd() override;
+    void beginBatch() override;
+    void flushBatch() override;
+
+private:
+    // send now, unless batching
+    void sent();
+
+    bool _batching = false;
+    // messages waiting in usbMIDI's transmit packet
+    int _batchCount = 0;
 };
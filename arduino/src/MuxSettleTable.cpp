@@ -0,0 +1,110 @@
+#include "MuxSettleTable.h"
+#include <Arduino.h>
+
+MuxSettleTable::MuxSettleTable() {
+    _nPins = 0;
+    _nMeasured = 0;
+    _maxSettleUS = 0;
+    _conversionUS = 0;
+}
+
+void MuxSettleTable::characterise(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins) {
+    nPins = min(nPins, MAX_SIGNAL_PINS);
+    _nPins = 0;
+    _nMeasured = 0;
+    _maxSettleUS = 0;
+    // measure the raw values
+    adc->clearCrosstalk();
+    // slowest measured transition of each pin, -1 if none could be measured
+    int pinMaxUS[MAX_SIGNAL_PINS];
+    for (int p = 0; p < nPins; p++) {
+        pinMaxUS[p] = -1;
+        for (int from = 0; from < nAddresses; from++) {
+            for (int to = 0; to < nAddresses; to++) {
+                int settleUS = (from == to) ? 0 : measure(adc, pins, nPins, p, from, to);
+                if ((settleUS >= 0) && (from != to)) {
+                    settleUS = min(settleUS + MUX_SETTLE_MARGIN_US, MUX_SETTLE_MAX_US);
+                    pinMaxUS[p] = max(pinMaxUS[p], settleUS);
+                    _maxSettleUS = max(_maxSettleUS, settleUS);
+                    _nMeasured++;
+                }
+                // 0xFF marks a transition to fill in
+                _settleUS[p][from][to] = (settleUS >= 0) ? settleUS : 0xFF;
+            }
+        }
+    }
+    // transitions that couldn't be measured get the slowest of their mux, or of the board
+    int fallbackUS = (_nMeasured > 0) ? _maxSettleUS : MUX_SETTLE_MAX_US;
+    for (int p = 0; p < nPins; p++) {
+        for (int from = 0; from < nAddresses; from++) {
+            for (int to = 0; to < nAddresses; to++) {
+                if (_settleUS[p][from][to] == 0xFF) {
+                    _settleUS[p][from][to] = (pinMaxUS[p] >= 0) ? pinMaxUS[p] : fallbackUS;
+                }
+            }
+        }
+    }
+    _conversionUS = measureConversion(adc);
+    _nPins = nPins;
+    // the muxes have been moved, so nothing cached is valid
+    adc->invalidate();
+}
+
+int MuxSettleTable::measure(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins, int pin, int fromAddr, int toAddr) {
+    // fully settled values at both addresses
+    int fromValue = 0;
+    int toValue = 0;
+    for (int r = 0; r < repeats; r++) {
+        fromValue += ScanPlan::readPin(adc, pins, nPins, pin, fromAddr, MUX_SETTLE_MAX_US);
+        toValue += ScanPlan::readPin(adc, pins, nPins, pin, toAddr, MUX_SETTLE_MAX_US);
+    }
+    fromValue /= repeats;
+    toValue /= repeats;
+    // a transition between similar values settles within tolerance straight away, whatever the mux does
+    if (abs(toValue - fromValue) <= 2 * MUX_SETTLE_TOLERANCE) {
+        return -1;
+    }
+    for (int settleUS = 0; settleUS < MUX_SETTLE_MAX_US; settleUS++) {
+        bool settled = true;
+        for (int r = 0; (r < repeats) && settled; r++) {
+            ScanPlan::readPin(adc, pins, nPins, pin, fromAddr, MUX_SETTLE_MAX_US);
+            int value = ScanPlan::readPin(adc, pins, nPins, pin, toAddr, settleUS);
+            settled = abs(value - toValue) <= MUX_SETTLE_TOLERANCE;
+        }
+        if (settled) {
+            return settleUS;
+        }
+    }
+    return MUX_SETTLE_MAX_US;
+}
+
+int MuxSettleTable::measureConversion(DualAdcManager* adc) {
+    const int conversions = 16;
+    uint32_t startUS = micros();
+    for (int r = 0; r < conversions; r++) {
+        int value0;
+        int value1;
+        adc->startConversion();
+        adc->readConversion(value0, value1);
+    }
+    // rounded down, so that settle times taken off it are never too short
+    return (micros() - startUS) / (conversions * adc->oversampling());
+}
+
+void MuxSettleTable::print() {
+    if (!isCharacterised()) {
+        Serial.println("mux settle times not measured");
+        return;
+    }
+    Serial.printf("-- MUX SETTLE (us, from address down, to address across) --\n");
+    for (int p = 0; p < _nPins; p++) {
+        Serial.printf("signal pin %d\n", p);
+        for (int from = 0; from < nAddresses; from++) {
+            for (int to = 0; to < nAddresses; to++) {
+                Serial.printf("%3d", _settleUS[p][from][to]);
+            }
+            Serial.printf("\n");
+        }
+    }
+    Serial.printf("measured transitions: %d, slowest: %dus, conversion: %dus\n", _nMeasured, _maxSettleUS, _conversionUS);
+}
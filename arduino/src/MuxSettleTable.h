@@ -0,0 +1,68 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "DualAdcManager.h"
+#include "ScanPlan.h"
+
+/**
+ * @brief Settle time each mux needs to move from one address to another, measured on the board
+ *
+ * How long a mux output takes to settle after a change of address depends on the mux, its supply,
+ * the sensors and the length of the cables (see DualAdcManager::updateReadings), so one settle delay
+ * for every read has to cover the worst case. characterise measures each signal pin's mux on its
+ * own, for every pair of addresses: the mux is held at the first address long enough to fully settle,
+ * moved to the second, and read after a growing delay until the value is within MUX_SETTLE_TOLERANCE
+ * of the fully settled value, on every one of MUX_SETTLE_REPEATS tries.
+ *
+ * A transition can only be measured when the two inputs read different values (a resting key looks
+ * much like its neighbours). Those that can't get the slowest measured transition of the same mux, or
+ * of any mux if none of its transitions could be measured. The time of one conversion is measured too,
+ * since a mux moved on while the other bus is converting (see ScanPlan.h) has that long to settle.
+ * ScanPlan::applySettleTable then waits, on each read of a mux that has just changed address, only as
+ * long as the transition needs beyond that.
+ *
+ * Takes a few hundred milliseconds for a full board, with the muxes and ADCs to itself (so not while
+ * the background scanner is running). Keys should be at rest. Clears any crosstalk correction (see
+ * CrosstalkTable::apply).
+ */
+class MuxSettleTable {
+public:
+    MuxSettleTable();
+
+    /**
+     * @brief Measure the settle time of every address transition of every signal pin's mux
+     *
+     * @param pins Bus and ADCs of each signal pin, by signal pin index (as passed to ScanPlan::build)
+     * @param nPins Number of signal pins
+     */
+    void characterise(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins);
+
+    bool isCharacterised() const { return _nPins > 0; }
+    // settle time, in microseconds, for a signal pin's mux to move from one address to another
+    int getSettleUS(int pin, int fromAddr, int toAddr) const { return _settleUS[pin][fromAddr][toAddr]; }
+    // transitions measured (the rest were filled in), and the slowest
+    int getNumMeasured() const { return _nMeasured; }
+    int getMaxSettleUS() const { return _maxSettleUS; }
+    // time of one conversion (rounded down), in microseconds
+    int getConversionUS() const { return _conversionUS; }
+
+    // print the settle time of each transition, one table per signal pin
+    void print();
+
+private:
+    static const int nAddresses = 1 << N_ADDRESS_PINS;
+    // reads at each delay, all of which must be settled
+    static const int repeats = 3;
+
+    uint8_t _settleUS[MAX_SIGNAL_PINS][nAddresses][nAddresses];
+    int _nPins;
+    int _nMeasured;
+    int _maxSettleUS;
+    int _conversionUS;
+
+    // settle time of one transition, -1 if it can't be measured
+    int measure(DualAdcManager* adc, const ScanPlan::Pin* pins, int nPins, int pin, int fromAddr, int toAddr);
+    // time of one conversion, of the pins last read
+    int measureConversion(DualAdcManager* adc);
+};
@@ -13,12 +13,13 @@ void Pedal::processPedalValue() {
     lastControlValue = controlValue;
     
     // Calculate control value based on key position
-    controlValue = (int)((keyPosition - adcValKeyUp) / 
+    controlValue = (int)((getKeyPosition() - adcValKeyUp) / 
                    float(adcValKeyDown - adcValKeyUp) * 127);
     controlValue = constrain(controlValue, 0, 127);
     
     // Send MIDI control change message if value changed
     if (controlValue != lastControlValue) {
-        midiSender->sendControlChange(controlNumber, controlValue, 2);
+        PROF_SCOPE(PROF_MIDI);
+        MIDI_CONTROL_CHANGE(midiSender, controlNumber, controlValue, 2, nowUS);
     }
 }
@@ -27,7 +27,7 @@ public:
           controlNumber(controlNumber), lastControlValue(0), controlValue(0) {
     }
 
-    // Override the step method to implement pedal-specific behavior
+    // Override the stepHammer method to implement pedal-specific behavior
     virtual void stepHammer() override;
 
 private:
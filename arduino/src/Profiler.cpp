@@ -0,0 +1,144 @@
+#include "Profiler.h"
+
+#ifdef USE_PROFILER
+
+#include <Arduino.h>
+#ifdef HOST_BUILD
+#include <chrono>
+#endif
+
+namespace {
+    const char* stageNames[PROF_NUM_STAGES] = {
+        "scan",
+        "adc",
+        "filter",
+        "hammer",
+        "notes",
+        "midi",
+        "serial"
+    };
+
+    Histogram stageHistograms[PROF_NUM_STAGES];
+    RunningStats keyStatsTable[Profiler::N_KEYS][PROF_NUM_STAGES];
+    RunningStats muxGroupStats[Profiler::N_MUX_GROUPS];
+
+    int currentKey = -1;
+    int currentMuxGroup = -1;
+}
+
+namespace Profiler {
+
+void begin() {
+    #if defined(TEENSY) && !defined(HOST_BUILD)
+    // the teensy 4 core normally enables the cycle counter at startup, but make sure
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+    #endif
+    reset();
+}
+
+void reset() {
+    for (int s = 0; s < PROF_NUM_STAGES; s++) {
+        stageHistograms[s].reset();
+        for (int k = 0; k < N_KEYS; k++) {
+            keyStatsTable[k][s].reset();
+        }
+    }
+    for (int g = 0; g < N_MUX_GROUPS; g++) {
+        muxGroupStats[g].reset();
+    }
+}
+
+uint32_t ticks() {
+    #if defined(HOST_BUILD)
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    #elif defined(TEENSY)
+    return ARM_DWT_CYCCNT;
+    #else
+    return micros();
+    #endif
+}
+
+float ticksPerUS() {
+    #if defined(HOST_BUILD)
+    return 1000;
+    #elif defined(TEENSY)
+    return F_CPU_ACTUAL / 1e6f;
+    #else
+    return 1;
+    #endif
+}
+
+void setKey(int key) {
+    currentKey = key;
+}
+
+void setMuxGroup(int group) {
+    currentMuxGroup = group;
+}
+
+void record(ProfStage stage, uint32_t elapsedTicks) {
+    stageHistograms[stage].add(elapsedTicks);
+    if (currentKey >= 0 && currentKey < N_KEYS) {
+        keyStatsTable[currentKey][stage].add(elapsedTicks);
+    }
+    if (stage == PROF_ADC && currentMuxGroup >= 0 && currentMuxGroup < N_MUX_GROUPS) {
+        muxGroupStats[currentMuxGroup].add(elapsedTicks);
+    }
+}
+
+const Histogram& stageHistogram(ProfStage stage) {
+    return stageHistograms[stage];
+}
+
+const RunningStats& keyStats(int key, ProfStage stage) {
+    return keyStatsTable[key][stage];
+}
+
+void print() {
+    float scale = 1 / ticksPerUS();
+    Serial.println("-- PROFILE (us) --");
+    Serial.println("stage: count, min, mean, p99, max");
+    for (int s = 0; s < PROF_NUM_STAGES; s++) {
+        const Histogram& h = stageHistograms[s];
+        const RunningStats& stats = h.stats();
+        if (stats.count == 0) {
+            continue;
+        }
+        Serial.printf("%s: %lu, %.3f, %.3f, %.3f, %.3f\n", stageNames[s], (unsigned long)stats.count,
+                      stats.min * scale, stats.mean() * scale, h.percentile(0.99f) * scale, stats.max * scale);
+    }
+    Serial.println("-- PER KEY (mean / max) --");
+    for (int k = 0; k < N_KEYS; k++) {
+        bool any = false;
+        for (int s = 0; s < PROF_NUM_STAGES; s++) {
+            const RunningStats& stats = keyStatsTable[k][s];
+            if (stats.count == 0) {
+                continue;
+            }
+            if (!any) {
+                Serial.printf("pitch %d:", k);
+                any = true;
+            }
+            Serial.printf(" %s %.3f/%.3f", stageNames[s], stats.mean() * scale, stats.max * scale);
+        }
+        if (any) {
+            Serial.println();
+        }
+    }
+    Serial.println("-- ADC PER MUX GROUP (count, mean / max) --");
+    for (int g = 0; g < N_MUX_GROUPS; g++) {
+        const RunningStats& stats = muxGroupStats[g];
+        if (stats.count == 0) {
+            continue;
+        }
+        Serial.printf("mux %d/%d: %lu, %.3f/%.3f\n", g >> 4, g & 15, (unsigned long)stats.count,
+                      stats.mean() * scale, stats.max * scale);
+    }
+    Serial.flush();
+}
+
+} // namespace Profiler
+
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+
+// Stages of the scan loop that can be profiled
+enum ProfStage {
+    // the whole scan (all keys)
+    PROF_SCAN,
+    // ADC acquisition (DualAdcManager::updateReadings, including the mux settle delay)
+    PROF_ADC,
+    // position / speed filters
+    PROF_FILTER,
+    // hammer update
+    PROF_HAMMER,
+    // note on / off checks (including any midi sends)
+    PROF_NOTES,
+    // handing a midi message to the MidiSender
+    PROF_MIDI,
+    // serial command handling
+    PROF_SERIAL,
+    PROF_NUM_STAGES
+};
+
+#ifdef USE_PROFILER
+
+#include "Histogram.h"
+
+/**
+ * @brief Cycle-count profiler for the scan loop
+ *
+ * Durations are measured in ticks: cpu cycles (the DWT cycle counter) on the teensy, nanoseconds
+ * (steady clock) on the host build, and microseconds elsewhere. Each stage keeps a histogram
+ * (min/mean/p99/max), and also stats per key (by midi pitch) and, for ADC acquisition, per mux group
+ * (pair of mux addresses).
+ *
+ * Instrument code with the PROF_* macros below, which compile to nothing unless USE_PROFILER is
+ * defined (see config.h).
+ */
+namespace Profiler {
+    const int N_KEYS = 128;
+    // one group per (muxAddr0, muxAddr1) pair
+    const int N_MUX_GROUPS = 256;
+
+    void begin();
+    void reset();
+
+    // current time in ticks
+    uint32_t ticks();
+    float ticksPerUS();
+
+    // key (midi pitch) / mux group that following measurements belong to, or -1 for none
+    void setKey(int key);
+    void setMuxGroup(int group);
+
+    void record(ProfStage stage, uint32_t elapsedTicks);
+
+    const Histogram& stageHistogram(ProfStage stage);
+    const RunningStats& keyStats(int key, ProfStage stage);
+
+    // print a summary of all stages, then keys and mux groups with any measurements, over serial
+    void print();
+}
+
+// records the time from construction to destruction against a stage
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfStage stage) : _stage(stage), _start(Profiler::ticks()) {}
+    ~ProfileScope() { Profiler::record(_stage, Profiler::ticks() - _start); }
+
+private:
+    ProfStage _stage;
+    uint32_t _start;
+};
+
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT2(a, b)
+#define PROF_SCOPE(stage) ProfileScope PROF_CONCAT(_profileScope, __LINE__)(stage)
+#define PROF_KEY(key) Profiler::setKey(key)
+#define PROF_MUX_GROUP(group) Profiler::setMuxGroup(group)
+
+#else
+
+#define PROF_SCOPE(stage)
+#define PROF_KEY(key)
+#define PROF_MUX_GROUP(group)
+
+#endif
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stdint.h>
+#include "SimMath.h"
+
+/**
+ * @brief Least squares straight line fit over a sliding window, updated in constant time per sample
+ *
+ * A polyorder 1 Savitzky-Golay filter is a least squares line fit over the window, so the
+ * posFilter/speedFilter kernels (evaluated at the newest sample) are the fitted line's value at the
+ * end of the window and its slope. Instead of a dot product over the whole window, the fit can be
+ * kept up to date from two running sums, with the window indexed 0 (oldest) to n-1 (newest):
+ *   s0 = sum(y_i)
+ *   s1 = sum(i * y_i)
+ * When a sample y_new enters and y_old leaves a full window of length N:
+ *   s1 <- s1 - s0 + y_old + (N - 1) * y_new
+ *   s0 <- s0 - y_old + y_new
+ * The sums are integers, so they never drift. Outputs match the SG kernels apart from float rounding
+ * (or Q16 rounding, with USE_FIXED_POINT), and the cost doesn't depend on the window length.
+ *
+ * Before the window is full, the fit is over the samples available so far.
+ *
+ * The static functions are used directly by KeyBank, which keeps the sums for all keys in arrays.
+ */
+class RunningLinearFit {
+public:
+    // weights for computing the fit from s0 and s1, for a given number of samples in the window
+    struct Coeffs {
+        int32_t n;
+        // endValue = (endS0 * s0 + endS1 * s1) / denominator
+        int64_t endS0;
+        int64_t endS1;
+        // slope = (slopeS0 * s0 + slopeS1 * s1) / denominator
+        int64_t slopeS0;
+        int64_t slopeS1;
+        #ifdef USE_FIXED_POINT
+        // 2^44 / denominator
+        int64_t invDenominator;
+        #else
+        float invDenominator;
+        #endif
+    };
+
+    static Coeffs coeffsFor(int32_t n) {
+        Coeffs c;
+        c.n = n;
+        // sum of i, and sum of i^2, for i = 0..n-1
+        int64_t sumI = (int64_t)n * (n - 1) / 2;
+        int64_t sumI2 = (int64_t)(n - 1) * n * (2 * n - 1) / 6;
+        int64_t denominator = n * sumI2 - sumI * sumI;
+        if (denominator <= 0) {
+            // zero or one sample: the value is the sample, with no slope
+            c.endS0 = 1;
+            c.endS1 = 0;
+            c.slopeS0 = 0;
+            c.slopeS1 = 0;
+            denominator = 1;
+        } else {
+            c.endS0 = sumI2 - (n - 1) * sumI;
+            c.endS1 = (int64_t)n * (n - 1) - sumI;
+            c.slopeS0 = -sumI;
+            c.slopeS1 = n;
+        }
+        #ifdef USE_FIXED_POINT
+        c.invDenominator = (1LL << 44) / denominator;
+        #else
+        c.invDenominator = 1.0f / denominator;
+        #endif
+        return c;
+    }
+
+    // add a sample to the sums, with yLeaving the sample dropping out of the window (if full)
+    static void slide(int32_t& s0, int32_t& s1, int32_t n, int32_t length, int32_t y, int32_t yLeaving) {
+        if (n < length) {
+            s1 += n * y;
+            s0 += y;
+        } else {
+            s1 += yLeaving - s0 + (length - 1) * y;
+            s0 += y - yLeaving;
+        }
+    }
+
+    // change a sample already in the sums by delta, with position its index in the window (0 = oldest)
+    static void correct(int32_t& s0, int32_t& s1, int32_t position, int32_t delta) {
+        s1 += position * delta;
+        s0 += delta;
+    }
+
+    // value of the fitted line at the newest sample (adc bits, Q16 with USE_FIXED_POINT)
+    static SimMath::filter_acc_t endValue(int32_t s0, int32_t s1, const Coeffs& c) {
+        return scale(c.endS0 * s0 + c.endS1 * s1, c);
+    }
+
+    // slope of the fitted line (adc bits per sample, Q16 with USE_FIXED_POINT)
+    static SimMath::filter_acc_t slope(int32_t s0, int32_t s1, const Coeffs& c) {
+        return scale(c.slopeS0 * s0 + c.slopeS1 * s1, c);
+    }
+
+    RunningLinearFit(int32_t length) : _length(length) {
+        reset();
+    }
+
+    void reset() {
+        _s0 = 0;
+        _s1 = 0;
+        _n = 0;
+        _coeffs = coeffsFor(0);
+    }
+
+    /**
+     * @brief Add a sample
+     *
+     * @param y New sample
+     * @param yLeaving Sample leaving the window, i.e. the sample pushed `length` samples ago
+     * (ignored until the window is full)
+     */
+    void push(int32_t y, int32_t yLeaving) {
+        slide(_s0, _s1, _n, _length, y, yLeaving);
+        if (_n < _length) {
+            _n++;
+            // only changes while the window is filling up
+            _coeffs = coeffsFor(_n);
+        }
+    }
+
+    SimMath::filter_acc_t endValue() const { return endValue(_s0, _s1, _coeffs); }
+    SimMath::filter_acc_t slope() const { return slope(_s0, _s1, _coeffs); }
+    int32_t length() const { return _length; }
+    int32_t count() const { return _n; }
+
+private:
+    static SimMath::filter_acc_t scale(int64_t numerator, const Coeffs& c) {
+        #ifdef USE_FIXED_POINT
+        // Q44 -> Q16
+        return (SimMath::filter_acc_t)((numerator * c.invDenominator) >> 28);
+        #else
+        return (float)numerator * c.invDenominator;
+        #endif
+    }
+
+    int32_t _length;
+    int32_t _n;
+    int32_t _s0;
+    int32_t _s1;
+    Coeffs _coeffs;
+};
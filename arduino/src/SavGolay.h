@@ -0,0 +1,112 @@
+#pragma once
+
+// Savitzky-Golay filter coefficients, computed at compile time
+// A Savitzky-Golay filter fits a polynomial of order Order to the last Length samples (least squares),
+// and evaluates the polynomial (Deriv = 0), or one of its derivatives, at the newest sample.
+// e.g. SavGolay<21, 1, 1>::coeffs.c is the speed filter (adc bits per sample) for a 21 sample window.
+// Coefficients are in dot product order, i.e. ordered like buffers, which is oldest to newest, and
+// match scipy.signal.savgol_coeffs(Length, Order, deriv=Deriv, pos=Length-1, use='dot').
+//
+// Higher orders follow fast changes more closely, so a shorter window can be used at the same noise
+// level (i.e. with less lag), at the cost of a full dot product per sample (order 1 filters can
+// instead use RunningLinearFit).
+
+#include <stddef.h>
+
+namespace SavGolayDetail {
+
+constexpr int MAX_ORDER = 6;
+
+template <int Length>
+struct Coeffs {
+  float c[Length];
+};
+
+// coefficients for a window of Length samples, by solving the normal equations of the least squares fit
+template <int Length>
+constexpr Coeffs<Length> solve(int order, int deriv) {
+  const int m = order + 1;
+  // sample positions relative to the newest sample, scaled to [-1, 0] to keep the normal equations well conditioned
+  const double scale = (Length > 1) ? (double)(Length - 1) : 1.0;
+  // normal equations: (A^T A) z = e_deriv, with A[i][k] = x_i^k
+  double ata[MAX_ORDER + 1][MAX_ORDER + 2] = {};
+  for (int i = 0; i < Length; i++) {
+    double x = (i - (Length - 1)) / scale;
+    double powers[2 * MAX_ORDER + 1] = {};
+    powers[0] = 1;
+    for (int k = 1; k < 2 * m - 1; k++) {
+      powers[k] = powers[k - 1] * x;
+    }
+    for (int r = 0; r < m; r++) {
+      for (int c = 0; c < m; c++) {
+        ata[r][c] += powers[r + c];
+      }
+    }
+  }
+  for (int r = 0; r < m; r++) {
+    ata[r][m] = (r == deriv) ? 1 : 0;
+  }
+  // gaussian elimination with partial pivoting
+  for (int col = 0; col < m; col++) {
+    int pivot = col;
+    for (int r = col + 1; r < m; r++) {
+      double a = ata[r][col] < 0 ? -ata[r][col] : ata[r][col];
+      double b = ata[pivot][col] < 0 ? -ata[pivot][col] : ata[pivot][col];
+      if (a > b) {
+        pivot = r;
+      }
+    }
+    for (int c = 0; c <= m; c++) {
+      double tmp = ata[col][c];
+      ata[col][c] = ata[pivot][c];
+      ata[pivot][c] = tmp;
+    }
+    for (int r = 0; r < m; r++) {
+      if (r != col) {
+        double f = ata[r][col] / ata[col][col];
+        for (int c = col; c <= m; c++) {
+          ata[r][c] -= f * ata[col][c];
+        }
+      }
+    }
+  }
+  double z[MAX_ORDER + 1] = {};
+  for (int r = 0; r < m; r++) {
+    z[r] = ata[r][m] / ata[r][r];
+  }
+  // d^deriv/dx^deriv of the fitted polynomial at x = 0 is deriv! * a_deriv, and the scaling of x
+  // contributes 1 / scale^deriv
+  double factor = 1;
+  for (int k = 2; k <= deriv; k++) {
+    factor *= k;
+  }
+  for (int k = 0; k < deriv; k++) {
+    factor /= scale;
+  }
+  Coeffs<Length> out{};
+  for (int i = 0; i < Length; i++) {
+    double x = (i - (Length - 1)) / scale;
+    double h = 0;
+    double p = 1;
+    for (int k = 0; k < m; k++) {
+      h += z[k] * p;
+      p *= x;
+    }
+    out.c[i] = (float)(h * factor);
+  }
+  return out;
+}
+
+} // namespace SavGolayDetail
+
+template <int Length, int Order, int Deriv = 0>
+struct SavGolay {
+  static_assert(Length > Order, "window must be longer than the polyorder");
+  static_assert(Order >= 0 && Order <= SavGolayDetail::MAX_ORDER, "unsupported polyorder");
+  static_assert(Deriv >= 0 && Deriv <= Order, "derivative must be at most the polyorder");
+
+  static constexpr int length = Length;
+  static constexpr int order = Order;
+  static constexpr int deriv = Deriv;
+  static constexpr SavGolayDetail::Coeffs<Length> coeffs = SavGolayDetail::solve<Length>(Order, Deriv);
+};
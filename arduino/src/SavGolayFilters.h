@@ -1,1197 +1,24 @@
-// This file is auto-generated by generate_sav_golay.py
-// Except for POS_FILTER_LENGTH and SPEED_FILTER_LENGTH, do not edit this file directly.
-// Perhaps this approach is a bit more convoluted than directly generating the coefficients in the cpp code, but
-// I was a bit lazy and at least it results in efficient cpp code with the smallest possible memory footprint.
+// Savitzky-Golay filters used by every key
+// The coefficients are computed at compile time (see SavGolay.h), so any window length / polyorder can be
+// used by changing the values below.
 #pragma once
+#include "SavGolay.h"
 
-// First define the lengths as preprocessor constants
+// window lengths and polyorders of the default filters
 #define POS_FILTER_LENGTH 21
 #define SPEED_FILTER_LENGTH 21
+#define POS_FILTER_ORDER 1
+#define SPEED_FILTER_ORDER 1
 
 // filters should be in dot product order, i.e. ordered like buffers, which is oldest to newest
 namespace SavGolayFilters {
-constexpr int posFilterLength = POS_FILTER_LENGTH;
-constexpr int speedFilterLength = SPEED_FILTER_LENGTH;
+typedef SavGolay<POS_FILTER_LENGTH, POS_FILTER_ORDER, 0> PosFilter;
+typedef SavGolay<SPEED_FILTER_LENGTH, SPEED_FILTER_ORDER, 1> SpeedFilter;
 
-#if POS_FILTER_LENGTH == 3
-inline constexpr float posFilter[3] = {
--0.16666667, 0.33333333, 0.83333333};
+constexpr int posFilterLength = PosFilter::length;
+constexpr int speedFilterLength = SpeedFilter::length;
 
-#elif POS_FILTER_LENGTH == 5
-inline constexpr float posFilter[5] = {
--0.20000000, -0.00000000, 0.20000000, 0.40000000, 0.60000000};
-
-#elif POS_FILTER_LENGTH == 7
-inline constexpr float posFilter[7] = {
--0.17857143, -0.07142857, 0.03571429, 0.14285714, 0.25000000, 0.35714286, 
-0.46428571};
-
-#elif POS_FILTER_LENGTH == 9
-inline constexpr float posFilter[9] = {
--0.15555556, -0.08888889, -0.02222222, 0.04444444, 0.11111111, 0.17777778, 
-0.24444444, 0.31111111, 0.37777778};
-
-#elif POS_FILTER_LENGTH == 11
-inline constexpr float posFilter[11] = {
--0.13636364, -0.09090909, -0.04545455, -0.00000000, 0.04545455, 0.09090909, 
-0.13636364, 0.18181818, 0.22727273, 0.27272727, 0.31818182};
-
-#elif POS_FILTER_LENGTH == 13
-inline constexpr float posFilter[13] = {
--0.12087912, -0.08791209, -0.05494505, -0.02197802, 0.01098901, 0.04395604, 
-0.07692308, 0.10989011, 0.14285714, 0.17582418, 0.20879121, 0.24175824, 
-0.27472527};
-
-#elif POS_FILTER_LENGTH == 15
-inline constexpr float posFilter[15] = {
--0.10833333, -0.08333333, -0.05833333, -0.03333333, -0.00833333, 0.01666667, 
-0.04166667, 0.06666667, 0.09166667, 0.11666667, 0.14166667, 0.16666667, 
-0.19166667, 0.21666667, 0.24166667};
-
-#elif POS_FILTER_LENGTH == 17
-inline constexpr float posFilter[17] = {
--0.09803922, -0.07843137, -0.05882353, -0.03921569, -0.01960784, -0.00000000, 
-0.01960784, 0.03921569, 0.05882353, 0.07843137, 0.09803922, 0.11764706, 
-0.13725490, 0.15686275, 0.17647059, 0.19607843, 0.21568627};
-
-#elif POS_FILTER_LENGTH == 19
-inline constexpr float posFilter[19] = {
--0.08947368, -0.07368421, -0.05789474, -0.04210526, -0.02631579, -0.01052632, 
-0.00526316, 0.02105263, 0.03684211, 0.05263158, 0.06842105, 0.08421053, 
-0.10000000, 0.11578947, 0.13157895, 0.14736842, 0.16315789, 0.17894737, 
-0.19473684};
-
-#elif POS_FILTER_LENGTH == 21
-inline constexpr float posFilter[21] = {
--0.08225108, -0.06926407, -0.05627706, -0.04329004, -0.03030303, -0.01731602, 
--0.00432900, 0.00865801, 0.02164502, 0.03463203, 0.04761905, 0.06060606, 
-0.07359307, 0.08658009, 0.09956710, 0.11255411, 0.12554113, 0.13852814, 
-0.15151515, 0.16450216, 0.17748918};
-
-#elif POS_FILTER_LENGTH == 23
-inline constexpr float posFilter[23] = {
--0.07608696, -0.06521739, -0.05434783, -0.04347826, -0.03260870, -0.02173913, 
--0.01086957, -0.00000000, 0.01086957, 0.02173913, 0.03260870, 0.04347826, 
-0.05434783, 0.06521739, 0.07608696, 0.08695652, 0.09782609, 0.10869565, 
-0.11956522, 0.13043478, 0.14130435, 0.15217391, 0.16304348};
-
-#elif POS_FILTER_LENGTH == 25
-inline constexpr float posFilter[25] = {
--0.07076923, -0.06153846, -0.05230769, -0.04307692, -0.03384615, -0.02461538, 
--0.01538462, -0.00615385, 0.00307692, 0.01230769, 0.02153846, 0.03076923, 
-0.04000000, 0.04923077, 0.05846154, 0.06769231, 0.07692308, 0.08615385, 
-0.09538462, 0.10461538, 0.11384615, 0.12307692, 0.13230769, 0.14153846, 
-0.15076923};
-
-#elif POS_FILTER_LENGTH == 27
-inline constexpr float posFilter[27] = {
--0.06613757, -0.05820106, -0.05026455, -0.04232804, -0.03439153, -0.02645503, 
--0.01851852, -0.01058201, -0.00264550, 0.00529101, 0.01322751, 0.02116402, 
-0.02910053, 0.03703704, 0.04497354, 0.05291005, 0.06084656, 0.06878307, 
-0.07671958, 0.08465608, 0.09259259, 0.10052910, 0.10846561, 0.11640212, 
-0.12433862, 0.13227513, 0.14021164};
-
-#elif POS_FILTER_LENGTH == 29
-inline constexpr float posFilter[29] = {
--0.06206897, -0.05517241, -0.04827586, -0.04137931, -0.03448276, -0.02758621, 
--0.02068966, -0.01379310, -0.00689655, -0.00000000, 0.00689655, 0.01379310, 
-0.02068966, 0.02758621, 0.03448276, 0.04137931, 0.04827586, 0.05517241, 
-0.06206897, 0.06896552, 0.07586207, 0.08275862, 0.08965517, 0.09655172, 
-0.10344828, 0.11034483, 0.11724138, 0.12413793, 0.13103448};
-
-#elif POS_FILTER_LENGTH == 31
-inline constexpr float posFilter[31] = {
--0.05846774, -0.05241935, -0.04637097, -0.04032258, -0.03427419, -0.02822581, 
--0.02217742, -0.01612903, -0.01008065, -0.00403226, 0.00201613, 0.00806452, 
-0.01411290, 0.02016129, 0.02620968, 0.03225806, 0.03830645, 0.04435484, 
-0.05040323, 0.05645161, 0.06250000, 0.06854839, 0.07459677, 0.08064516, 
-0.08669355, 0.09274194, 0.09879032, 0.10483871, 0.11088710, 0.11693548, 
-0.12298387};
-
-#elif POS_FILTER_LENGTH == 33
-inline constexpr float posFilter[33] = {
--0.05525847, -0.04991087, -0.04456328, -0.03921569, -0.03386809, -0.02852050, 
--0.02317291, -0.01782531, -0.01247772, -0.00713012, -0.00178253, 0.00356506, 
-0.00891266, 0.01426025, 0.01960784, 0.02495544, 0.03030303, 0.03565062, 
-0.04099822, 0.04634581, 0.05169340, 0.05704100, 0.06238859, 0.06773619, 
-0.07308378, 0.07843137, 0.08377897, 0.08912656, 0.09447415, 0.09982175, 
-0.10516934, 0.11051693, 0.11586453};
-
-#elif POS_FILTER_LENGTH == 35
-inline constexpr float posFilter[35] = {
--0.05238095, -0.04761905, -0.04285714, -0.03809524, -0.03333333, -0.02857143, 
--0.02380952, -0.01904762, -0.01428571, -0.00952381, -0.00476190, -0.00000000, 
-0.00476190, 0.00952381, 0.01428571, 0.01904762, 0.02380952, 0.02857143, 
-0.03333333, 0.03809524, 0.04285714, 0.04761905, 0.05238095, 0.05714286, 
-0.06190476, 0.06666667, 0.07142857, 0.07619048, 0.08095238, 0.08571429, 
-0.09047619, 0.09523810, 0.10000000, 0.10476190, 0.10952381};
-
-#elif POS_FILTER_LENGTH == 37
-inline constexpr float posFilter[37] = {
--0.04978663, -0.04551920, -0.04125178, -0.03698435, -0.03271693, -0.02844950, 
--0.02418208, -0.01991465, -0.01564723, -0.01137980, -0.00711238, -0.00284495, 
-0.00142248, 0.00568990, 0.00995733, 0.01422475, 0.01849218, 0.02275960, 
-0.02702703, 0.03129445, 0.03556188, 0.03982930, 0.04409673, 0.04836415, 
-0.05263158, 0.05689900, 0.06116643, 0.06543385, 0.06970128, 0.07396871, 
-0.07823613, 0.08250356, 0.08677098, 0.09103841, 0.09530583, 0.09957326, 
-0.10384068};
-
-#elif POS_FILTER_LENGTH == 39
-inline constexpr float posFilter[39] = {
--0.04743590, -0.04358974, -0.03974359, -0.03589744, -0.03205128, -0.02820513, 
--0.02435897, -0.02051282, -0.01666667, -0.01282051, -0.00897436, -0.00512821, 
--0.00128205, 0.00256410, 0.00641026, 0.01025641, 0.01410256, 0.01794872, 
-0.02179487, 0.02564103, 0.02948718, 0.03333333, 0.03717949, 0.04102564, 
-0.04487179, 0.04871795, 0.05256410, 0.05641026, 0.06025641, 0.06410256, 
-0.06794872, 0.07179487, 0.07564103, 0.07948718, 0.08333333, 0.08717949, 
-0.09102564, 0.09487179, 0.09871795};
-
-#elif POS_FILTER_LENGTH == 41
-inline constexpr float posFilter[41] = {
--0.04529617, -0.04181185, -0.03832753, -0.03484321, -0.03135889, -0.02787456, 
--0.02439024, -0.02090592, -0.01742160, -0.01393728, -0.01045296, -0.00696864, 
--0.00348432, 0.00000000, 0.00348432, 0.00696864, 0.01045296, 0.01393728, 
-0.01742160, 0.02090592, 0.02439024, 0.02787456, 0.03135889, 0.03484321, 
-0.03832753, 0.04181185, 0.04529617, 0.04878049, 0.05226481, 0.05574913, 
-0.05923345, 0.06271777, 0.06620209, 0.06968641, 0.07317073, 0.07665505, 
-0.08013937, 0.08362369, 0.08710801, 0.09059233, 0.09407666};
-
-#elif POS_FILTER_LENGTH == 43
-inline constexpr float posFilter[43] = {
--0.04334038, -0.04016913, -0.03699789, -0.03382664, -0.03065539, -0.02748414, 
--0.02431290, -0.02114165, -0.01797040, -0.01479915, -0.01162791, -0.00845666, 
--0.00528541, -0.00211416, 0.00105708, 0.00422833, 0.00739958, 0.01057082, 
-0.01374207, 0.01691332, 0.02008457, 0.02325581, 0.02642706, 0.02959831, 
-0.03276956, 0.03594080, 0.03911205, 0.04228330, 0.04545455, 0.04862579, 
-0.05179704, 0.05496829, 0.05813953, 0.06131078, 0.06448203, 0.06765328, 
-0.07082452, 0.07399577, 0.07716702, 0.08033827, 0.08350951, 0.08668076, 
-0.08985201};
-
-#elif POS_FILTER_LENGTH == 45
-inline constexpr float posFilter[45] = {
--0.04154589, -0.03864734, -0.03574879, -0.03285024, -0.02995169, -0.02705314, 
--0.02415459, -0.02125604, -0.01835749, -0.01545894, -0.01256039, -0.00966184, 
--0.00676329, -0.00386473, -0.00096618, 0.00193237, 0.00483092, 0.00772947, 
-0.01062802, 0.01352657, 0.01642512, 0.01932367, 0.02222222, 0.02512077, 
-0.02801932, 0.03091787, 0.03381643, 0.03671498, 0.03961353, 0.04251208, 
-0.04541063, 0.04830918, 0.05120773, 0.05410628, 0.05700483, 0.05990338, 
-0.06280193, 0.06570048, 0.06859903, 0.07149758, 0.07439614, 0.07729469, 
-0.08019324, 0.08309179, 0.08599034};
-
-#elif POS_FILTER_LENGTH == 47
-inline constexpr float posFilter[47] = {
--0.03989362, -0.03723404, -0.03457447, -0.03191489, -0.02925532, -0.02659574, 
--0.02393617, -0.02127660, -0.01861702, -0.01595745, -0.01329787, -0.01063830, 
--0.00797872, -0.00531915, -0.00265957, -0.00000000, 0.00265957, 0.00531915, 
-0.00797872, 0.01063830, 0.01329787, 0.01595745, 0.01861702, 0.02127660, 
-0.02393617, 0.02659574, 0.02925532, 0.03191489, 0.03457447, 0.03723404, 
-0.03989362, 0.04255319, 0.04521277, 0.04787234, 0.05053191, 0.05319149, 
-0.05585106, 0.05851064, 0.06117021, 0.06382979, 0.06648936, 0.06914894, 
-0.07180851, 0.07446809, 0.07712766, 0.07978723, 0.08244681};
-
-#elif POS_FILTER_LENGTH == 49
-inline constexpr float posFilter[49] = {
--0.03836735, -0.03591837, -0.03346939, -0.03102041, -0.02857143, -0.02612245, 
--0.02367347, -0.02122449, -0.01877551, -0.01632653, -0.01387755, -0.01142857, 
--0.00897959, -0.00653061, -0.00408163, -0.00163265, 0.00081633, 0.00326531, 
-0.00571429, 0.00816327, 0.01061224, 0.01306122, 0.01551020, 0.01795918, 
-0.02040816, 0.02285714, 0.02530612, 0.02775510, 0.03020408, 0.03265306, 
-0.03510204, 0.03755102, 0.04000000, 0.04244898, 0.04489796, 0.04734694, 
-0.04979592, 0.05224490, 0.05469388, 0.05714286, 0.05959184, 0.06204082, 
-0.06448980, 0.06693878, 0.06938776, 0.07183673, 0.07428571, 0.07673469, 
-0.07918367};
-
-#elif POS_FILTER_LENGTH == 51
-inline constexpr float posFilter[51] = {
--0.03695324, -0.03469080, -0.03242836, -0.03016591, -0.02790347, -0.02564103, 
--0.02337858, -0.02111614, -0.01885370, -0.01659125, -0.01432881, -0.01206637, 
--0.00980392, -0.00754148, -0.00527903, -0.00301659, -0.00075415, 0.00150830, 
-0.00377074, 0.00603318, 0.00829563, 0.01055807, 0.01282051, 0.01508296, 
-0.01734540, 0.01960784, 0.02187029, 0.02413273, 0.02639517, 0.02865762, 
-0.03092006, 0.03318250, 0.03544495, 0.03770739, 0.03996983, 0.04223228, 
-0.04449472, 0.04675716, 0.04901961, 0.05128205, 0.05354449, 0.05580694, 
-0.05806938, 0.06033183, 0.06259427, 0.06485671, 0.06711916, 0.06938160, 
-0.07164404, 0.07390649, 0.07616893};
-
-#elif POS_FILTER_LENGTH == 53
-inline constexpr float posFilter[53] = {
--0.03563941, -0.03354298, -0.03144654, -0.02935010, -0.02725367, -0.02515723, 
--0.02306080, -0.02096436, -0.01886792, -0.01677149, -0.01467505, -0.01257862, 
--0.01048218, -0.00838574, -0.00628931, -0.00419287, -0.00209644, 0.00000000, 
-0.00209644, 0.00419287, 0.00628931, 0.00838574, 0.01048218, 0.01257862, 
-0.01467505, 0.01677149, 0.01886792, 0.02096436, 0.02306080, 0.02515723, 
-0.02725367, 0.02935010, 0.03144654, 0.03354298, 0.03563941, 0.03773585, 
-0.03983229, 0.04192872, 0.04402516, 0.04612159, 0.04821803, 0.05031447, 
-0.05241090, 0.05450734, 0.05660377, 0.05870021, 0.06079665, 0.06289308, 
-0.06498952, 0.06708595, 0.06918239, 0.07127883, 0.07337526};
-
-#elif POS_FILTER_LENGTH == 55
-inline constexpr float posFilter[55] = {
--0.03441558, -0.03246753, -0.03051948, -0.02857143, -0.02662338, -0.02467532, 
--0.02272727, -0.02077922, -0.01883117, -0.01688312, -0.01493506, -0.01298701, 
--0.01103896, -0.00909091, -0.00714286, -0.00519481, -0.00324675, -0.00129870, 
-0.00064935, 0.00259740, 0.00454545, 0.00649351, 0.00844156, 0.01038961, 
-0.01233766, 0.01428571, 0.01623377, 0.01818182, 0.02012987, 0.02207792, 
-0.02402597, 0.02597403, 0.02792208, 0.02987013, 0.03181818, 0.03376623, 
-0.03571429, 0.03766234, 0.03961039, 0.04155844, 0.04350649, 0.04545455, 
-0.04740260, 0.04935065, 0.05129870, 0.05324675, 0.05519481, 0.05714286, 
-0.05909091, 0.06103896, 0.06298701, 0.06493506, 0.06688312, 0.06883117, 
-0.07077922};
-
-#elif POS_FILTER_LENGTH == 57
-inline constexpr float posFilter[57] = {
--0.03327284, -0.03145796, -0.02964307, -0.02782819, -0.02601331, -0.02419843, 
--0.02238355, -0.02056866, -0.01875378, -0.01693890, -0.01512402, -0.01330913, 
--0.01149425, -0.00967937, -0.00786449, -0.00604961, -0.00423472, -0.00241984, 
--0.00060496, 0.00120992, 0.00302480, 0.00483969, 0.00665457, 0.00846945, 
-0.01028433, 0.01209921, 0.01391410, 0.01572898, 0.01754386, 0.01935874, 
-0.02117362, 0.02298851, 0.02480339, 0.02661827, 0.02843315, 0.03024803, 
-0.03206292, 0.03387780, 0.03569268, 0.03750756, 0.03932244, 0.04113733, 
-0.04295221, 0.04476709, 0.04658197, 0.04839685, 0.05021174, 0.05202662, 
-0.05384150, 0.05565638, 0.05747126, 0.05928615, 0.06110103, 0.06291591, 
-0.06473079, 0.06654567, 0.06836056};
-
-#elif POS_FILTER_LENGTH == 59
-inline constexpr float posFilter[59] = {
--0.03220339, -0.03050847, -0.02881356, -0.02711864, -0.02542373, -0.02372881, 
--0.02203390, -0.02033898, -0.01864407, -0.01694915, -0.01525424, -0.01355932, 
--0.01186441, -0.01016949, -0.00847458, -0.00677966, -0.00508475, -0.00338983, 
--0.00169492, 0.00000000, 0.00169492, 0.00338983, 0.00508475, 0.00677966, 
-0.00847458, 0.01016949, 0.01186441, 0.01355932, 0.01525424, 0.01694915, 
-0.01864407, 0.02033898, 0.02203390, 0.02372881, 0.02542373, 0.02711864, 
-0.02881356, 0.03050847, 0.03220339, 0.03389831, 0.03559322, 0.03728814, 
-0.03898305, 0.04067797, 0.04237288, 0.04406780, 0.04576271, 0.04745763, 
-0.04915254, 0.05084746, 0.05254237, 0.05423729, 0.05593220, 0.05762712, 
-0.05932203, 0.06101695, 0.06271186, 0.06440678, 0.06610169};
-
-#elif POS_FILTER_LENGTH == 61
-inline constexpr float posFilter[61] = {
--0.03120042, -0.02961396, -0.02802750, -0.02644104, -0.02485457, -0.02326811, 
--0.02168165, -0.02009519, -0.01850873, -0.01692226, -0.01533580, -0.01374934, 
--0.01216288, -0.01057641, -0.00898995, -0.00740349, -0.00581703, -0.00423057, 
--0.00264410, -0.00105764, 0.00052882, 0.00211528, 0.00370175, 0.00528821, 
-0.00687467, 0.00846113, 0.01004759, 0.01163406, 0.01322052, 0.01480698, 
-0.01639344, 0.01797990, 0.01956637, 0.02115283, 0.02273929, 0.02432575, 
-0.02591222, 0.02749868, 0.02908514, 0.03067160, 0.03225806, 0.03384453, 
-0.03543099, 0.03701745, 0.03860391, 0.04019038, 0.04177684, 0.04336330, 
-0.04494976, 0.04653622, 0.04812269, 0.04970915, 0.05129561, 0.05288207, 
-0.05446854, 0.05605500, 0.05764146, 0.05922792, 0.06081438, 0.06240085, 
-0.06398731};
-
-#elif POS_FILTER_LENGTH == 63
-inline constexpr float posFilter[63] = {
--0.03025794, -0.02876984, -0.02728175, -0.02579365, -0.02430556, -0.02281746, 
--0.02132937, -0.01984127, -0.01835317, -0.01686508, -0.01537698, -0.01388889, 
--0.01240079, -0.01091270, -0.00942460, -0.00793651, -0.00644841, -0.00496032, 
--0.00347222, -0.00198413, -0.00049603, 0.00099206, 0.00248016, 0.00396825, 
-0.00545635, 0.00694444, 0.00843254, 0.00992063, 0.01140873, 0.01289683, 
-0.01438492, 0.01587302, 0.01736111, 0.01884921, 0.02033730, 0.02182540, 
-0.02331349, 0.02480159, 0.02628968, 0.02777778, 0.02926587, 0.03075397, 
-0.03224206, 0.03373016, 0.03521825, 0.03670635, 0.03819444, 0.03968254, 
-0.04117063, 0.04265873, 0.04414683, 0.04563492, 0.04712302, 0.04861111, 
-0.05009921, 0.05158730, 0.05307540, 0.05456349, 0.05605159, 0.05753968, 
-0.05902778, 0.06051587, 0.06200397};
-
-#elif POS_FILTER_LENGTH == 65
-inline constexpr float posFilter[65] = {
--0.02937063, -0.02797203, -0.02657343, -0.02517483, -0.02377622, -0.02237762, 
--0.02097902, -0.01958042, -0.01818182, -0.01678322, -0.01538462, -0.01398601, 
--0.01258741, -0.01118881, -0.00979021, -0.00839161, -0.00699301, -0.00559441, 
--0.00419580, -0.00279720, -0.00139860, -0.00000000, 0.00139860, 0.00279720, 
-0.00419580, 0.00559441, 0.00699301, 0.00839161, 0.00979021, 0.01118881, 
-0.01258741, 0.01398601, 0.01538462, 0.01678322, 0.01818182, 0.01958042, 
-0.02097902, 0.02237762, 0.02377622, 0.02517483, 0.02657343, 0.02797203, 
-0.02937063, 0.03076923, 0.03216783, 0.03356643, 0.03496503, 0.03636364, 
-0.03776224, 0.03916084, 0.04055944, 0.04195804, 0.04335664, 0.04475524, 
-0.04615385, 0.04755245, 0.04895105, 0.05034965, 0.05174825, 0.05314685, 
-0.05454545, 0.05594406, 0.05734266, 0.05874126, 0.06013986};
-
-#elif POS_FILTER_LENGTH == 67
-inline constexpr float posFilter[67] = {
--0.02853380, -0.02721686, -0.02589991, -0.02458297, -0.02326602, -0.02194908, 
--0.02063213, -0.01931519, -0.01799824, -0.01668130, -0.01536435, -0.01404741, 
--0.01273047, -0.01141352, -0.01009658, -0.00877963, -0.00746269, -0.00614574, 
--0.00482880, -0.00351185, -0.00219491, -0.00087796, 0.00043898, 0.00175593, 
-0.00307287, 0.00438982, 0.00570676, 0.00702371, 0.00834065, 0.00965759, 
-0.01097454, 0.01229148, 0.01360843, 0.01492537, 0.01624232, 0.01755926, 
-0.01887621, 0.02019315, 0.02151010, 0.02282704, 0.02414399, 0.02546093, 
-0.02677788, 0.02809482, 0.02941176, 0.03072871, 0.03204565, 0.03336260, 
-0.03467954, 0.03599649, 0.03731343, 0.03863038, 0.03994732, 0.04126427, 
-0.04258121, 0.04389816, 0.04521510, 0.04653205, 0.04784899, 0.04916594, 
-0.05048288, 0.05179982, 0.05311677, 0.05443371, 0.05575066, 0.05706760, 
-0.05838455};
-
-#elif POS_FILTER_LENGTH == 69
-inline constexpr float posFilter[69] = {
--0.02774327, -0.02650104, -0.02525880, -0.02401656, -0.02277433, -0.02153209, 
--0.02028986, -0.01904762, -0.01780538, -0.01656315, -0.01532091, -0.01407867, 
--0.01283644, -0.01159420, -0.01035197, -0.00910973, -0.00786749, -0.00662526, 
--0.00538302, -0.00414079, -0.00289855, -0.00165631, -0.00041408, 0.00082816, 
-0.00207039, 0.00331263, 0.00455487, 0.00579710, 0.00703934, 0.00828157, 
-0.00952381, 0.01076605, 0.01200828, 0.01325052, 0.01449275, 0.01573499, 
-0.01697723, 0.01821946, 0.01946170, 0.02070393, 0.02194617, 0.02318841, 
-0.02443064, 0.02567288, 0.02691511, 0.02815735, 0.02939959, 0.03064182, 
-0.03188406, 0.03312629, 0.03436853, 0.03561077, 0.03685300, 0.03809524, 
-0.03933747, 0.04057971, 0.04182195, 0.04306418, 0.04430642, 0.04554865, 
-0.04679089, 0.04803313, 0.04927536, 0.05051760, 0.05175983, 0.05300207, 
-0.05424431, 0.05548654, 0.05672878};
-
-#elif POS_FILTER_LENGTH == 71
-inline constexpr float posFilter[71] = {
--0.02699531, -0.02582160, -0.02464789, -0.02347418, -0.02230047, -0.02112676, 
--0.01995305, -0.01877934, -0.01760563, -0.01643192, -0.01525822, -0.01408451, 
--0.01291080, -0.01173709, -0.01056338, -0.00938967, -0.00821596, -0.00704225, 
--0.00586854, -0.00469484, -0.00352113, -0.00234742, -0.00117371, -0.00000000, 
-0.00117371, 0.00234742, 0.00352113, 0.00469484, 0.00586854, 0.00704225, 
-0.00821596, 0.00938967, 0.01056338, 0.01173709, 0.01291080, 0.01408451, 
-0.01525822, 0.01643192, 0.01760563, 0.01877934, 0.01995305, 0.02112676, 
-0.02230047, 0.02347418, 0.02464789, 0.02582160, 0.02699531, 0.02816901, 
-0.02934272, 0.03051643, 0.03169014, 0.03286385, 0.03403756, 0.03521127, 
-0.03638498, 0.03755869, 0.03873239, 0.03990610, 0.04107981, 0.04225352, 
-0.04342723, 0.04460094, 0.04577465, 0.04694836, 0.04812207, 0.04929577, 
-0.05046948, 0.05164319, 0.05281690, 0.05399061, 0.05516432};
-
-#elif POS_FILTER_LENGTH == 73
-inline constexpr float posFilter[73] = {
--0.02628656, -0.02517586, -0.02406516, -0.02295446, -0.02184376, -0.02073306, 
--0.01962236, -0.01851166, -0.01740096, -0.01629026, -0.01517956, -0.01406886, 
--0.01295816, -0.01184746, -0.01073676, -0.00962606, -0.00851536, -0.00740466, 
--0.00629397, -0.00518327, -0.00407257, -0.00296187, -0.00185117, -0.00074047, 
-0.00037023, 0.00148093, 0.00259163, 0.00370233, 0.00481303, 0.00592373, 
-0.00703443, 0.00814513, 0.00925583, 0.01036653, 0.01147723, 0.01258793, 
-0.01369863, 0.01480933, 0.01592003, 0.01703073, 0.01814143, 0.01925213, 
-0.02036283, 0.02147353, 0.02258423, 0.02369493, 0.02480563, 0.02591633, 
-0.02702703, 0.02813773, 0.02924843, 0.03035913, 0.03146983, 0.03258053, 
-0.03369123, 0.03480193, 0.03591262, 0.03702332, 0.03813402, 0.03924472, 
-0.04035542, 0.04146612, 0.04257682, 0.04368752, 0.04479822, 0.04590892, 
-0.04701962, 0.04813032, 0.04924102, 0.05035172, 0.05146242, 0.05257312, 
-0.05368382};
-
-#elif POS_FILTER_LENGTH == 75
-inline constexpr float posFilter[75] = {
--0.02561404, -0.02456140, -0.02350877, -0.02245614, -0.02140351, -0.02035088, 
--0.01929825, -0.01824561, -0.01719298, -0.01614035, -0.01508772, -0.01403509, 
--0.01298246, -0.01192982, -0.01087719, -0.00982456, -0.00877193, -0.00771930, 
--0.00666667, -0.00561404, -0.00456140, -0.00350877, -0.00245614, -0.00140351, 
--0.00035088, 0.00070175, 0.00175439, 0.00280702, 0.00385965, 0.00491228, 
-0.00596491, 0.00701754, 0.00807018, 0.00912281, 0.01017544, 0.01122807, 
-0.01228070, 0.01333333, 0.01438596, 0.01543860, 0.01649123, 0.01754386, 
-0.01859649, 0.01964912, 0.02070175, 0.02175439, 0.02280702, 0.02385965, 
-0.02491228, 0.02596491, 0.02701754, 0.02807018, 0.02912281, 0.03017544, 
-0.03122807, 0.03228070, 0.03333333, 0.03438596, 0.03543860, 0.03649123, 
-0.03754386, 0.03859649, 0.03964912, 0.04070175, 0.04175439, 0.04280702, 
-0.04385965, 0.04491228, 0.04596491, 0.04701754, 0.04807018, 0.04912281, 
-0.05017544, 0.05122807, 0.05228070};
-
-#elif POS_FILTER_LENGTH == 77
-inline constexpr float posFilter[77] = {
--0.02497502, -0.02397602, -0.02297702, -0.02197802, -0.02097902, -0.01998002, 
--0.01898102, -0.01798202, -0.01698302, -0.01598402, -0.01498501, -0.01398601, 
--0.01298701, -0.01198801, -0.01098901, -0.00999001, -0.00899101, -0.00799201, 
--0.00699301, -0.00599401, -0.00499500, -0.00399600, -0.00299700, -0.00199800, 
--0.00099900, -0.00000000, 0.00099900, 0.00199800, 0.00299700, 0.00399600, 
-0.00499500, 0.00599401, 0.00699301, 0.00799201, 0.00899101, 0.00999001, 
-0.01098901, 0.01198801, 0.01298701, 0.01398601, 0.01498501, 0.01598402, 
-0.01698302, 0.01798202, 0.01898102, 0.01998002, 0.02097902, 0.02197802, 
-0.02297702, 0.02397602, 0.02497502, 0.02597403, 0.02697303, 0.02797203, 
-0.02897103, 0.02997003, 0.03096903, 0.03196803, 0.03296703, 0.03396603, 
-0.03496503, 0.03596404, 0.03696304, 0.03796204, 0.03896104, 0.03996004, 
-0.04095904, 0.04195804, 0.04295704, 0.04395604, 0.04495504, 0.04595405, 
-0.04695305, 0.04795205, 0.04895105, 0.04995005, 0.05094905};
-
-#elif POS_FILTER_LENGTH == 79
-inline constexpr float posFilter[79] = {
--0.02436709, -0.02341772, -0.02246835, -0.02151899, -0.02056962, -0.01962025, 
--0.01867089, -0.01772152, -0.01677215, -0.01582278, -0.01487342, -0.01392405, 
--0.01297468, -0.01202532, -0.01107595, -0.01012658, -0.00917722, -0.00822785, 
--0.00727848, -0.00632911, -0.00537975, -0.00443038, -0.00348101, -0.00253165, 
--0.00158228, -0.00063291, 0.00031646, 0.00126582, 0.00221519, 0.00316456, 
-0.00411392, 0.00506329, 0.00601266, 0.00696203, 0.00791139, 0.00886076, 
-0.00981013, 0.01075949, 0.01170886, 0.01265823, 0.01360759, 0.01455696, 
-0.01550633, 0.01645570, 0.01740506, 0.01835443, 0.01930380, 0.02025316, 
-0.02120253, 0.02215190, 0.02310127, 0.02405063, 0.02500000, 0.02594937, 
-0.02689873, 0.02784810, 0.02879747, 0.02974684, 0.03069620, 0.03164557, 
-0.03259494, 0.03354430, 0.03449367, 0.03544304, 0.03639241, 0.03734177, 
-0.03829114, 0.03924051, 0.04018987, 0.04113924, 0.04208861, 0.04303797, 
-0.04398734, 0.04493671, 0.04588608, 0.04683544, 0.04778481, 0.04873418, 
-0.04968354};
-
-#elif POS_FILTER_LENGTH == 81
-inline constexpr float posFilter[81] = {
--0.02378802, -0.02288467, -0.02198133, -0.02107799, -0.02017465, -0.01927130, 
--0.01836796, -0.01746462, -0.01656128, -0.01565793, -0.01475459, -0.01385125, 
--0.01294791, -0.01204456, -0.01114122, -0.01023788, -0.00933454, -0.00843120, 
--0.00752785, -0.00662451, -0.00572117, -0.00481783, -0.00391448, -0.00301114, 
--0.00210780, -0.00120446, -0.00030111, 0.00060223, 0.00150557, 0.00240891, 
-0.00331226, 0.00421560, 0.00511894, 0.00602228, 0.00692562, 0.00782897, 
-0.00873231, 0.00963565, 0.01053899, 0.01144234, 0.01234568, 0.01324902, 
-0.01415236, 0.01505571, 0.01595905, 0.01686239, 0.01776573, 0.01866908, 
-0.01957242, 0.02047576, 0.02137910, 0.02228245, 0.02318579, 0.02408913, 
-0.02499247, 0.02589581, 0.02679916, 0.02770250, 0.02860584, 0.02950918, 
-0.03041253, 0.03131587, 0.03221921, 0.03312255, 0.03402590, 0.03492924, 
-0.03583258, 0.03673592, 0.03763927, 0.03854261, 0.03944595, 0.04034929, 
-0.04125263, 0.04215598, 0.04305932, 0.04396266, 0.04486600, 0.04576935, 
-0.04667269, 0.04757603, 0.04847937};
-
-#elif POS_FILTER_LENGTH == 83
-inline constexpr float posFilter[83] = {
--0.02323580, -0.02237522, -0.02151463, -0.02065404, -0.01979346, -0.01893287, 
--0.01807229, -0.01721170, -0.01635112, -0.01549053, -0.01462995, -0.01376936, 
--0.01290878, -0.01204819, -0.01118761, -0.01032702, -0.00946644, -0.00860585, 
--0.00774527, -0.00688468, -0.00602410, -0.00516351, -0.00430293, -0.00344234, 
--0.00258176, -0.00172117, -0.00086059, -0.00000000, 0.00086059, 0.00172117, 
-0.00258176, 0.00344234, 0.00430293, 0.00516351, 0.00602410, 0.00688468, 
-0.00774527, 0.00860585, 0.00946644, 0.01032702, 0.01118761, 0.01204819, 
-0.01290878, 0.01376936, 0.01462995, 0.01549053, 0.01635112, 0.01721170, 
-0.01807229, 0.01893287, 0.01979346, 0.02065404, 0.02151463, 0.02237522, 
-0.02323580, 0.02409639, 0.02495697, 0.02581756, 0.02667814, 0.02753873, 
-0.02839931, 0.02925990, 0.03012048, 0.03098107, 0.03184165, 0.03270224, 
-0.03356282, 0.03442341, 0.03528399, 0.03614458, 0.03700516, 0.03786575, 
-0.03872633, 0.03958692, 0.04044750, 0.04130809, 0.04216867, 0.04302926, 
-0.04388985, 0.04475043, 0.04561102, 0.04647160, 0.04733219};
-
-#elif POS_FILTER_LENGTH == 85
-inline constexpr float posFilter[85] = {
--0.02270862, -0.02188782, -0.02106703, -0.02024624, -0.01942544, -0.01860465, 
--0.01778386, -0.01696306, -0.01614227, -0.01532148, -0.01450068, -0.01367989, 
--0.01285910, -0.01203830, -0.01121751, -0.01039672, -0.00957592, -0.00875513, 
--0.00793434, -0.00711354, -0.00629275, -0.00547196, -0.00465116, -0.00383037, 
--0.00300958, -0.00218878, -0.00136799, -0.00054720, 0.00027360, 0.00109439, 
-0.00191518, 0.00273598, 0.00355677, 0.00437756, 0.00519836, 0.00601915, 
-0.00683995, 0.00766074, 0.00848153, 0.00930233, 0.01012312, 0.01094391, 
-0.01176471, 0.01258550, 0.01340629, 0.01422709, 0.01504788, 0.01586867, 
-0.01668947, 0.01751026, 0.01833105, 0.01915185, 0.01997264, 0.02079343, 
-0.02161423, 0.02243502, 0.02325581, 0.02407661, 0.02489740, 0.02571819, 
-0.02653899, 0.02735978, 0.02818057, 0.02900137, 0.02982216, 0.03064295, 
-0.03146375, 0.03228454, 0.03310534, 0.03392613, 0.03474692, 0.03556772, 
-0.03638851, 0.03720930, 0.03803010, 0.03885089, 0.03967168, 0.04049248, 
-0.04131327, 0.04213406, 0.04295486, 0.04377565, 0.04459644, 0.04541724, 
-0.04623803};
-
-#elif POS_FILTER_LENGTH == 87
-inline constexpr float posFilter[87] = {
--0.02220481, -0.02142111, -0.02063741, -0.01985371, -0.01907001, -0.01828631, 
--0.01750261, -0.01671891, -0.01593521, -0.01515152, -0.01436782, -0.01358412, 
--0.01280042, -0.01201672, -0.01123302, -0.01044932, -0.00966562, -0.00888192, 
--0.00809822, -0.00731452, -0.00653083, -0.00574713, -0.00496343, -0.00417973, 
--0.00339603, -0.00261233, -0.00182863, -0.00104493, -0.00026123, 0.00052247, 
-0.00130617, 0.00208986, 0.00287356, 0.00365726, 0.00444096, 0.00522466, 
-0.00600836, 0.00679206, 0.00757576, 0.00835946, 0.00914316, 0.00992685, 
-0.01071055, 0.01149425, 0.01227795, 0.01306165, 0.01384535, 0.01462905, 
-0.01541275, 0.01619645, 0.01698015, 0.01776385, 0.01854754, 0.01933124, 
-0.02011494, 0.02089864, 0.02168234, 0.02246604, 0.02324974, 0.02403344, 
-0.02481714, 0.02560084, 0.02638454, 0.02716823, 0.02795193, 0.02873563, 
-0.02951933, 0.03030303, 0.03108673, 0.03187043, 0.03265413, 0.03343783, 
-0.03422153, 0.03500522, 0.03578892, 0.03657262, 0.03735632, 0.03814002, 
-0.03892372, 0.03970742, 0.04049112, 0.04127482, 0.04205852, 0.04284222, 
-0.04362591, 0.04440961, 0.04519331};
-
-#elif POS_FILTER_LENGTH == 89
-inline constexpr float posFilter[89] = {
--0.02172285, -0.02097378, -0.02022472, -0.01947566, -0.01872659, -0.01797753, 
--0.01722846, -0.01647940, -0.01573034, -0.01498127, -0.01423221, -0.01348315, 
--0.01273408, -0.01198502, -0.01123596, -0.01048689, -0.00973783, -0.00898876, 
--0.00823970, -0.00749064, -0.00674157, -0.00599251, -0.00524345, -0.00449438, 
--0.00374532, -0.00299625, -0.00224719, -0.00149813, -0.00074906, -0.00000000, 
-0.00074906, 0.00149813, 0.00224719, 0.00299625, 0.00374532, 0.00449438, 
-0.00524345, 0.00599251, 0.00674157, 0.00749064, 0.00823970, 0.00898876, 
-0.00973783, 0.01048689, 0.01123596, 0.01198502, 0.01273408, 0.01348315, 
-0.01423221, 0.01498127, 0.01573034, 0.01647940, 0.01722846, 0.01797753, 
-0.01872659, 0.01947566, 0.02022472, 0.02097378, 0.02172285, 0.02247191, 
-0.02322097, 0.02397004, 0.02471910, 0.02546816, 0.02621723, 0.02696629, 
-0.02771536, 0.02846442, 0.02921348, 0.02996255, 0.03071161, 0.03146067, 
-0.03220974, 0.03295880, 0.03370787, 0.03445693, 0.03520599, 0.03595506, 
-0.03670412, 0.03745318, 0.03820225, 0.03895131, 0.03970037, 0.04044944, 
-0.04119850, 0.04194757, 0.04269663, 0.04344569, 0.04419476};
-
-#elif POS_FILTER_LENGTH == 91
-inline constexpr float posFilter[91] = {
--0.02126135, -0.02054467, -0.01982800, -0.01911132, -0.01839465, -0.01767797, 
--0.01696130, -0.01624462, -0.01552795, -0.01481128, -0.01409460, -0.01337793, 
--0.01266125, -0.01194458, -0.01122790, -0.01051123, -0.00979455, -0.00907788, 
--0.00836120, -0.00764453, -0.00692785, -0.00621118, -0.00549451, -0.00477783, 
--0.00406116, -0.00334448, -0.00262781, -0.00191113, -0.00119446, -0.00047778, 
-0.00023889, 0.00095557, 0.00167224, 0.00238892, 0.00310559, 0.00382226, 
-0.00453894, 0.00525561, 0.00597229, 0.00668896, 0.00740564, 0.00812231, 
-0.00883899, 0.00955566, 0.01027234, 0.01098901, 0.01170569, 0.01242236, 
-0.01313903, 0.01385571, 0.01457238, 0.01528906, 0.01600573, 0.01672241, 
-0.01743908, 0.01815576, 0.01887243, 0.01958911, 0.02030578, 0.02102246, 
-0.02173913, 0.02245581, 0.02317248, 0.02388915, 0.02460583, 0.02532250, 
-0.02603918, 0.02675585, 0.02747253, 0.02818920, 0.02890588, 0.02962255, 
-0.03033923, 0.03105590, 0.03177258, 0.03248925, 0.03320592, 0.03392260, 
-0.03463927, 0.03535595, 0.03607262, 0.03678930, 0.03750597, 0.03822265, 
-0.03893932, 0.03965600, 0.04037267, 0.04108935, 0.04180602, 0.04252269, 
-0.04323937};
-
-#elif POS_FILTER_LENGTH == 93
-inline constexpr float posFilter[93] = {
--0.02081903, -0.02013269, -0.01944635, -0.01876001, -0.01807367, -0.01738733, 
--0.01670098, -0.01601464, -0.01532830, -0.01464196, -0.01395562, -0.01326927, 
--0.01258293, -0.01189659, -0.01121025, -0.01052391, -0.00983757, -0.00915122, 
--0.00846488, -0.00777854, -0.00709220, -0.00640586, -0.00571951, -0.00503317, 
--0.00434683, -0.00366049, -0.00297415, -0.00228781, -0.00160146, -0.00091512, 
--0.00022878, 0.00045756, 0.00114390, 0.00183024, 0.00251659, 0.00320293, 
-0.00388927, 0.00457561, 0.00526195, 0.00594830, 0.00663464, 0.00732098, 
-0.00800732, 0.00869366, 0.00938000, 0.01006635, 0.01075269, 0.01143903, 
-0.01212537, 0.01281171, 0.01349806, 0.01418440, 0.01487074, 0.01555708, 
-0.01624342, 0.01692976, 0.01761611, 0.01830245, 0.01898879, 0.01967513, 
-0.02036147, 0.02104782, 0.02173416, 0.02242050, 0.02310684, 0.02379318, 
-0.02447952, 0.02516587, 0.02585221, 0.02653855, 0.02722489, 0.02791123, 
-0.02859757, 0.02928392, 0.02997026, 0.03065660, 0.03134294, 0.03202928, 
-0.03271563, 0.03340197, 0.03408831, 0.03477465, 0.03546099, 0.03614733, 
-0.03683368, 0.03752002, 0.03820636, 0.03889270, 0.03957904, 0.04026539, 
-0.04095173, 0.04163807, 0.04232441};
-
-#elif POS_FILTER_LENGTH == 95
-inline constexpr float posFilter[95] = {
--0.02039474, -0.01973684, -0.01907895, -0.01842105, -0.01776316, -0.01710526, 
--0.01644737, -0.01578947, -0.01513158, -0.01447368, -0.01381579, -0.01315789, 
--0.01250000, -0.01184211, -0.01118421, -0.01052632, -0.00986842, -0.00921053, 
--0.00855263, -0.00789474, -0.00723684, -0.00657895, -0.00592105, -0.00526316, 
--0.00460526, -0.00394737, -0.00328947, -0.00263158, -0.00197368, -0.00131579, 
--0.00065789, 0.00000000, 0.00065789, 0.00131579, 0.00197368, 0.00263158, 
-0.00328947, 0.00394737, 0.00460526, 0.00526316, 0.00592105, 0.00657895, 
-0.00723684, 0.00789474, 0.00855263, 0.00921053, 0.00986842, 0.01052632, 
-0.01118421, 0.01184211, 0.01250000, 0.01315789, 0.01381579, 0.01447368, 
-0.01513158, 0.01578947, 0.01644737, 0.01710526, 0.01776316, 0.01842105, 
-0.01907895, 0.01973684, 0.02039474, 0.02105263, 0.02171053, 0.02236842, 
-0.02302632, 0.02368421, 0.02434211, 0.02500000, 0.02565789, 0.02631579, 
-0.02697368, 0.02763158, 0.02828947, 0.02894737, 0.02960526, 0.03026316, 
-0.03092105, 0.03157895, 0.03223684, 0.03289474, 0.03355263, 0.03421053, 
-0.03486842, 0.03552632, 0.03618421, 0.03684211, 0.03750000, 0.03815789, 
-0.03881579, 0.03947368, 0.04013158, 0.04078947, 0.04144737};
-
-#elif POS_FILTER_LENGTH == 97
-inline constexpr float posFilter[97] = {
--0.01998738, -0.01935620, -0.01872502, -0.01809384, -0.01746266, -0.01683147, 
--0.01620029, -0.01556911, -0.01493793, -0.01430675, -0.01367557, -0.01304439, 
--0.01241321, -0.01178203, -0.01115085, -0.01051967, -0.00988849, -0.00925731, 
--0.00862613, -0.00799495, -0.00736377, -0.00673259, -0.00610141, -0.00547023, 
--0.00483905, -0.00420787, -0.00357669, -0.00294551, -0.00231433, -0.00168315, 
--0.00105197, -0.00042079, 0.00021039, 0.00084157, 0.00147275, 0.00210393, 
-0.00273511, 0.00336629, 0.00399748, 0.00462866, 0.00525984, 0.00589102, 
-0.00652220, 0.00715338, 0.00778456, 0.00841574, 0.00904692, 0.00967810, 
-0.01030928, 0.01094046, 0.01157164, 0.01220282, 0.01283400, 0.01346518, 
-0.01409636, 0.01472754, 0.01535872, 0.01598990, 0.01662108, 0.01725226, 
-0.01788344, 0.01851462, 0.01914580, 0.01977698, 0.02040816, 0.02103934, 
-0.02167052, 0.02230170, 0.02293288, 0.02356406, 0.02419525, 0.02482643, 
-0.02545761, 0.02608879, 0.02671997, 0.02735115, 0.02798233, 0.02861351, 
-0.02924469, 0.02987587, 0.03050705, 0.03113823, 0.03176941, 0.03240059, 
-0.03303177, 0.03366295, 0.03429413, 0.03492531, 0.03555649, 0.03618767, 
-0.03681885, 0.03745003, 0.03808121, 0.03871239, 0.03934357, 0.03997475, 
-0.04060593};
-
-#elif POS_FILTER_LENGTH == 99
-inline constexpr float posFilter[99] = {
--0.01959596, -0.01898990, -0.01838384, -0.01777778, -0.01717172, -0.01656566, 
--0.01595960, -0.01535354, -0.01474747, -0.01414141, -0.01353535, -0.01292929, 
--0.01232323, -0.01171717, -0.01111111, -0.01050505, -0.00989899, -0.00929293, 
--0.00868687, -0.00808081, -0.00747475, -0.00686869, -0.00626263, -0.00565657, 
--0.00505051, -0.00444444, -0.00383838, -0.00323232, -0.00262626, -0.00202020, 
--0.00141414, -0.00080808, -0.00020202, 0.00040404, 0.00101010, 0.00161616, 
-0.00222222, 0.00282828, 0.00343434, 0.00404040, 0.00464646, 0.00525253, 
-0.00585859, 0.00646465, 0.00707071, 0.00767677, 0.00828283, 0.00888889, 
-0.00949495, 0.01010101, 0.01070707, 0.01131313, 0.01191919, 0.01252525, 
-0.01313131, 0.01373737, 0.01434343, 0.01494949, 0.01555556, 0.01616162, 
-0.01676768, 0.01737374, 0.01797980, 0.01858586, 0.01919192, 0.01979798, 
-0.02040404, 0.02101010, 0.02161616, 0.02222222, 0.02282828, 0.02343434, 
-0.02404040, 0.02464646, 0.02525253, 0.02585859, 0.02646465, 0.02707071, 
-0.02767677, 0.02828283, 0.02888889, 0.02949495, 0.03010101, 0.03070707, 
-0.03131313, 0.03191919, 0.03252525, 0.03313131, 0.03373737, 0.03434343, 
-0.03494949, 0.03555556, 0.03616162, 0.03676768, 0.03737374, 0.03797980, 
-0.03858586, 0.03919192, 0.03979798};
-
-#endif 
-
-#if SPEED_FILTER_LENGTH == 3
-inline constexpr float speedFilter[3] = {
--0.50000000, 0.00000000, 0.50000000};
-
-#elif SPEED_FILTER_LENGTH == 5
-inline constexpr float speedFilter[5] = {
--0.20000000, -0.10000000, 0.00000000, 0.10000000, 0.20000000};
-
-#elif SPEED_FILTER_LENGTH == 7
-inline constexpr float speedFilter[7] = {
--0.10714286, -0.07142857, -0.03571429, 0.00000000, 0.03571429, 0.07142857, 
-0.10714286};
-
-#elif SPEED_FILTER_LENGTH == 9
-inline constexpr float speedFilter[9] = {
--0.06666667, -0.05000000, -0.03333333, -0.01666667, 0.00000000, 0.01666667, 
-0.03333333, 0.05000000, 0.06666667};
-
-#elif SPEED_FILTER_LENGTH == 11
-inline constexpr float speedFilter[11] = {
--0.04545455, -0.03636364, -0.02727273, -0.01818182, -0.00909091, 0.00000000, 
-0.00909091, 0.01818182, 0.02727273, 0.03636364, 0.04545455};
-
-#elif SPEED_FILTER_LENGTH == 13
-inline constexpr float speedFilter[13] = {
--0.03296703, -0.02747253, -0.02197802, -0.01648352, -0.01098901, -0.00549451, 
--0.00000000, 0.00549451, 0.01098901, 0.01648352, 0.02197802, 0.02747253, 
-0.03296703};
-
-#elif SPEED_FILTER_LENGTH == 15
-inline constexpr float speedFilter[15] = {
--0.02500000, -0.02142857, -0.01785714, -0.01428571, -0.01071429, -0.00714286, 
--0.00357143, -0.00000000, 0.00357143, 0.00714286, 0.01071429, 0.01428571, 
-0.01785714, 0.02142857, 0.02500000};
-
-#elif SPEED_FILTER_LENGTH == 17
-inline constexpr float speedFilter[17] = {
--0.01960784, -0.01715686, -0.01470588, -0.01225490, -0.00980392, -0.00735294, 
--0.00490196, -0.00245098, -0.00000000, 0.00245098, 0.00490196, 0.00735294, 
-0.00980392, 0.01225490, 0.01470588, 0.01715686, 0.01960784};
-
-#elif SPEED_FILTER_LENGTH == 19
-inline constexpr float speedFilter[19] = {
--0.01578947, -0.01403509, -0.01228070, -0.01052632, -0.00877193, -0.00701754, 
--0.00526316, -0.00350877, -0.00175439, 0.00000000, 0.00175439, 0.00350877, 
-0.00526316, 0.00701754, 0.00877193, 0.01052632, 0.01228070, 0.01403509, 
-0.01578947};
-
-#elif SPEED_FILTER_LENGTH == 21
-inline constexpr float speedFilter[21] = {
--0.01298701, -0.01168831, -0.01038961, -0.00909091, -0.00779221, -0.00649351, 
--0.00519481, -0.00389610, -0.00259740, -0.00129870, -0.00000000, 0.00129870, 
-0.00259740, 0.00389610, 0.00519481, 0.00649351, 0.00779221, 0.00909091, 
-0.01038961, 0.01168831, 0.01298701};
-
-#elif SPEED_FILTER_LENGTH == 23
-inline constexpr float speedFilter[23] = {
--0.01086957, -0.00988142, -0.00889328, -0.00790514, -0.00691700, -0.00592885, 
--0.00494071, -0.00395257, -0.00296443, -0.00197628, -0.00098814, -0.00000000, 
-0.00098814, 0.00197628, 0.00296443, 0.00395257, 0.00494071, 0.00592885, 
-0.00691700, 0.00790514, 0.00889328, 0.00988142, 0.01086957};
-
-#elif SPEED_FILTER_LENGTH == 25
-inline constexpr float speedFilter[25] = {
--0.00923077, -0.00846154, -0.00769231, -0.00692308, -0.00615385, -0.00538462, 
--0.00461538, -0.00384615, -0.00307692, -0.00230769, -0.00153846, -0.00076923, 
--0.00000000, 0.00076923, 0.00153846, 0.00230769, 0.00307692, 0.00384615, 
-0.00461538, 0.00538462, 0.00615385, 0.00692308, 0.00769231, 0.00846154, 
-0.00923077};
-
-#elif SPEED_FILTER_LENGTH == 27
-inline constexpr float speedFilter[27] = {
--0.00793651, -0.00732601, -0.00671551, -0.00610501, -0.00549451, -0.00488400, 
--0.00427350, -0.00366300, -0.00305250, -0.00244200, -0.00183150, -0.00122100, 
--0.00061050, 0.00000000, 0.00061050, 0.00122100, 0.00183150, 0.00244200, 
-0.00305250, 0.00366300, 0.00427350, 0.00488400, 0.00549451, 0.00610501, 
-0.00671551, 0.00732601, 0.00793651};
-
-#elif SPEED_FILTER_LENGTH == 29
-inline constexpr float speedFilter[29] = {
--0.00689655, -0.00640394, -0.00591133, -0.00541872, -0.00492611, -0.00443350, 
--0.00394089, -0.00344828, -0.00295567, -0.00246305, -0.00197044, -0.00147783, 
--0.00098522, -0.00049261, -0.00000000, 0.00049261, 0.00098522, 0.00147783, 
-0.00197044, 0.00246305, 0.00295567, 0.00344828, 0.00394089, 0.00443350, 
-0.00492611, 0.00541872, 0.00591133, 0.00640394, 0.00689655};
-
-#elif SPEED_FILTER_LENGTH == 31
-inline constexpr float speedFilter[31] = {
--0.00604839, -0.00564516, -0.00524194, -0.00483871, -0.00443548, -0.00403226, 
--0.00362903, -0.00322581, -0.00282258, -0.00241935, -0.00201613, -0.00161290, 
--0.00120968, -0.00080645, -0.00040323, 0.00000000, 0.00040323, 0.00080645, 
-0.00120968, 0.00161290, 0.00201613, 0.00241935, 0.00282258, 0.00322581, 
-0.00362903, 0.00403226, 0.00443548, 0.00483871, 0.00524194, 0.00564516, 
-0.00604839};
-
-#elif SPEED_FILTER_LENGTH == 33
-inline constexpr float speedFilter[33] = {
--0.00534759, -0.00501337, -0.00467914, -0.00434492, -0.00401070, -0.00367647, 
--0.00334225, -0.00300802, -0.00267380, -0.00233957, -0.00200535, -0.00167112, 
--0.00133690, -0.00100267, -0.00066845, -0.00033422, 0.00000000, 0.00033422, 
-0.00066845, 0.00100267, 0.00133690, 0.00167112, 0.00200535, 0.00233957, 
-0.00267380, 0.00300802, 0.00334225, 0.00367647, 0.00401070, 0.00434492, 
-0.00467914, 0.00501337, 0.00534759};
-
-#elif SPEED_FILTER_LENGTH == 35
-inline constexpr float speedFilter[35] = {
--0.00476190, -0.00448179, -0.00420168, -0.00392157, -0.00364146, -0.00336134, 
--0.00308123, -0.00280112, -0.00252101, -0.00224090, -0.00196078, -0.00168067, 
--0.00140056, -0.00112045, -0.00084034, -0.00056022, -0.00028011, 0.00000000, 
-0.00028011, 0.00056022, 0.00084034, 0.00112045, 0.00140056, 0.00168067, 
-0.00196078, 0.00224090, 0.00252101, 0.00280112, 0.00308123, 0.00336134, 
-0.00364146, 0.00392157, 0.00420168, 0.00448179, 0.00476190};
-
-#elif SPEED_FILTER_LENGTH == 37
-inline constexpr float speedFilter[37] = {
--0.00426743, -0.00403035, -0.00379327, -0.00355619, -0.00331911, -0.00308203, 
--0.00284495, -0.00260787, -0.00237079, -0.00213371, -0.00189663, -0.00165955, 
--0.00142248, -0.00118540, -0.00094832, -0.00071124, -0.00047416, -0.00023708, 
-0.00000000, 0.00023708, 0.00047416, 0.00071124, 0.00094832, 0.00118540, 
-0.00142248, 0.00165955, 0.00189663, 0.00213371, 0.00237079, 0.00260787, 
-0.00284495, 0.00308203, 0.00331911, 0.00355619, 0.00379327, 0.00403035, 
-0.00426743};
-
-#elif SPEED_FILTER_LENGTH == 39
-inline constexpr float speedFilter[39] = {
--0.00384615, -0.00364372, -0.00344130, -0.00323887, -0.00303644, -0.00283401, 
--0.00263158, -0.00242915, -0.00222672, -0.00202429, -0.00182186, -0.00161943, 
--0.00141700, -0.00121457, -0.00101215, -0.00080972, -0.00060729, -0.00040486, 
--0.00020243, -0.00000000, 0.00020243, 0.00040486, 0.00060729, 0.00080972, 
-0.00101215, 0.00121457, 0.00141700, 0.00161943, 0.00182186, 0.00202429, 
-0.00222672, 0.00242915, 0.00263158, 0.00283401, 0.00303644, 0.00323887, 
-0.00344130, 0.00364372, 0.00384615};
-
-#elif SPEED_FILTER_LENGTH == 41
-inline constexpr float speedFilter[41] = {
--0.00348432, -0.00331010, -0.00313589, -0.00296167, -0.00278746, -0.00261324, 
--0.00243902, -0.00226481, -0.00209059, -0.00191638, -0.00174216, -0.00156794, 
--0.00139373, -0.00121951, -0.00104530, -0.00087108, -0.00069686, -0.00052265, 
--0.00034843, -0.00017422, 0.00000000, 0.00017422, 0.00034843, 0.00052265, 
-0.00069686, 0.00087108, 0.00104530, 0.00121951, 0.00139373, 0.00156794, 
-0.00174216, 0.00191638, 0.00209059, 0.00226481, 0.00243902, 0.00261324, 
-0.00278746, 0.00296167, 0.00313589, 0.00331010, 0.00348432};
-
-#elif SPEED_FILTER_LENGTH == 43
-inline constexpr float speedFilter[43] = {
--0.00317125, -0.00302024, -0.00286922, -0.00271821, -0.00256720, -0.00241619, 
--0.00226518, -0.00211416, -0.00196315, -0.00181214, -0.00166113, -0.00151012, 
--0.00135911, -0.00120809, -0.00105708, -0.00090607, -0.00075506, -0.00060405, 
--0.00045304, -0.00030202, -0.00015101, -0.00000000, 0.00015101, 0.00030202, 
-0.00045304, 0.00060405, 0.00075506, 0.00090607, 0.00105708, 0.00120809, 
-0.00135911, 0.00151012, 0.00166113, 0.00181214, 0.00196315, 0.00211416, 
-0.00226518, 0.00241619, 0.00256720, 0.00271821, 0.00286922, 0.00302024, 
-0.00317125};
-
-#elif SPEED_FILTER_LENGTH == 45
-inline constexpr float speedFilter[45] = {
--0.00289855, -0.00276680, -0.00263505, -0.00250329, -0.00237154, -0.00223979, 
--0.00210804, -0.00197628, -0.00184453, -0.00171278, -0.00158103, -0.00144928, 
--0.00131752, -0.00118577, -0.00105402, -0.00092227, -0.00079051, -0.00065876, 
--0.00052701, -0.00039526, -0.00026350, -0.00013175, 0.00000000, 0.00013175, 
-0.00026350, 0.00039526, 0.00052701, 0.00065876, 0.00079051, 0.00092227, 
-0.00105402, 0.00118577, 0.00131752, 0.00144928, 0.00158103, 0.00171278, 
-0.00184453, 0.00197628, 0.00210804, 0.00223979, 0.00237154, 0.00250329, 
-0.00263505, 0.00276680, 0.00289855};
-
-#elif SPEED_FILTER_LENGTH == 47
-inline constexpr float speedFilter[47] = {
--0.00265957, -0.00254394, -0.00242831, -0.00231267, -0.00219704, -0.00208141, 
--0.00196577, -0.00185014, -0.00173451, -0.00161887, -0.00150324, -0.00138760, 
--0.00127197, -0.00115634, -0.00104070, -0.00092507, -0.00080944, -0.00069380, 
--0.00057817, -0.00046253, -0.00034690, -0.00023127, -0.00011563, 0.00000000, 
-0.00011563, 0.00023127, 0.00034690, 0.00046253, 0.00057817, 0.00069380, 
-0.00080944, 0.00092507, 0.00104070, 0.00115634, 0.00127197, 0.00138760, 
-0.00150324, 0.00161887, 0.00173451, 0.00185014, 0.00196577, 0.00208141, 
-0.00219704, 0.00231267, 0.00242831, 0.00254394, 0.00265957};
-
-#elif SPEED_FILTER_LENGTH == 49
-inline constexpr float speedFilter[49] = {
--0.00244898, -0.00234694, -0.00224490, -0.00214286, -0.00204082, -0.00193878, 
--0.00183673, -0.00173469, -0.00163265, -0.00153061, -0.00142857, -0.00132653, 
--0.00122449, -0.00112245, -0.00102041, -0.00091837, -0.00081633, -0.00071429, 
--0.00061224, -0.00051020, -0.00040816, -0.00030612, -0.00020408, -0.00010204, 
--0.00000000, 0.00010204, 0.00020408, 0.00030612, 0.00040816, 0.00051020, 
-0.00061224, 0.00071429, 0.00081633, 0.00091837, 0.00102041, 0.00112245, 
-0.00122449, 0.00132653, 0.00142857, 0.00153061, 0.00163265, 0.00173469, 
-0.00183673, 0.00193878, 0.00204082, 0.00214286, 0.00224490, 0.00234694, 
-0.00244898};
-
-#elif SPEED_FILTER_LENGTH == 51
-inline constexpr float speedFilter[51] = {
--0.00226244, -0.00217195, -0.00208145, -0.00199095, -0.00190045, -0.00180995, 
--0.00171946, -0.00162896, -0.00153846, -0.00144796, -0.00135747, -0.00126697, 
--0.00117647, -0.00108597, -0.00099548, -0.00090498, -0.00081448, -0.00072398, 
--0.00063348, -0.00054299, -0.00045249, -0.00036199, -0.00027149, -0.00018100, 
--0.00009050, 0.00000000, 0.00009050, 0.00018100, 0.00027149, 0.00036199, 
-0.00045249, 0.00054299, 0.00063348, 0.00072398, 0.00081448, 0.00090498, 
-0.00099548, 0.00108597, 0.00117647, 0.00126697, 0.00135747, 0.00144796, 
-0.00153846, 0.00162896, 0.00171946, 0.00180995, 0.00190045, 0.00199095, 
-0.00208145, 0.00217195, 0.00226244};
-
-#elif SPEED_FILTER_LENGTH == 53
-inline constexpr float speedFilter[53] = {
--0.00209644, -0.00201580, -0.00193517, -0.00185454, -0.00177391, -0.00169328, 
--0.00161264, -0.00153201, -0.00145138, -0.00137075, -0.00129011, -0.00120948, 
--0.00112885, -0.00104822, -0.00096759, -0.00088695, -0.00080632, -0.00072569, 
--0.00064506, -0.00056443, -0.00048379, -0.00040316, -0.00032253, -0.00024190, 
--0.00016126, -0.00008063, -0.00000000, 0.00008063, 0.00016126, 0.00024190, 
-0.00032253, 0.00040316, 0.00048379, 0.00056443, 0.00064506, 0.00072569, 
-0.00080632, 0.00088695, 0.00096759, 0.00104822, 0.00112885, 0.00120948, 
-0.00129011, 0.00137075, 0.00145138, 0.00153201, 0.00161264, 0.00169328, 
-0.00177391, 0.00185454, 0.00193517, 0.00201580, 0.00209644};
-
-#elif SPEED_FILTER_LENGTH == 55
-inline constexpr float speedFilter[55] = {
--0.00194805, -0.00187590, -0.00180375, -0.00173160, -0.00165945, -0.00158730, 
--0.00151515, -0.00144300, -0.00137085, -0.00129870, -0.00122655, -0.00115440, 
--0.00108225, -0.00101010, -0.00093795, -0.00086580, -0.00079365, -0.00072150, 
--0.00064935, -0.00057720, -0.00050505, -0.00043290, -0.00036075, -0.00028860, 
--0.00021645, -0.00014430, -0.00007215, -0.00000000, 0.00007215, 0.00014430, 
-0.00021645, 0.00028860, 0.00036075, 0.00043290, 0.00050505, 0.00057720, 
-0.00064935, 0.00072150, 0.00079365, 0.00086580, 0.00093795, 0.00101010, 
-0.00108225, 0.00115440, 0.00122655, 0.00129870, 0.00137085, 0.00144300, 
-0.00151515, 0.00158730, 0.00165945, 0.00173160, 0.00180375, 0.00187590, 
-0.00194805};
-
-#elif SPEED_FILTER_LENGTH == 57
-inline constexpr float speedFilter[57] = {
--0.00181488, -0.00175006, -0.00168525, -0.00162043, -0.00155561, -0.00149080, 
--0.00142598, -0.00136116, -0.00129634, -0.00123153, -0.00116671, -0.00110189, 
--0.00103708, -0.00097226, -0.00090744, -0.00084262, -0.00077781, -0.00071299, 
--0.00064817, -0.00058335, -0.00051854, -0.00045372, -0.00038890, -0.00032409, 
--0.00025927, -0.00019445, -0.00012963, -0.00006482, -0.00000000, 0.00006482, 
-0.00012963, 0.00019445, 0.00025927, 0.00032409, 0.00038890, 0.00045372, 
-0.00051854, 0.00058335, 0.00064817, 0.00071299, 0.00077781, 0.00084262, 
-0.00090744, 0.00097226, 0.00103708, 0.00110189, 0.00116671, 0.00123153, 
-0.00129634, 0.00136116, 0.00142598, 0.00149080, 0.00155561, 0.00162043, 
-0.00168525, 0.00175006, 0.00181488};
-
-#elif SPEED_FILTER_LENGTH == 59
-inline constexpr float speedFilter[59] = {
--0.00169492, -0.00163647, -0.00157802, -0.00151958, -0.00146113, -0.00140269, 
--0.00134424, -0.00128580, -0.00122735, -0.00116891, -0.00111046, -0.00105202, 
--0.00099357, -0.00093513, -0.00087668, -0.00081823, -0.00075979, -0.00070134, 
--0.00064290, -0.00058445, -0.00052601, -0.00046756, -0.00040912, -0.00035067, 
--0.00029223, -0.00023378, -0.00017534, -0.00011689, -0.00005845, 0.00000000, 
-0.00005845, 0.00011689, 0.00017534, 0.00023378, 0.00029223, 0.00035067, 
-0.00040912, 0.00046756, 0.00052601, 0.00058445, 0.00064290, 0.00070134, 
-0.00075979, 0.00081823, 0.00087668, 0.00093513, 0.00099357, 0.00105202, 
-0.00111046, 0.00116891, 0.00122735, 0.00128580, 0.00134424, 0.00140269, 
-0.00146113, 0.00151958, 0.00157802, 0.00163647, 0.00169492};
-
-#elif SPEED_FILTER_LENGTH == 61
-inline constexpr float speedFilter[61] = {
--0.00158646, -0.00153358, -0.00148070, -0.00142782, -0.00137493, -0.00132205, 
--0.00126917, -0.00121629, -0.00116341, -0.00111052, -0.00105764, -0.00100476, 
--0.00095188, -0.00089900, -0.00084611, -0.00079323, -0.00074035, -0.00068747, 
--0.00063458, -0.00058170, -0.00052882, -0.00047594, -0.00042306, -0.00037017, 
--0.00031729, -0.00026441, -0.00021153, -0.00015865, -0.00010576, -0.00005288, 
-0.00000000, 0.00005288, 0.00010576, 0.00015865, 0.00021153, 0.00026441, 
-0.00031729, 0.00037017, 0.00042306, 0.00047594, 0.00052882, 0.00058170, 
-0.00063458, 0.00068747, 0.00074035, 0.00079323, 0.00084611, 0.00089900, 
-0.00095188, 0.00100476, 0.00105764, 0.00111052, 0.00116341, 0.00121629, 
-0.00126917, 0.00132205, 0.00137493, 0.00142782, 0.00148070, 0.00153358, 
-0.00158646};
-
-#elif SPEED_FILTER_LENGTH == 63
-inline constexpr float speedFilter[63] = {
--0.00148810, -0.00144009, -0.00139209, -0.00134409, -0.00129608, -0.00124808, 
--0.00120008, -0.00115207, -0.00110407, -0.00105607, -0.00100806, -0.00096006, 
--0.00091206, -0.00086406, -0.00081605, -0.00076805, -0.00072005, -0.00067204, 
--0.00062404, -0.00057604, -0.00052803, -0.00048003, -0.00043203, -0.00038402, 
--0.00033602, -0.00028802, -0.00024002, -0.00019201, -0.00014401, -0.00009601, 
--0.00004800, -0.00000000, 0.00004800, 0.00009601, 0.00014401, 0.00019201, 
-0.00024002, 0.00028802, 0.00033602, 0.00038402, 0.00043203, 0.00048003, 
-0.00052803, 0.00057604, 0.00062404, 0.00067204, 0.00072005, 0.00076805, 
-0.00081605, 0.00086406, 0.00091206, 0.00096006, 0.00100806, 0.00105607, 
-0.00110407, 0.00115207, 0.00120008, 0.00124808, 0.00129608, 0.00134409, 
-0.00139209, 0.00144009, 0.00148810};
-
-#elif SPEED_FILTER_LENGTH == 65
-inline constexpr float speedFilter[65] = {
--0.00139860, -0.00135490, -0.00131119, -0.00126748, -0.00122378, -0.00118007, 
--0.00113636, -0.00109266, -0.00104895, -0.00100524, -0.00096154, -0.00091783, 
--0.00087413, -0.00083042, -0.00078671, -0.00074301, -0.00069930, -0.00065559, 
--0.00061189, -0.00056818, -0.00052448, -0.00048077, -0.00043706, -0.00039336, 
--0.00034965, -0.00030594, -0.00026224, -0.00021853, -0.00017483, -0.00013112, 
--0.00008741, -0.00004371, -0.00000000, 0.00004371, 0.00008741, 0.00013112, 
-0.00017483, 0.00021853, 0.00026224, 0.00030594, 0.00034965, 0.00039336, 
-0.00043706, 0.00048077, 0.00052448, 0.00056818, 0.00061189, 0.00065559, 
-0.00069930, 0.00074301, 0.00078671, 0.00083042, 0.00087413, 0.00091783, 
-0.00096154, 0.00100524, 0.00104895, 0.00109266, 0.00113636, 0.00118007, 
-0.00122378, 0.00126748, 0.00131119, 0.00135490, 0.00139860};
-
-#elif SPEED_FILTER_LENGTH == 67
-inline constexpr float speedFilter[67] = {
--0.00131694, -0.00127704, -0.00123713, -0.00119722, -0.00115732, -0.00111741, 
--0.00107750, -0.00103759, -0.00099769, -0.00095778, -0.00091787, -0.00087796, 
--0.00083806, -0.00079815, -0.00075824, -0.00071833, -0.00067843, -0.00063852, 
--0.00059861, -0.00055870, -0.00051880, -0.00047889, -0.00043898, -0.00039907, 
--0.00035917, -0.00031926, -0.00027935, -0.00023944, -0.00019954, -0.00015963, 
--0.00011972, -0.00007981, -0.00003991, 0.00000000, 0.00003991, 0.00007981, 
-0.00011972, 0.00015963, 0.00019954, 0.00023944, 0.00027935, 0.00031926, 
-0.00035917, 0.00039907, 0.00043898, 0.00047889, 0.00051880, 0.00055870, 
-0.00059861, 0.00063852, 0.00067843, 0.00071833, 0.00075824, 0.00079815, 
-0.00083806, 0.00087796, 0.00091787, 0.00095778, 0.00099769, 0.00103759, 
-0.00107750, 0.00111741, 0.00115732, 0.00119722, 0.00123713, 0.00127704, 
-0.00131694};
-
-#elif SPEED_FILTER_LENGTH == 69
-inline constexpr float speedFilter[69] = {
--0.00124224, -0.00120570, -0.00116916, -0.00113263, -0.00109609, -0.00105955, 
--0.00102302, -0.00098648, -0.00094995, -0.00091341, -0.00087687, -0.00084034, 
--0.00080380, -0.00076726, -0.00073073, -0.00069419, -0.00065765, -0.00062112, 
--0.00058458, -0.00054805, -0.00051151, -0.00047497, -0.00043844, -0.00040190, 
--0.00036536, -0.00032883, -0.00029229, -0.00025575, -0.00021922, -0.00018268, 
--0.00014615, -0.00010961, -0.00007307, -0.00003654, -0.00000000, 0.00003654, 
-0.00007307, 0.00010961, 0.00014615, 0.00018268, 0.00021922, 0.00025575, 
-0.00029229, 0.00032883, 0.00036536, 0.00040190, 0.00043844, 0.00047497, 
-0.00051151, 0.00054805, 0.00058458, 0.00062112, 0.00065765, 0.00069419, 
-0.00073073, 0.00076726, 0.00080380, 0.00084034, 0.00087687, 0.00091341, 
-0.00094995, 0.00098648, 0.00102302, 0.00105955, 0.00109609, 0.00113263, 
-0.00116916, 0.00120570, 0.00124224};
-
-#elif SPEED_FILTER_LENGTH == 71
-inline constexpr float speedFilter[71] = {
--0.00117371, -0.00114017, -0.00110664, -0.00107311, -0.00103957, -0.00100604, 
--0.00097250, -0.00093897, -0.00090543, -0.00087190, -0.00083836, -0.00080483, 
--0.00077129, -0.00073776, -0.00070423, -0.00067069, -0.00063716, -0.00060362, 
--0.00057009, -0.00053655, -0.00050302, -0.00046948, -0.00043595, -0.00040241, 
--0.00036888, -0.00033535, -0.00030181, -0.00026828, -0.00023474, -0.00020121, 
--0.00016767, -0.00013414, -0.00010060, -0.00006707, -0.00003353, -0.00000000, 
-0.00003353, 0.00006707, 0.00010060, 0.00013414, 0.00016767, 0.00020121, 
-0.00023474, 0.00026828, 0.00030181, 0.00033535, 0.00036888, 0.00040241, 
-0.00043595, 0.00046948, 0.00050302, 0.00053655, 0.00057009, 0.00060362, 
-0.00063716, 0.00067069, 0.00070423, 0.00073776, 0.00077129, 0.00080483, 
-0.00083836, 0.00087190, 0.00090543, 0.00093897, 0.00097250, 0.00100604, 
-0.00103957, 0.00107311, 0.00110664, 0.00114017, 0.00117371};
-
-#elif SPEED_FILTER_LENGTH == 73
-inline constexpr float speedFilter[73] = {
--0.00111070, -0.00107985, -0.00104899, -0.00101814, -0.00098729, -0.00095644, 
--0.00092558, -0.00089473, -0.00086388, -0.00083302, -0.00080217, -0.00077132, 
--0.00074047, -0.00070961, -0.00067876, -0.00064791, -0.00061706, -0.00058620, 
--0.00055535, -0.00052450, -0.00049364, -0.00046279, -0.00043194, -0.00040109, 
--0.00037023, -0.00033938, -0.00030853, -0.00027767, -0.00024682, -0.00021597, 
--0.00018512, -0.00015426, -0.00012341, -0.00009256, -0.00006171, -0.00003085, 
--0.00000000, 0.00003085, 0.00006171, 0.00009256, 0.00012341, 0.00015426, 
-0.00018512, 0.00021597, 0.00024682, 0.00027767, 0.00030853, 0.00033938, 
-0.00037023, 0.00040109, 0.00043194, 0.00046279, 0.00049364, 0.00052450, 
-0.00055535, 0.00058620, 0.00061706, 0.00064791, 0.00067876, 0.00070961, 
-0.00074047, 0.00077132, 0.00080217, 0.00083302, 0.00086388, 0.00089473, 
-0.00092558, 0.00095644, 0.00098729, 0.00101814, 0.00104899, 0.00107985, 
-0.00111070};
-
-#elif SPEED_FILTER_LENGTH == 75
-inline constexpr float speedFilter[75] = {
--0.00105263, -0.00102418, -0.00099573, -0.00096728, -0.00093883, -0.00091038, 
--0.00088193, -0.00085349, -0.00082504, -0.00079659, -0.00076814, -0.00073969, 
--0.00071124, -0.00068279, -0.00065434, -0.00062589, -0.00059744, -0.00056899, 
--0.00054054, -0.00051209, -0.00048364, -0.00045519, -0.00042674, -0.00039829, 
--0.00036984, -0.00034139, -0.00031294, -0.00028450, -0.00025605, -0.00022760, 
--0.00019915, -0.00017070, -0.00014225, -0.00011380, -0.00008535, -0.00005690, 
--0.00002845, -0.00000000, 0.00002845, 0.00005690, 0.00008535, 0.00011380, 
-0.00014225, 0.00017070, 0.00019915, 0.00022760, 0.00025605, 0.00028450, 
-0.00031294, 0.00034139, 0.00036984, 0.00039829, 0.00042674, 0.00045519, 
-0.00048364, 0.00051209, 0.00054054, 0.00056899, 0.00059744, 0.00062589, 
-0.00065434, 0.00068279, 0.00071124, 0.00073969, 0.00076814, 0.00079659, 
-0.00082504, 0.00085349, 0.00088193, 0.00091038, 0.00093883, 0.00096728, 
-0.00099573, 0.00102418, 0.00105263};
-
-#elif SPEED_FILTER_LENGTH == 77
-inline constexpr float speedFilter[77] = {
--0.00099900, -0.00097271, -0.00094642, -0.00092013, -0.00089384, -0.00086755, 
--0.00084126, -0.00081497, -0.00078868, -0.00076240, -0.00073611, -0.00070982, 
--0.00068353, -0.00065724, -0.00063095, -0.00060466, -0.00057837, -0.00055208, 
--0.00052579, -0.00049950, -0.00047321, -0.00044692, -0.00042063, -0.00039434, 
--0.00036805, -0.00034176, -0.00031547, -0.00028918, -0.00026289, -0.00023661, 
--0.00021032, -0.00018403, -0.00015774, -0.00013145, -0.00010516, -0.00007887, 
--0.00005258, -0.00002629, -0.00000000, 0.00002629, 0.00005258, 0.00007887, 
-0.00010516, 0.00013145, 0.00015774, 0.00018403, 0.00021032, 0.00023661, 
-0.00026289, 0.00028918, 0.00031547, 0.00034176, 0.00036805, 0.00039434, 
-0.00042063, 0.00044692, 0.00047321, 0.00049950, 0.00052579, 0.00055208, 
-0.00057837, 0.00060466, 0.00063095, 0.00065724, 0.00068353, 0.00070982, 
-0.00073611, 0.00076240, 0.00078868, 0.00081497, 0.00084126, 0.00086755, 
-0.00089384, 0.00092013, 0.00094642, 0.00097271, 0.00099900};
-
-#elif SPEED_FILTER_LENGTH == 79
-inline constexpr float speedFilter[79] = {
--0.00094937, -0.00092502, -0.00090068, -0.00087634, -0.00085200, -0.00082765, 
--0.00080331, -0.00077897, -0.00075463, -0.00073028, -0.00070594, -0.00068160, 
--0.00065725, -0.00063291, -0.00060857, -0.00058423, -0.00055988, -0.00053554, 
--0.00051120, -0.00048685, -0.00046251, -0.00043817, -0.00041383, -0.00038948, 
--0.00036514, -0.00034080, -0.00031646, -0.00029211, -0.00026777, -0.00024343, 
--0.00021908, -0.00019474, -0.00017040, -0.00014606, -0.00012171, -0.00009737, 
--0.00007303, -0.00004869, -0.00002434, -0.00000000, 0.00002434, 0.00004869, 
-0.00007303, 0.00009737, 0.00012171, 0.00014606, 0.00017040, 0.00019474, 
-0.00021908, 0.00024343, 0.00026777, 0.00029211, 0.00031646, 0.00034080, 
-0.00036514, 0.00038948, 0.00041383, 0.00043817, 0.00046251, 0.00048685, 
-0.00051120, 0.00053554, 0.00055988, 0.00058423, 0.00060857, 0.00063291, 
-0.00065725, 0.00068160, 0.00070594, 0.00073028, 0.00075463, 0.00077897, 
-0.00080331, 0.00082765, 0.00085200, 0.00087634, 0.00090068, 0.00092502, 
-0.00094937};
-
-#elif SPEED_FILTER_LENGTH == 81
-inline constexpr float speedFilter[81] = {
--0.00090334, -0.00088076, -0.00085818, -0.00083559, -0.00081301, -0.00079042, 
--0.00076784, -0.00074526, -0.00072267, -0.00070009, -0.00067751, -0.00065492, 
--0.00063234, -0.00060976, -0.00058717, -0.00056459, -0.00054201, -0.00051942, 
--0.00049684, -0.00047425, -0.00045167, -0.00042909, -0.00040650, -0.00038392, 
--0.00036134, -0.00033875, -0.00031617, -0.00029359, -0.00027100, -0.00024842, 
--0.00022584, -0.00020325, -0.00018067, -0.00015808, -0.00013550, -0.00011292, 
--0.00009033, -0.00006775, -0.00004517, -0.00002258, 0.00000000, 0.00002258, 
-0.00004517, 0.00006775, 0.00009033, 0.00011292, 0.00013550, 0.00015808, 
-0.00018067, 0.00020325, 0.00022584, 0.00024842, 0.00027100, 0.00029359, 
-0.00031617, 0.00033875, 0.00036134, 0.00038392, 0.00040650, 0.00042909, 
-0.00045167, 0.00047425, 0.00049684, 0.00051942, 0.00054201, 0.00056459, 
-0.00058717, 0.00060976, 0.00063234, 0.00065492, 0.00067751, 0.00070009, 
-0.00072267, 0.00074526, 0.00076784, 0.00079042, 0.00081301, 0.00083559, 
-0.00085818, 0.00088076, 0.00090334};
-
-#elif SPEED_FILTER_LENGTH == 83
-inline constexpr float speedFilter[83] = {
--0.00086059, -0.00083960, -0.00081861, -0.00079762, -0.00077663, -0.00075564, 
--0.00073465, -0.00071366, -0.00069267, -0.00067168, -0.00065069, -0.00062970, 
--0.00060871, -0.00058772, -0.00056673, -0.00054574, -0.00052475, -0.00050376, 
--0.00048277, -0.00046178, -0.00044079, -0.00041980, -0.00039881, -0.00037782, 
--0.00035683, -0.00033584, -0.00031485, -0.00029386, -0.00027287, -0.00025188, 
--0.00023089, -0.00020990, -0.00018891, -0.00016792, -0.00014693, -0.00012594, 
--0.00010495, -0.00008396, -0.00006297, -0.00004198, -0.00002099, -0.00000000, 
-0.00002099, 0.00004198, 0.00006297, 0.00008396, 0.00010495, 0.00012594, 
-0.00014693, 0.00016792, 0.00018891, 0.00020990, 0.00023089, 0.00025188, 
-0.00027287, 0.00029386, 0.00031485, 0.00033584, 0.00035683, 0.00037782, 
-0.00039881, 0.00041980, 0.00044079, 0.00046178, 0.00048277, 0.00050376, 
-0.00052475, 0.00054574, 0.00056673, 0.00058772, 0.00060871, 0.00062970, 
-0.00065069, 0.00067168, 0.00069267, 0.00071366, 0.00073465, 0.00075564, 
-0.00077663, 0.00079762, 0.00081861, 0.00083960, 0.00086059};
-
-#elif SPEED_FILTER_LENGTH == 85
-inline constexpr float speedFilter[85] = {
--0.00082079, -0.00080125, -0.00078171, -0.00076217, -0.00074262, -0.00072308, 
--0.00070354, -0.00068399, -0.00066445, -0.00064491, -0.00062537, -0.00060582, 
--0.00058628, -0.00056674, -0.00054720, -0.00052765, -0.00050811, -0.00048857, 
--0.00046902, -0.00044948, -0.00042994, -0.00041040, -0.00039085, -0.00037131, 
--0.00035177, -0.00033223, -0.00031268, -0.00029314, -0.00027360, -0.00025406, 
--0.00023451, -0.00021497, -0.00019543, -0.00017588, -0.00015634, -0.00013680, 
--0.00011726, -0.00009771, -0.00007817, -0.00005863, -0.00003909, -0.00001954, 
-0.00000000, 0.00001954, 0.00003909, 0.00005863, 0.00007817, 0.00009771, 
-0.00011726, 0.00013680, 0.00015634, 0.00017588, 0.00019543, 0.00021497, 
-0.00023451, 0.00025406, 0.00027360, 0.00029314, 0.00031268, 0.00033223, 
-0.00035177, 0.00037131, 0.00039085, 0.00041040, 0.00042994, 0.00044948, 
-0.00046902, 0.00048857, 0.00050811, 0.00052765, 0.00054720, 0.00056674, 
-0.00058628, 0.00060582, 0.00062537, 0.00064491, 0.00066445, 0.00068399, 
-0.00070354, 0.00072308, 0.00074262, 0.00076217, 0.00078171, 0.00080125, 
-0.00082079};
-
-#elif SPEED_FILTER_LENGTH == 87
-inline constexpr float speedFilter[87] = {
--0.00078370, -0.00076547, -0.00074725, -0.00072902, -0.00071080, -0.00069257, 
--0.00067435, -0.00065612, -0.00063789, -0.00061967, -0.00060144, -0.00058322, 
--0.00056499, -0.00054677, -0.00052854, -0.00051032, -0.00049209, -0.00047386, 
--0.00045564, -0.00043741, -0.00041919, -0.00040096, -0.00038274, -0.00036451, 
--0.00034629, -0.00032806, -0.00030983, -0.00029161, -0.00027338, -0.00025516, 
--0.00023693, -0.00021871, -0.00020048, -0.00018226, -0.00016403, -0.00014580, 
--0.00012758, -0.00010935, -0.00009113, -0.00007290, -0.00005468, -0.00003645, 
--0.00001823, -0.00000000, 0.00001823, 0.00003645, 0.00005468, 0.00007290, 
-0.00009113, 0.00010935, 0.00012758, 0.00014580, 0.00016403, 0.00018226, 
-0.00020048, 0.00021871, 0.00023693, 0.00025516, 0.00027338, 0.00029161, 
-0.00030983, 0.00032806, 0.00034629, 0.00036451, 0.00038274, 0.00040096, 
-0.00041919, 0.00043741, 0.00045564, 0.00047386, 0.00049209, 0.00051032, 
-0.00052854, 0.00054677, 0.00056499, 0.00058322, 0.00060144, 0.00061967, 
-0.00063789, 0.00065612, 0.00067435, 0.00069257, 0.00071080, 0.00072902, 
-0.00074725, 0.00076547, 0.00078370};
-
-#elif SPEED_FILTER_LENGTH == 89
-inline constexpr float speedFilter[89] = {
--0.00074906, -0.00073204, -0.00071502, -0.00069799, -0.00068097, -0.00066394, 
--0.00064692, -0.00062989, -0.00061287, -0.00059585, -0.00057882, -0.00056180, 
--0.00054477, -0.00052775, -0.00051073, -0.00049370, -0.00047668, -0.00045965, 
--0.00044263, -0.00042560, -0.00040858, -0.00039156, -0.00037453, -0.00035751, 
--0.00034048, -0.00032346, -0.00030644, -0.00028941, -0.00027239, -0.00025536, 
--0.00023834, -0.00022131, -0.00020429, -0.00018727, -0.00017024, -0.00015322, 
--0.00013619, -0.00011917, -0.00010215, -0.00008512, -0.00006810, -0.00005107, 
--0.00003405, -0.00001702, -0.00000000, 0.00001702, 0.00003405, 0.00005107, 
-0.00006810, 0.00008512, 0.00010215, 0.00011917, 0.00013619, 0.00015322, 
-0.00017024, 0.00018727, 0.00020429, 0.00022131, 0.00023834, 0.00025536, 
-0.00027239, 0.00028941, 0.00030644, 0.00032346, 0.00034048, 0.00035751, 
-0.00037453, 0.00039156, 0.00040858, 0.00042560, 0.00044263, 0.00045965, 
-0.00047668, 0.00049370, 0.00051073, 0.00052775, 0.00054477, 0.00056180, 
-0.00057882, 0.00059585, 0.00061287, 0.00062989, 0.00064692, 0.00066394, 
-0.00068097, 0.00069799, 0.00071502, 0.00073204, 0.00074906};
-
-#elif SPEED_FILTER_LENGTH == 91
-inline constexpr float speedFilter[91] = {
--0.00071667, -0.00070075, -0.00068482, -0.00066890, -0.00065297, -0.00063704, 
--0.00062112, -0.00060519, -0.00058927, -0.00057334, -0.00055741, -0.00054149, 
--0.00052556, -0.00050964, -0.00049371, -0.00047778, -0.00046186, -0.00044593, 
--0.00043000, -0.00041408, -0.00039815, -0.00038223, -0.00036630, -0.00035037, 
--0.00033445, -0.00031852, -0.00030260, -0.00028667, -0.00027074, -0.00025482, 
--0.00023889, -0.00022297, -0.00020704, -0.00019111, -0.00017519, -0.00015926, 
--0.00014333, -0.00012741, -0.00011148, -0.00009556, -0.00007963, -0.00006370, 
--0.00004778, -0.00003185, -0.00001593, -0.00000000, 0.00001593, 0.00003185, 
-0.00004778, 0.00006370, 0.00007963, 0.00009556, 0.00011148, 0.00012741, 
-0.00014333, 0.00015926, 0.00017519, 0.00019111, 0.00020704, 0.00022297, 
-0.00023889, 0.00025482, 0.00027074, 0.00028667, 0.00030260, 0.00031852, 
-0.00033445, 0.00035037, 0.00036630, 0.00038223, 0.00039815, 0.00041408, 
-0.00043000, 0.00044593, 0.00046186, 0.00047778, 0.00049371, 0.00050964, 
-0.00052556, 0.00054149, 0.00055741, 0.00057334, 0.00058927, 0.00060519, 
-0.00062112, 0.00063704, 0.00065297, 0.00066890, 0.00068482, 0.00070075, 
-0.00071667};
-
-#elif SPEED_FILTER_LENGTH == 93
-inline constexpr float speedFilter[93] = {
--0.00068634, -0.00067142, -0.00065650, -0.00064158, -0.00062666, -0.00061174, 
--0.00059682, -0.00058190, -0.00056698, -0.00055206, -0.00053714, -0.00052222, 
--0.00050730, -0.00049238, -0.00047746, -0.00046253, -0.00044761, -0.00043269, 
--0.00041777, -0.00040285, -0.00038793, -0.00037301, -0.00035809, -0.00034317, 
--0.00032825, -0.00031333, -0.00029841, -0.00028349, -0.00026857, -0.00025365, 
--0.00023873, -0.00022381, -0.00020889, -0.00019397, -0.00017905, -0.00016413, 
--0.00014920, -0.00013428, -0.00011936, -0.00010444, -0.00008952, -0.00007460, 
--0.00005968, -0.00004476, -0.00002984, -0.00001492, -0.00000000, 0.00001492, 
-0.00002984, 0.00004476, 0.00005968, 0.00007460, 0.00008952, 0.00010444, 
-0.00011936, 0.00013428, 0.00014920, 0.00016413, 0.00017905, 0.00019397, 
-0.00020889, 0.00022381, 0.00023873, 0.00025365, 0.00026857, 0.00028349, 
-0.00029841, 0.00031333, 0.00032825, 0.00034317, 0.00035809, 0.00037301, 
-0.00038793, 0.00040285, 0.00041777, 0.00043269, 0.00044761, 0.00046253, 
-0.00047746, 0.00049238, 0.00050730, 0.00052222, 0.00053714, 0.00055206, 
-0.00056698, 0.00058190, 0.00059682, 0.00061174, 0.00062666, 0.00064158, 
-0.00065650, 0.00067142, 0.00068634};
-
-#elif SPEED_FILTER_LENGTH == 95
-inline constexpr float speedFilter[95] = {
--0.00065789, -0.00064390, -0.00062990, -0.00061590, -0.00060190, -0.00058791, 
--0.00057391, -0.00055991, -0.00054591, -0.00053191, -0.00051792, -0.00050392, 
--0.00048992, -0.00047592, -0.00046193, -0.00044793, -0.00043393, -0.00041993, 
--0.00040594, -0.00039194, -0.00037794, -0.00036394, -0.00034994, -0.00033595, 
--0.00032195, -0.00030795, -0.00029395, -0.00027996, -0.00026596, -0.00025196, 
--0.00023796, -0.00022396, -0.00020997, -0.00019597, -0.00018197, -0.00016797, 
--0.00015398, -0.00013998, -0.00012598, -0.00011198, -0.00009798, -0.00008399, 
--0.00006999, -0.00005599, -0.00004199, -0.00002800, -0.00001400, 0.00000000, 
-0.00001400, 0.00002800, 0.00004199, 0.00005599, 0.00006999, 0.00008399, 
-0.00009798, 0.00011198, 0.00012598, 0.00013998, 0.00015398, 0.00016797, 
-0.00018197, 0.00019597, 0.00020997, 0.00022396, 0.00023796, 0.00025196, 
-0.00026596, 0.00027996, 0.00029395, 0.00030795, 0.00032195, 0.00033595, 
-0.00034994, 0.00036394, 0.00037794, 0.00039194, 0.00040594, 0.00041993, 
-0.00043393, 0.00044793, 0.00046193, 0.00047592, 0.00048992, 0.00050392, 
-0.00051792, 0.00053191, 0.00054591, 0.00055991, 0.00057391, 0.00058791, 
-0.00060190, 0.00061590, 0.00062990, 0.00064390, 0.00065789};
-
-#elif SPEED_FILTER_LENGTH == 97
-inline constexpr float speedFilter[97] = {
--0.00063118, -0.00061803, -0.00060488, -0.00059173, -0.00057858, -0.00056543, 
--0.00055228, -0.00053913, -0.00052598, -0.00051283, -0.00049968, -0.00048653, 
--0.00047339, -0.00046024, -0.00044709, -0.00043394, -0.00042079, -0.00040764, 
--0.00039449, -0.00038134, -0.00036819, -0.00035504, -0.00034189, -0.00032874, 
--0.00031559, -0.00030244, -0.00028929, -0.00027614, -0.00026299, -0.00024984, 
--0.00023669, -0.00022354, -0.00021039, -0.00019724, -0.00018409, -0.00017094, 
--0.00015780, -0.00014465, -0.00013150, -0.00011835, -0.00010520, -0.00009205, 
--0.00007890, -0.00006575, -0.00005260, -0.00003945, -0.00002630, -0.00001315, 
--0.00000000, 0.00001315, 0.00002630, 0.00003945, 0.00005260, 0.00006575, 
-0.00007890, 0.00009205, 0.00010520, 0.00011835, 0.00013150, 0.00014465, 
-0.00015780, 0.00017094, 0.00018409, 0.00019724, 0.00021039, 0.00022354, 
-0.00023669, 0.00024984, 0.00026299, 0.00027614, 0.00028929, 0.00030244, 
-0.00031559, 0.00032874, 0.00034189, 0.00035504, 0.00036819, 0.00038134, 
-0.00039449, 0.00040764, 0.00042079, 0.00043394, 0.00044709, 0.00046024, 
-0.00047339, 0.00048653, 0.00049968, 0.00051283, 0.00052598, 0.00053913, 
-0.00055228, 0.00056543, 0.00057858, 0.00059173, 0.00060488, 0.00061803, 
-0.00063118};
-
-#elif SPEED_FILTER_LENGTH == 99
-inline constexpr float speedFilter[99] = {
--0.00060606, -0.00059369, -0.00058132, -0.00056895, -0.00055659, -0.00054422, 
--0.00053185, -0.00051948, -0.00050711, -0.00049474, -0.00048237, -0.00047001, 
--0.00045764, -0.00044527, -0.00043290, -0.00042053, -0.00040816, -0.00039579, 
--0.00038343, -0.00037106, -0.00035869, -0.00034632, -0.00033395, -0.00032158, 
--0.00030921, -0.00029685, -0.00028448, -0.00027211, -0.00025974, -0.00024737, 
--0.00023500, -0.00022263, -0.00021027, -0.00019790, -0.00018553, -0.00017316, 
--0.00016079, -0.00014842, -0.00013605, -0.00012369, -0.00011132, -0.00009895, 
--0.00008658, -0.00007421, -0.00006184, -0.00004947, -0.00003711, -0.00002474, 
--0.00001237, 0.00000000, 0.00001237, 0.00002474, 0.00003711, 0.00004947, 
-0.00006184, 0.00007421, 0.00008658, 0.00009895, 0.00011132, 0.00012369, 
-0.00013605, 0.00014842, 0.00016079, 0.00017316, 0.00018553, 0.00019790, 
-0.00021027, 0.00022263, 0.00023500, 0.00024737, 0.00025974, 0.00027211, 
-0.00028448, 0.00029685, 0.00030921, 0.00032158, 0.00033395, 0.00034632, 
-0.00035869, 0.00037106, 0.00038343, 0.00039579, 0.00040816, 0.00042053, 
-0.00043290, 0.00044527, 0.00045764, 0.00047001, 0.00048237, 0.00049474, 
-0.00050711, 0.00051948, 0.00053185, 0.00054422, 0.00055659, 0.00056895, 
-0.00058132, 0.00059369, 0.00060606};
-
-#endif 
+inline constexpr const float (&posFilter)[posFilterLength] = PosFilter::coeffs.c;
+inline constexpr const float (&speedFilter)[speedFilterLength] = SpeedFilter::coeffs.c;
 
 } // namespace SavGolayFilters
-
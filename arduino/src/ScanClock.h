@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <Arduino.h>
+
+/**
+ * @brief Time source for the scan loop, read once per scan
+ *
+ * Rather than every key keeping its own elapsedMicros timers (each of which calls micros()), the
+ * time is sampled once at the start of each scan and passed to KeyHammer::step / KeyBank::step, and
+ * keys keep plain uint32_t timestamps. Differences between timestamps (now - then) are correct across
+ * the ~71 minute wrap of a 32 bit microsecond counter.
+ *
+ * The source defaults to micros(), but can be any function, e.g. a virtual clock for simulation, so
+ * that runs are reproducible and can go faster than real time.
+ */
+class ScanClock {
+public:
+    typedef uint32_t (*Source)(void);
+
+    ScanClock() : _source(microsSource), _nowUS(0) {}
+    explicit ScanClock(Source source) : _source(source), _nowUS(0) {}
+
+    void setSource(Source source) { _source = source; }
+
+    /**
+     * @brief Read the time source, once per scan
+     *
+     * @return The current time in microseconds
+     */
+    uint32_t sample() {
+        _nowUS = _source();
+        return _nowUS;
+    }
+
+    // time of the last sample, in microseconds
+    uint32_t now() const { return _nowUS; }
+
+    // microseconds between an earlier timestamp and the last sample
+    uint32_t since(uint32_t thenUS) const { return _nowUS - thenUS; }
+
+private:
+    static uint32_t microsSource() { return micros(); }
+
+    Source _source;
+    uint32_t _nowUS;
+};
@@ -0,0 +1,478 @@
+#include "ScanPlan.h"
+#include <Arduino.h>
+#include "MuxSettleTable.h"
+
+namespace {
+    // working state for the blossom algorithm, only used while building
+    struct Matching {
+        int16_t match[MAX_SCAN_CHANNELS];
+        int16_t parent[MAX_SCAN_CHANNELS];
+        int16_t base[MAX_SCAN_CHANNELS];
+        int16_t queue[MAX_SCAN_CHANNELS];
+        bool used[MAX_SCAN_CHANNELS];
+        bool blossom[MAX_SCAN_CHANNELS];
+        bool onPath[MAX_SCAN_CHANNELS];
+    };
+}
+
+ScanPlan::ScanPlan() {
+    _nSteps = 0;
+    _nChannels = 0;
+    _muxChanges[0] = 0;
+    _muxChanges[1] = 0;
+    _minMuxChanges[0] = 0;
+    _minMuxChanges[1] = 0;
+    _stalls = 0;
+    _settleUS = -1;
+    _error = NULL;
+    _channels = NULL;
+    _pins = NULL;
+    _nPins = 0;
+}
+
+bool ScanPlan::build(const Channel* channels, int nChannels, const Pin* pins, int nPins) {
+    _channels = channels;
+    _pins = pins;
+    _nPins = nPins;
+    _nChannels = 0;
+    _nSteps = 0;
+    _settleUS = -1;
+    _error = NULL;
+    if (nChannels > MAX_SCAN_CHANNELS) {
+        _error = "more keys than MAX_SCAN_CHANNELS";
+        return false;
+    }
+    for (int p = 0; p < nPins; p++) {
+        if ((pins[p].bus > 1) || ((pins[p].adcs & ADC_BOTH) == 0)) {
+            _error = "signal pin with no bus or no ADC";
+            return false;
+        }
+    }
+    for (int i = 0; i < nChannels; i++) {
+        if ((channels[i].signalPinIndex >= nPins) || (channels[i].muxAddr >= (1 << N_ADDRESS_PINS))) {
+            _error = "key with an unknown signal pin or mux address";
+            return false;
+        }
+        for (int j = 0; j < i; j++) {
+            if ((channels[j].signalPinIndex == channels[i].signalPinIndex) && (channels[j].muxAddr == channels[i].muxAddr)) {
+                _error = "two keys on the same signal pin and mux address";
+                return false;
+            }
+        }
+    }
+    _nChannels = nChannels;
+
+    int16_t match[MAX_SCAN_CHANNELS];
+    matchPairs(match);
+    for (int i = 0; i < _nChannels; i++) {
+        // each pair once, from its lower key
+        if ((match[i] < 0) || (match[i] > i)) {
+            if (!addStep(i, match[i])) {
+                return false;
+            }
+        }
+    }
+    order();
+    scheduleMuxes();
+    for (int s = 0; s < _nSteps; s++) {
+        if (_steps[s].key0 >= 0) {
+            _keyStep[_steps[s].key0] = s;
+            _keyAdc[_steps[s].key0] = 0;
+        }
+        if (_steps[s].key1 >= 0) {
+            _keyStep[_steps[s].key1] = s;
+            _keyAdc[_steps[s].key1] = 1;
+        }
+    }
+    // every key read exactly once, by the step it is assigned to
+    int reads = 0;
+    for (int s = 0; s < _nSteps; s++) {
+        reads += (_steps[s].key0 >= 0) + (_steps[s].key1 >= 0);
+    }
+    if (reads != _nChannels) {
+        _error = "plan doesn't read every key once";
+        return false;
+    }
+    for (int i = 0; i < _nChannels; i++) {
+        _values[i] = 0;
+        _sampleUS[i] = 0;
+    }
+    return true;
+}
+
+bool ScanPlan::compatible(int a, int b) const {
+    const Channel& ca = _channels[a];
+    const Channel& cb = _channels[b];
+    if (ca.signalPinIndex == cb.signalPinIndex) {
+        return false;
+    }
+    const Pin& pa = _pins[ca.signalPinIndex];
+    const Pin& pb = _pins[cb.signalPinIndex];
+    bool adcs = ((pa.adcs & ADC_0) && (pb.adcs & ADC_1)) || ((pb.adcs & ADC_0) && (pa.adcs & ADC_1));
+    // muxes on the same address pins must be on the same input
+    return adcs && ((pa.bus != pb.bus) || (ca.muxAddr == cb.muxAddr));
+}
+
+int ScanPlan::group(int key) const {
+    // bus and mux input of a key
+    return (_pins[_channels[key].signalPinIndex].bus << N_ADDRESS_PINS) | _channels[key].muxAddr;
+}
+
+void ScanPlan::matchPairs(int16_t* match) {
+    // Edmonds' blossom algorithm: repeatedly look for an augmenting path from each unmatched key,
+    // contracting odd cycles (blossoms) as they are found. O(keys^3), only run once at startup
+    static Matching m;
+    const int n = _nChannels;
+    for (int i = 0; i < n; i++) {
+        m.match[i] = -1;
+    }
+    // start from a greedy matching that pairs each mux input on one bus with a single input on the
+    // other, so the pairs can be ordered with each bus visiting each of its addresses once. Augmenting
+    // from the keys left over still ends with a maximum matching, and only changes the pairs it needs
+    int8_t link[2 << N_ADDRESS_PINS];
+    for (int g = 0; g < (2 << N_ADDRESS_PINS); g++) {
+        link[g] = -1;
+    }
+    for (int i = 0; i < n; i++) {
+        if (m.match[i] >= 0) {
+            continue;
+        }
+        int gi = group(i);
+        int best = -1;
+        int bestScore = 0;
+        for (int j = i + 1; j < n; j++) {
+            if ((m.match[j] >= 0) || !compatible(i, j)) {
+                continue;
+            }
+            int gj = group(j);
+            // same inputs as earlier pairs, then a new pair of inputs, then anything
+            int score = (link[gi] == gj) ? 3 : ((link[gi] < 0) && (link[gj] < 0) && (gi != gj)) ? 2 : 1;
+            if (score > bestScore) {
+                best = j;
+                bestScore = score;
+            }
+        }
+        if (best >= 0) {
+            m.match[i] = best;
+            m.match[best] = i;
+            if (bestScore == 2) {
+                link[gi] = group(best);
+                link[group(best)] = gi;
+            }
+        }
+    }
+    for (int root = 0; root < n; root++) {
+        if (m.match[root] >= 0) {
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            m.used[i] = false;
+            m.parent[i] = -1;
+            m.base[i] = i;
+        }
+        m.used[root] = true;
+        int head = 0;
+        int tail = 0;
+        m.queue[tail++] = root;
+        int found = -1;
+        while ((head < tail) && (found < 0)) {
+            int v = m.queue[head++];
+            for (int to = 0; (to < n) && (found < 0); to++) {
+                if ((m.base[v] == m.base[to]) || (m.match[v] == to) || !compatible(v, to)) {
+                    continue;
+                }
+                if ((to == root) || ((m.match[to] >= 0) && (m.parent[m.match[to]] >= 0))) {
+                    // odd cycle: find the lowest common ancestor, and contract the cycle into it
+                    for (int i = 0; i < n; i++) {
+                        m.onPath[i] = false;
+                    }
+                    int a = v;
+                    while (true) {
+                        a = m.base[a];
+                        m.onPath[a] = true;
+                        if (m.match[a] < 0) {
+                            break;
+                        }
+                        a = m.parent[m.match[a]];
+                    }
+                    int b = to;
+                    while (true) {
+                        b = m.base[b];
+                        if (m.onPath[b]) {
+                            break;
+                        }
+                        b = m.parent[m.match[b]];
+                    }
+                    int lca = b;
+                    for (int i = 0; i < n; i++) {
+                        m.blossom[i] = false;
+                    }
+                    // mark both sides of the cycle, pointing parents around it
+                    for (int side = 0; side < 2; side++) {
+                        int x = (side == 0) ? v : to;
+                        int child = (side == 0) ? to : v;
+                        while (m.base[x] != lca) {
+                            m.blossom[m.base[x]] = true;
+                            m.blossom[m.base[m.match[x]]] = true;
+                            m.parent[x] = child;
+                            child = m.match[x];
+                            x = m.parent[m.match[x]];
+                        }
+                    }
+                    for (int i = 0; i < n; i++) {
+                        if (m.blossom[m.base[i]]) {
+                            m.base[i] = lca;
+                            if (!m.used[i]) {
+                                m.used[i] = true;
+                                m.queue[tail++] = i;
+                            }
+                        }
+                    }
+                } else if (m.parent[to] < 0) {
+                    m.parent[to] = v;
+                    if (m.match[to] < 0) {
+                        found = to;
+                    } else {
+                        m.used[m.match[to]] = true;
+                        m.queue[tail++] = m.match[to];
+                    }
+                }
+            }
+        }
+        // flip the matching along the augmenting path
+        while (found >= 0) {
+            int parent = m.parent[found];
+            int next = m.match[parent];
+            m.match[found] = parent;
+            m.match[parent] = found;
+            found = next;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        match[i] = m.match[i];
+    }
+}
+
+bool ScanPlan::addStep(int keyA, int keyB) {
+    Step& step = _steps[_nSteps];
+    int pinA = _channels[keyA].signalPinIndex;
+    int pinB = -1;
+    step.key0 = keyA;
+    step.key1 = keyB;
+    if (keyB >= 0) {
+        pinB = _channels[keyB].signalPinIndex;
+        // ADC0 reads the first key if it can, otherwise swap
+        if (!((_pins[pinA].adcs & ADC_0) && (_pins[pinB].adcs & ADC_1))) {
+            step.key0 = keyB;
+            step.key1 = keyA;
+        }
+    } else if (!(_pins[pinA].adcs & ADC_0)) {
+        step.key0 = -1;
+        step.key1 = keyA;
+    }
+    // a key on its own: the other ADC reads any pin it can (the result isn't used)
+    for (int adc = 0; adc < 2; adc++) {
+        int key = (adc == 0) ? step.key0 : step.key1;
+        int pin = (key >= 0) ? _channels[key].signalPinIndex : -1;
+        if (pin < 0) {
+            uint8_t mask = (adc == 0) ? ADC_0 : ADC_1;
+            for (int p = 0; p < _nPins; p++) {
+                if (_pins[p].adcs & mask) {
+                    pin = p;
+                    break;
+                }
+            }
+            if (pin < 0) {
+                _error = (adc == 0) ? "no signal pin for ADC0" : "no signal pin for ADC1";
+                return false;
+            }
+        }
+        if (adc == 0) {
+            step.signalPinIndex0 = pin;
+        } else {
+            step.signalPinIndex1 = pin;
+        }
+    }
+    // addresses each bus needs for this step (-1 if the bus isn't read), filled in by scheduleMuxes
+    step.muxAddr0 = -1;
+    step.muxAddr1 = -1;
+    step.readBuses = 0;
+    for (int k = 0; k < 2; k++) {
+        int key = (k == 0) ? step.key0 : step.key1;
+        if (key >= 0) {
+            step.readBuses |= 1 << _pins[_channels[key].signalPinIndex].bus;
+            if (_pins[_channels[key].signalPinIndex].bus == 0) {
+                step.muxAddr0 = _channels[key].muxAddr;
+            } else {
+                step.muxAddr1 = _channels[key].muxAddr;
+            }
+        }
+    }
+    step.stall = false;
+    step.settleUS = -1;
+    _nSteps++;
+    return true;
+}
+
+void ScanPlan::order() {
+    // by bus 0 address, then bus 1 address, with steps not reading a bus after those that do
+    // insertion sort, stable so keys keep their table order within an address
+    for (int i = 1; i < _nSteps; i++) {
+        Step step = _steps[i];
+        int key = ((step.muxAddr0 < 0 ? 0xFF : step.muxAddr0) << 8) | (step.muxAddr1 < 0 ? 0xFF : step.muxAddr1);
+        int j = i - 1;
+        while (j >= 0) {
+            const Step& other = _steps[j];
+            int otherKey = ((other.muxAddr0 < 0 ? 0xFF : other.muxAddr0) << 8) | (other.muxAddr1 < 0 ? 0xFF : other.muxAddr1);
+            if (otherKey <= key) {
+                break;
+            }
+            _steps[j + 1] = _steps[j];
+            j--;
+        }
+        _steps[j + 1] = step;
+    }
+}
+
+void ScanPlan::scheduleMuxes() {
+    int8_t required[2][MAX_SCAN_CHANNELS];
+    for (int s = 0; s < _nSteps; s++) {
+        required[0][s] = _steps[s].muxAddr0;
+        required[1][s] = _steps[s].muxAddr1;
+    }
+    _stalls = 0;
+    for (int bus = 0; bus < 2; bus++) {
+        _muxChanges[bus] = 0;
+        // addresses the bus needs, the fewest changes is one per address (if there's more than one)
+        uint32_t needed = 0;
+        int last = -1;
+        for (int s = 0; s < _nSteps; s++) {
+            if (required[bus][s] >= 0) {
+                needed |= (1UL << required[bus][s]);
+                last = s;
+            }
+        }
+        int distinct = __builtin_popcount(needed);
+        _minMuxChanges[bus] = (distinct > 1) ? distinct : 0;
+        // steps that don't read the bus already have the address of the next step that does, so the
+        // bus changes straight after its last read at the old address. Working backwards (cyclically)
+        // from the last step that reads the bus, next is the address of the next step that reads it
+        int8_t next = (last >= 0) ? required[bus][last] : 0;
+        for (int n = 0; n < _nSteps; n++) {
+            int s = (last >= 0) ? (last + _nSteps - n) % _nSteps : n;
+            if (required[bus][s] >= 0) {
+                next = required[bus][s];
+            }
+            if (bus == 0) {
+                _steps[s].muxAddr0 = next;
+            } else {
+                _steps[s].muxAddr1 = next;
+            }
+        }
+    }
+    for (int s = 0; s < _nSteps; s++) {
+        const Step& previous = _steps[(s + _nSteps - 1) % _nSteps];
+        Step& step = _steps[s];
+        bool changed0 = (previous.muxAddr0 != step.muxAddr0);
+        bool changed1 = (previous.muxAddr1 != step.muxAddr1);
+        _muxChanges[0] += changed0;
+        _muxChanges[1] += changed1;
+        step.stall = (changed0 && (required[0][s] >= 0)) || (changed1 && (required[1][s] >= 0));
+        _stalls += step.stall;
+    }
+}
+
+void ScanPlan::applySettleTable(const MuxSettleTable* table) {
+    _settleUS = table ? 0 : -1;
+    for (int s = 0; s < _nSteps; s++) {
+        Step& step = _steps[s];
+        step.settleUS = -1;
+        if (!table) {
+            continue;
+        }
+        // the slowest transition of the muxes read on this step, less the conversions since it started
+        int settleUS = 0;
+        for (int k = 0; k < 2; k++) {
+            int key = (k == 0) ? step.key0 : step.key1;
+            if (key < 0) {
+                continue;
+            }
+            int pin = _channels[key].signalPinIndex;
+            int bus = _pins[pin].bus;
+            int to = (bus == 0) ? step.muxAddr0 : step.muxAddr1;
+            // walk back to the step the bus moved to this address on: it moved before the conversion
+            // if that's this step (a stall), or during it if an earlier one
+            int from = -1;
+            int conversions = 0;
+            for (int n = 1; n < _nSteps; n++) {
+                const Step& before = _steps[(s + _nSteps - n) % _nSteps];
+                int addr = (bus == 0) ? before.muxAddr0 : before.muxAddr1;
+                if (addr != to) {
+                    from = addr;
+                    break;
+                }
+                if (before.readBuses & (1 << bus)) {
+                    // already read at this address, so settled
+                    break;
+                }
+                conversions++;
+            }
+            if (from >= 0) {
+                settleUS = max(settleUS, table->getSettleUS(pin, from, to) - conversions * table->getConversionUS());
+            }
+        }
+        step.settleUS = settleUS;
+        _settleUS += settleUS;
+    }
+}
+
+int ScanPlan::readKey(DualAdcManager* adc, int key, int settleDelayUS) {
+    const Step& step = _steps[_keyStep[key]];
+    adc->setMuxConfig(step.muxAddr0, step.muxAddr1);
+    adc->setAdcPinConfig(step.signalPinIndex0, step.signalPinIndex1);
+    adc->updateReadings(settleDelayUS);
+    _values[key] = (_keyAdc[key] == 0) ? adc->getAdcValue1() : adc->getAdcValue2();
+    _sampleUS[key] = adc->getConversionUS();
+    return _values[key];
+}
+
+int ScanPlan::readPin(DualAdcManager* adc, const Pin* pins, int nPins, int pin, int muxAddr, int settleDelayUS) {
+    int adcIndex = (pins[pin].adcs & ADC_0) ? 0 : 1;
+    // the other ADC reads another pin it can, if there is one
+    uint8_t otherMask = (adcIndex == 0) ? ADC_1 : ADC_0;
+    int other = pin;
+    for (int p = 0; p < nPins; p++) {
+        if ((p != pin) && (pins[p].adcs & otherMask)) {
+            other = p;
+            break;
+        }
+    }
+    if (pins[pin].bus == 0) {
+        adc->setMuxAddr0(muxAddr);
+    } else {
+        adc->setMuxAddr1(muxAddr);
+    }
+    adc->setAdcPinConfig((adcIndex == 0) ? pin : other, (adcIndex == 0) ? other : pin);
+    adc->updateReadings(settleDelayUS);
+    return (adcIndex == 0) ? adc->getAdcValue1() : adc->getAdcValue2();
+}
+
+void ScanPlan::printReport() {
+    if (_error) {
+        Serial.printf("scan plan error: %s\n", _error);
+        return;
+    }
+    int singles = 0;
+    for (int s = 0; s < _nSteps; s++) {
+        singles += (_steps[s].key0 < 0) || (_steps[s].key1 < 0);
+    }
+    Serial.printf("-- SCAN PLAN (per scan) --\n");
+    Serial.printf("keys: %d, conversions: %d (minimum), unused results: %d\n", _nChannels, _nSteps, singles);
+    for (int bus = 0; bus < 2; bus++) {
+        Serial.printf("bus %d mux changes: %d (at least %d)\n", bus, _muxChanges[bus], _minMuxChanges[bus]);
+    }
+    Serial.printf("settle stalls: %d\n", _stalls);
+    if (_settleUS >= 0) {
+        Serial.printf("settle time (measured per transition): %dus\n", _settleUS);
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include <Arduino.h>
+#include "DualAdcManager.h"
+#include "Profiler.h"
+
+class MuxSettleTable;
+
+/**
+ * @brief Order of dual ADC reads for a full scan, worked out from a table of where each key is
+ *
+ * Rather than each key's adc function encoding which pair of reads it belongs to (and relying on
+ * DualAdcManager's cache and the call order to share conversions), keys are described by a table:
+ * the signal pin each key's mux is on, and the mux input (address) it is on. Signal pins are described
+ * by which set of address pins drives their mux (bus 0: addressPins0, bus 1: addressPins1), and which
+ * ADCs can read them.
+ *
+ * build works out the plan:
+ * - conversions: two keys can share a conversion if they are on different pins, one pin can be read
+ *   by ADC0 and the other by ADC1, and their muxes can both be set (different buses, or the same
+ *   address). The pairs are a maximum matching of that compatibility graph (Edmonds' blossom
+ *   algorithm), so the number of conversions is the minimum possible: keys - pairs. The matching
+ *   starts from pairs that keep each mux input on one bus with the same input on the other, so the
+ *   muxes change as little as possible.
+ * - order: conversions sorted by bus 0 address, then bus 1 address, so each bus visits each address
+ *   it needs once per scan.
+ * - mux changes: each bus moves to the next address it needs straight after its last read at the
+ *   previous address, so it settles while the other bus is being read. Only a conversion reading a bus
+ *   that changed on the step just before (a stall) waits for the settle delay.
+ *
+ * read then walks the steps as a flat array, as a software pipeline: once a conversion has started,
+ * the bus it doesn't read moves on to its next address, and the keys of the last conversion are
+ * handed to the simulation, before collecting the results. So only collecting a result and starting
+ * the next conversion (plus the settle delay on stalls) sit between conversions. printReport prints the
+ * conversions and mux changes per scan, against their lower bounds.
+ *
+ * By default each stall waits the settle delay passed to read. With applySettleTable, each stall
+ * instead waits as long as the mux transitions it makes were measured to need (see MuxSettleTable.h),
+ * and a read of a bus that was moved on during earlier conversions waits for whatever its transition
+ * needs beyond the time those conversions took.
+ */
+class ScanPlan {
+public:
+    // a key: the signal pin (index into the DualAdcManager signal pins) and mux input it is on
+    struct Channel {
+        uint8_t signalPinIndex;
+        uint8_t muxAddr;
+    };
+
+    // which ADCs can read a signal pin (on teensy 4.1 some pins are only on one, see DualAdcManager.h)
+    enum AdcMask : uint8_t { ADC_0 = 1, ADC_1 = 2, ADC_BOTH = 3 };
+
+    // a signal pin: which address pins drive its mux (0 or 1), and which ADCs can read it
+    struct Pin {
+        uint8_t bus;
+        uint8_t adcs;
+    };
+
+    // one conversion, with the key read by each ADC (-1 if that result isn't used)
+    struct Step {
+        uint8_t signalPinIndex0;
+        uint8_t signalPinIndex1;
+        int8_t muxAddr0;
+        int8_t muxAddr1;
+        int16_t key0;
+        int16_t key1;
+        // buses read on this step (bit 0: bus 0, bit 1: bus 1)
+        uint8_t readBuses;
+        // a bus read on this step changed address on the step before, so wait for the muxes to settle
+        bool stall;
+        // settle time, in microseconds, from the settle table (-1 to use the settle delay on stalls): for
+        // a stall, the whole transition; for a bus moved on earlier, what's left of it
+        int8_t settleUS;
+    };
+
+    ScanPlan();
+
+    /**
+     * @brief Work out the plan for a table of keys
+     *
+     * @param channels Signal pin / mux input of each key, by key index
+     * @param nChannels Number of keys (at most MAX_SCAN_CHANNELS)
+     * @param pins Bus and ADCs of each signal pin, by signal pin index
+     * @param nPins Number of signal pins
+     * @return false if the table is invalid (see getError)
+     */
+    bool build(const Channel* channels, int nChannels, const Pin* pins, int nPins);
+
+    /**
+     * @brief Read every key, in plan order
+     *
+     * @param settleDelayUS Delay before conversions that read a bus that has only just changed
+     * @param onKey Called with (key, value, sampleUS) for each key as soon as it has been read, while
+     * the next conversion runs, with sampleUS the time of its conversion
+     */
+    template <typename KeyFn>
+    void read(DualAdcManager* adc, int settleDelayUS, KeyFn onKey) {
+        for (int s = 0; s < _nSteps; s++) {
+            const Step& step = _steps[s];
+            // buses read on this step were moved on during an earlier conversion, unless this is a stall
+            // (or something else has used the muxes since the last scan)
+            bool settle = ((step.readBuses & 1) && (adc->getMuxAddr0() != step.muxAddr0)) ||
+                          ((step.readBuses & 2) && (adc->getMuxAddr1() != step.muxAddr1));
+            if (step.readBuses & 1) {
+                adc->setMuxAddr0(step.muxAddr0);
+            }
+            if (step.readBuses & 2) {
+                adc->setMuxAddr1(step.muxAddr1);
+            }
+            adc->setAdcPinConfig(step.signalPinIndex0, step.signalPinIndex1);
+            if (settle) {
+                delayMicroseconds((step.stall && (step.settleUS >= 0)) ? step.settleUS : settleDelayUS);
+            } else if (step.settleUS > 0) {
+                // moved on during earlier conversions, which were too quick for the transition
+                delayMicroseconds(step.settleUS);
+            }
+            adc->startConversion();
+            uint32_t sampleUS = adc->getConversionUS();
+            // while converting: move the other bus on to the next address it is read at, and pass on
+            // the keys of the last conversion
+            if (!(step.readBuses & 1)) {
+                adc->setMuxAddr0(step.muxAddr0);
+            }
+            if (!(step.readBuses & 2)) {
+                adc->setMuxAddr1(step.muxAddr1);
+            }
+            if (s > 0) {
+                passKeys(_steps[s - 1], onKey);
+            }
+            int value0;
+            int value1;
+            {
+                PROF_SCOPE(PROF_ADC);
+                adc->readConversion(value0, value1);
+            }
+            if (step.key0 >= 0) {
+                _values[step.key0] = value0;
+                _sampleUS[step.key0] = sampleUS;
+            }
+            if (step.key1 >= 0) {
+                _values[step.key1] = value1;
+                _sampleUS[step.key1] = sampleUS;
+            }
+        }
+        if (_nSteps > 0) {
+            passKeys(_steps[_nSteps - 1], onKey);
+        }
+    }
+    // read every key, with the values only kept for getValue(s)
+    void read(DualAdcManager* adc, int settleDelayUS) {
+        read(adc, settleDelayUS, [](int, int, uint32_t) {});
+    }
+
+    /**
+     * @brief Wait on each stall for the transitions it makes, as measured, rather than the settle delay
+     *
+     * Steps that read a bus moved on during earlier conversions wait for what's left of the transition
+     * after them (at MuxSettleTable::getConversionUS each). Call after build (which clears it). Pass
+     * NULL to go back to the settle delay.
+     */
+    void applySettleTable(const MuxSettleTable* table);
+
+    /**
+     * @brief Read one key on its own (e.g. for an adc function), with the full settle delay
+     */
+    int readKey(DualAdcManager* adc, int key, int settleDelayUS);
+
+    /**
+     * @brief Read one signal pin's mux at an address, on an ADC that can read the pin
+     *
+     * Only the bus driving the pin is moved. Used to characterise the muxes (e.g. MuxSettleTable).
+     */
+    static int readPin(DualAdcManager* adc, const Pin* pins, int nPins, int pin, int muxAddr, int settleDelayUS);
+
+    int getValue(int key) const { return _values[key]; }
+    const int* getValues() const { return _values; }
+    // time each key was last converted
+    uint32_t getSampleUS(int key) const { return _sampleUS[key]; }
+    const uint32_t* getSampleTimes() const { return _sampleUS; }
+
+    int getNumKeys() const { return _nChannels; }
+    int getNumSteps() const { return _nSteps; }
+    const Step& getStep(int s) const { return _steps[s]; }
+    // mux address changes per scan on a bus, and the fewest possible (addresses the bus needs)
+    int getMuxChanges(int bus) const { return _muxChanges[bus]; }
+    int getMinMuxChanges(int bus) const { return _minMuxChanges[bus]; }
+    int getStalls() const { return _stalls; }
+    // total settle time per scan from the settle table, -1 if no table is applied
+    int getSettleUS() const { return _settleUS; }
+    const char* getError() const { return _error; }
+
+    // print conversions, mux changes and stalls per scan
+    void printReport();
+
+private:
+    Step _steps[MAX_SCAN_CHANNELS];
+    int _nSteps;
+    int _nChannels;
+    int _values[MAX_SCAN_CHANNELS];
+    uint32_t _sampleUS[MAX_SCAN_CHANNELS];
+    // step of each key, and which ADC reads it
+    int16_t _keyStep[MAX_SCAN_CHANNELS];
+    uint8_t _keyAdc[MAX_SCAN_CHANNELS];
+    int _muxChanges[2];
+    int _minMuxChanges[2];
+    int _stalls;
+    int _settleUS;
+    const char* _error;
+
+    const Channel* _channels;
+    const Pin* _pins;
+    int _nPins;
+
+    bool compatible(int a, int b) const;
+    int group(int key) const;
+    void matchPairs(int16_t* match);
+    bool addStep(int keyA, int keyB);
+    void order();
+    void scheduleMuxes();
+
+    template <typename KeyFn>
+    void passKeys(const Step& step, KeyFn& onKey) {
+        if (step.key0 >= 0) {
+            onKey(step.key0, _values[step.key0], _sampleUS[step.key0]);
+        }
+        if (step.key1 >= 0) {
+            onKey(step.key1, _values[step.key1], _sampleUS[step.key1]);
+        }
+    }
+};
@@ -0,0 +1,79 @@
+#include "ScanScheduler.h"
+#include <Arduino.h>
+
+ScanScheduler::ScanScheduler() {
+    _adc = NULL;
+    _nKeys = 0;
+    _nChannels = 0;
+    _nGroups = 0;
+    _scan = 0;
+    _lastGroup = -1;
+    _lastConversions = 0;
+    for (int w = 0; w < SCAN_SCHEDULER_WORDS; w++) {
+        _sampled[w] = 0;
+        _usesAdc[w] = 0;
+        _due[w] = 0;
+    }
+}
+
+void ScanScheduler::begin(DualAdcManager* adc, KeyHammer* keys, int nKeys, Pedal* pedals, int nPedals) {
+    _adc = adc;
+    _nKeys = min(nKeys, MAX_SCAN_CHANNELS);
+    _nChannels = min(_nKeys + nPedals, MAX_SCAN_CHANNELS);
+    for (int c = 0; c < _nChannels; c++) {
+        _adcFn[c] = (c < _nKeys) ? keys[c].getAdcFn() : pedals[c - _nKeys].getAdcFn();
+    }
+    // a channel that converts when read in order starts a new group, one that returns the cached
+    // value shares the group of the channel before it
+    _nGroups = 0;
+    _adc->invalidate();
+    for (int c = 0; c < _nChannels; c++) {
+        uint32_t before = _adc->getConversionCount();
+        _adcFn[c]();
+        bool converted = _adc->getConversionCount() != before;
+        // a channel that doesn't convert even when nothing is cached doesn't use the manager
+        _adc->invalidate();
+        before = _adc->getConversionCount();
+        _adcFn[c]();
+        bool usesAdc = _adc->getConversionCount() != before;
+        if (converted || !usesAdc || (c == 0)) {
+            _nGroups++;
+        }
+        _group[c] = _nGroups - 1;
+        if (usesAdc) {
+            setFlag(_usesAdc, _group[c]);
+        }
+        // restore the in order state for the next channel
+        _adc->invalidate();
+        _adcFn[c]();
+    }
+    _scan = 0;
+    _lastGroup = -1;
+}
+
+void ScanScheduler::readDue() {
+    uint32_t conversionsBefore = _adc->getConversionCount();
+    // never reuse a value cached on the last scan
+    _adc->invalidate();
+    for (int w = 0; w < SCAN_SCHEDULER_WORDS; w++) {
+        _sampled[w] = 0;
+    }
+    // channels in order, so that DualAdcManager can reuse the second value of each read
+    for (int c = 0; c < _nChannels; c++) {
+        int g = _group[c];
+        if (!getFlag(_due, g)) {
+            continue;
+        }
+        if (getFlag(_usesAdc, g)) {
+            // muxes are set up ahead of time only when the group before was read
+            if ((g != _lastGroup) && (g != (_lastGroup + 1) % _nGroups)) {
+                _adc->addSettleDelay(SCAN_SKIP_SETTLE_US);
+            }
+            _lastGroup = g;
+        }
+        _samples[c] = _adcFn[c]();
+        _sampleUS[c] = getFlag(_usesAdc, g) ? _adc->getConversionUS() : micros();
+        setFlag(_sampled, c);
+    }
+    _lastConversions = _adc->getConversionCount() - conversionsBefore;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "DualAdcManager.h"
+#include "KeyHammer.h"
+#include "Pedal.h"
+#include "SavGolayFilters.h"
+
+static_assert(SCAN_SLOW_DIVIDER <= SavGolayFilters::posFilterLength && SCAN_SLOW_DIVIDER <= SavGolayFilters::speedFilterLength,
+              "skipped samples must stay inside the filter windows");
+
+// number of 32 bit words needed to hold one flag per channel
+#define SCAN_SCHEDULER_WORDS ((MAX_SCAN_CHANNELS + 31) / 32)
+
+/**
+ * @brief Decides which keys and pedals are read on each scan
+ *
+ * Reading the ADCs is the slowest part of the scan, and most keys are resting most of the time.
+ * Keys in motion (not idle, see KeyHammer::updateIdle) are read every scan. Resting keys and pedals
+ * are read every SCAN_SLOW_DIVIDER scans, staggered so that each scan reads about the same number of
+ * them. So the scan time depends on the number of keys moving, not the number of keys.
+ *
+ * Channels are read in groups: the keys that share one DualAdcManager conversion (both ADCs read at
+ * once, the second value cached) are always read together, since reading the second costs nothing.
+ * Groups are found in begin by reading every channel once and watching the conversion count.
+ * Groups are read in their usual order, so the mux sharing of consecutive groups is kept. When a
+ * group is skipped, the next group read gets SCAN_SKIP_SETTLE_US of extra settle time, since its
+ * muxes were not set up ahead of time.
+ *
+ * A key that is not read is not stepped (KeyHammer::skip), or has its last value held (KeyBank).
+ * When it is next read, the missed samples are filled in on a straight line between the two reads,
+ * so the filters still see one sample per scan.
+ */
+class ScanScheduler {
+public:
+    ScanScheduler();
+
+    /**
+     * @brief Find the read groups of an array of keys, and (optionally) pedals
+     *
+     * Reads every channel, so call after DualAdcManager::begin.
+     *
+     * @param adc The manager the key adc functions read from
+     * @param keys Array of keys, read in order
+     * @param nKeys Number of keys
+     * @param pedals Array of pedals, read after the keys
+     * @param nPedals Number of pedals
+     */
+    void begin(DualAdcManager* adc, KeyHammer* keys, int nKeys, Pedal* pedals = NULL, int nPedals = 0);
+
+    /**
+     * @brief Read the channels due this scan
+     *
+     * @param isIdle Function taking a key index, true if the key is resting and can be read at the
+     * slow rate, e.g. KeyBank::isIdle or KeyHammer::isIdle
+     */
+    template <class IdleFn>
+    void scan(IdleFn isIdle);
+
+    // keys read on the last scan, with their (unsigned, as returned by the adc function) values
+    bool isSampled(int i) const { return getFlag(_sampled, i); }
+    int getSample(int i) const { return _samples[i]; }
+    const int* getSamples() const { return _samples; }
+    // and the time each was converted (see DualAdcManager::getConversionUS)
+    uint32_t getSampleUS(int i) const { return _sampleUS[i]; }
+    const uint32_t* getSampleTimes() const { return _sampleUS; }
+    // one bit per key, as used by KeyBank::step
+    const uint32_t* getSampledMask() const { return _sampled; }
+    bool isPedalSampled(int p) const { return isSampled(_nKeys + p); }
+    int getPedalSample(int p) const { return _samples[_nKeys + p]; }
+
+    int getNumChannels() const { return _nChannels; }
+    int getNumGroups() const { return _nGroups; }
+    // adc conversions on the last scan (one conversion per group read)
+    uint32_t getConversions() const { return _lastConversions; }
+
+private:
+    DualAdcManager* _adc;
+    int _nKeys;
+    int _nChannels;
+    int _nGroups;
+    uint32_t _scan;
+    // last group read, so that skipped groups get extra settle time
+    int _lastGroup;
+    uint32_t _lastConversions;
+
+    int (*_adcFn[MAX_SCAN_CHANNELS])(void);
+    // read group of each channel, consecutive channels share a group
+    uint16_t _group[MAX_SCAN_CHANNELS];
+    int _samples[MAX_SCAN_CHANNELS];
+    uint32_t _sampleUS[MAX_SCAN_CHANNELS];
+    uint32_t _sampled[SCAN_SCHEDULER_WORDS];
+    // groups read through the DualAdcManager (rather than e.g. analogRead), which need settle time
+    uint32_t _usesAdc[SCAN_SCHEDULER_WORDS];
+    uint32_t _due[SCAN_SCHEDULER_WORDS];
+
+    static bool getFlag(const uint32_t* flags, int i) { return (flags[i >> 5] >> (i & 31)) & 1; }
+    static void setFlag(uint32_t* flags, int i) { flags[i >> 5] |= (1UL << (i & 31)); }
+
+    void readDue();
+};
+
+template <class IdleFn>
+void ScanScheduler::scan(IdleFn isIdle) {
+    for (int w = 0; w < SCAN_SCHEDULER_WORDS; w++) {
+        _due[w] = 0;
+    }
+    // resting groups, staggered so each scan reads 1 / SCAN_SLOW_DIVIDER of them
+    for (int g = (SCAN_SLOW_DIVIDER - _scan % SCAN_SLOW_DIVIDER) % SCAN_SLOW_DIVIDER; g < _nGroups; g += SCAN_SLOW_DIVIDER) {
+        setFlag(_due, g);
+    }
+    // and every group with a key in motion
+    for (int i = 0; i < _nKeys; i++) {
+        if (!isIdle(i)) {
+            setFlag(_due, _group[i]);
+        }
+    }
+    readDue();
+    _scan++;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+// Numeric types and arithmetic for the hammer simulation
+// By default the simulation runs in float. If USE_FIXED_POINT is defined (see config.h), it instead
+// runs on Q-format integers, which is much cheaper on targets without an FPU (e.g. the RP2040's
+// Cortex-M0+). KeyHammer and KeyBank are written once against the types/functions below, so both versions
+// follow exactly the same logic.
+//
+// Fixed point formats (Qn = value * 2^n, stored in an int32_t):
+//   position_t  Q16  adc bits                     (range +-32767 bits)
+//   speed_t     Q28  adc bits per microsecond     (range +-8 bits/us, resolution 4e-9 bits/us)
+//   gravity_t   Q36  adc bits per microsecond^2   (typical gravity is ~8e-8 bits/us^2, i.e. ~5000)
+//   scaler_t    Q8   velocity map index per (adc bit per microsecond)
+//   coeff_t     Q16  Savitzky-Golay filter coefficients (see FilterFor)
+//
+// Tolerance vs the float simulation:
+// - filter coefficients are rounded to Q16, with the rounding error folded into the largest
+//   coefficient so that the position filter still sums to exactly 1 and the speed filter to exactly 0
+//   (so a resting key has exactly zero speed)
+// - with the default 21 tap filters, key/hammer positions agree to within ~0.05 adc bits and speeds
+//   to within ~0.01%, which gives the same note on/off decisions, and velocities within +-1 midi
+//   velocity step (host_sim_fixed checks this against the float build, see host/CMakeLists.txt)
+// - speeds are kept to 28 fractional bits since a free flying hammer loses only ~300 units of Q24 to
+//   gravity per scan, so truncating each step drifted its speed by ~0.1%. That was enough for a key
+//   only just catching up with its hammer to do so in one build and not the other, giving velocities
+//   several steps apart. Every shift rounds to nearest, rather than truncating towards -infinity
+// - speeds beyond the Q28 range (e.g. a glitch read just after another sample) saturate
+// - elapsed time per step is clamped to 65535us (only matters after very long pauses)
+
+#include "config.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "SavGolayFilters.h"
+
+namespace SimMath {
+
+#ifdef USE_FIXED_POINT
+
+constexpr int POSITION_FRAC_BITS = 16;
+constexpr int SPEED_FRAC_BITS = 28;
+constexpr int INV_ELAPSED_FRAC_BITS = 30;
+constexpr int GRAVITY_FRAC_BITS = 36;
+constexpr int SCALER_FRAC_BITS = 8;
+constexpr int COEFF_FRAC_BITS = 16;
+constexpr int32_t MAX_ELAPSED_US = 65535;
+
+typedef int32_t position_t;
+typedef int32_t speed_t;
+typedef int32_t gravity_t;
+typedef int32_t scaler_t;
+typedef int32_t coeff_t;
+
+// integer version of a filter
+template <size_t N>
+struct FilterCoeffs {
+  coeff_t c[N];
+};
+
+// round the coefficients of a float filter to Q16, keeping the sum of the coefficients exact
+template <size_t N>
+constexpr FilterCoeffs<N> quantiseFilter(const float (&filter)[N], int32_t targetSum) {
+  FilterCoeffs<N> q{};
+  int32_t sum = 0;
+  size_t largest = 0;
+  for (size_t i = 0; i < N; i++) {
+    double x = filter[i] * (double)(1L << COEFF_FRAC_BITS);
+    q.c[i] = (int32_t)(x >= 0 ? x + 0.5 : x - 0.5);
+    sum += q.c[i];
+    double absLargest = filter[largest] < 0 ? -filter[largest] : filter[largest];
+    double absI = filter[i] < 0 ? -filter[i] : filter[i];
+    if (absI > absLargest) {
+      largest = i;
+    }
+  }
+  q.c[largest] += targetSum - sum;
+  return q;
+}
+
+// coefficients of any SavGolay filter (see SavGolay.h) in Q16
+// position filters (deriv 0) sum to exactly 1, derivative filters to exactly 0
+template <class SG>
+struct FilterFor {
+  static constexpr FilterCoeffs<SG::length> fixed = quantiseFilter(SG::coeffs.c, SG::deriv == 0 ? (1L << COEFF_FRAC_BITS) : 0);
+  static constexpr const coeff_t* coeffs = fixed.c;
+};
+
+// accumulator for applying a filter to raw adc values
+// positions come out in Q16 directly, speeds (before dividing by time) in Q16 bits per sample
+typedef int32_t filter_acc_t;
+
+inline position_t positionFromInt(int bits) { return (position_t)bits << POSITION_FRAC_BITS; }
+inline float positionToFloat(position_t p) { return p * (1.0f / (1L << POSITION_FRAC_BITS)); }
+inline float speedToFloat(speed_t s) { return s * (1.0f / (1L << SPEED_FRAC_BITS)); }
+inline speed_t speedFromFloat(float s) { return (speed_t)lroundf(s * (float)(1L << SPEED_FRAC_BITS)); }
+inline gravity_t gravityFromFloat(float g) { return (gravity_t)lroundf(g * (float)(1LL << GRAVITY_FRAC_BITS)); }
+inline float gravityToFloat(gravity_t g) { return g * (1.0f / (float)(1LL << GRAVITY_FRAC_BITS)); }
+inline scaler_t scalerFromFloat(float s) { return (scaler_t)lroundf(s * (1L << SCALER_FRAC_BITS)); }
+inline float scalerToFloat(scaler_t s) { return s * (1.0f / (1L << SCALER_FRAC_BITS)); }
+
+/**
+ * @brief Converts filter outputs (per sample) into speeds (per microsecond)
+ *
+ * Keeps the reciprocal of the last elapsed time, so that the (software, on cortex-m0+) division
+ * only happens when the elapsed time changes, rather than on every step.
+ */
+struct SpeedScaler {
+  int32_t elapsedUS = 0;
+  // 2^30 / elapsedUS
+  int32_t invElapsed = 0;
+
+  speed_t speed(filter_acc_t perSample, int32_t elapsed) {
+    if (elapsed != elapsedUS) {
+      elapsedUS = elapsed;
+      invElapsed = (elapsed > 0) ? (int32_t)((1L << INV_ELAPSED_FRAC_BITS) / elapsed) : 0;
+    }
+    // Q16 * Q30 = Q46, shift down to Q28
+    const int shift = POSITION_FRAC_BITS + INV_ELAPSED_FRAC_BITS - SPEED_FRAC_BITS;
+    int64_t speed = ((int64_t)perSample * invElapsed + (1LL << (shift - 1))) >> shift;
+    return (speed_t)(speed > INT32_MAX ? INT32_MAX : (speed < -INT32_MAX ? -INT32_MAX : speed));
+  }
+};
+
+inline int32_t clampElapsed(int32_t elapsed) { return elapsed > MAX_ELAPSED_US ? MAX_ELAPSED_US : elapsed; }
+
+// change in speed due to gravity, over elapsed microseconds
+inline speed_t gravityStep(gravity_t gravity, int32_t elapsed) {
+  // Q36 * us, shift down to Q28
+  const int shift = GRAVITY_FRAC_BITS - SPEED_FRAC_BITS;
+  return (speed_t)(((int64_t)gravity * elapsed + (1LL << (shift - 1))) >> shift);
+}
+
+// change in position at speed, over elapsed microseconds
+inline position_t travel(speed_t speed, int32_t elapsed) {
+  // Q28 * us, shift down to Q16
+  const int shift = SPEED_FRAC_BITS - POSITION_FRAC_BITS;
+  return (position_t)(((int64_t)speed * elapsed + (1LL << (shift - 1))) >> shift);
+}
+
+// index into the velocity map, rounded
+inline int velocityIndex(speed_t speed, scaler_t scaler) {
+  const int shift = SPEED_FRAC_BITS + SCALER_FRAC_BITS;
+  return (int)(((int64_t)speed * scaler + (1LL << (shift - 1))) >> shift);
+}
+
+#else
+
+typedef float position_t;
+typedef float speed_t;
+typedef float gravity_t;
+typedef float scaler_t;
+typedef float coeff_t;
+typedef float filter_acc_t;
+
+template <class SG>
+struct FilterFor {
+  static constexpr const coeff_t* coeffs = SG::coeffs.c;
+};
+
+inline position_t positionFromInt(int bits) { return bits; }
+inline float positionToFloat(position_t p) { return p; }
+inline float speedToFloat(speed_t s) { return s; }
+inline speed_t speedFromFloat(float s) { return s; }
+inline gravity_t gravityFromFloat(float g) { return g; }
+inline float gravityToFloat(gravity_t g) { return g; }
+inline scaler_t scalerFromFloat(float s) { return s; }
+inline float scalerToFloat(scaler_t s) { return s; }
+
+struct SpeedScaler {
+  speed_t speed(filter_acc_t perSample, int32_t elapsed) { return (elapsed > 0) ? perSample / (float)elapsed : 0; }
+};
+
+inline int32_t clampElapsed(int32_t elapsed) { return elapsed; }
+inline speed_t gravityStep(gravity_t gravity, int32_t elapsed) { return gravity * elapsed; }
+inline position_t travel(speed_t speed, int32_t elapsed) { return speed * elapsed; }
+inline int velocityIndex(speed_t speed, scaler_t scaler) { return round(speed * scaler); }
+
+#endif
+
+inline constexpr const coeff_t* posFilter = FilterFor<SavGolayFilters::PosFilter>::coeffs;
+inline constexpr const coeff_t* speedFilter = FilterFor<SavGolayFilters::SpeedFilter>::coeffs;
+
+} // namespace SimMath
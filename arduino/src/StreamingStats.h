@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Mean, standard deviation and a quantile (by default the median) of a stream of samples, in
+ * constant memory and constant time per sample
+ *
+ * Used for calibration, where every key collects a second or more of samples: rather than keeping a
+ * sample of them and sorting it at the end, each sample updates
+ *  - the mean and sum of squared differences from it (Welford's method), for the standard deviation
+ *  - five markers of the P^2 algorithm (Jain & Chlamtac, 1985): the min, the max, the quantile and the
+ *    quantiles half way either side of it, with their positions in the sorted samples. Markers whose
+ *    position drifts from where it should be are moved one position along, and their height adjusted
+ *    on a parabola through their neighbours.
+ * Reading the results is constant time. The quantile is exact up to 5 samples, and an estimate
+ * after that, which for adc noise around a resting value is within a fraction of a bit.
+ */
+class StreamingStats {
+public:
+    StreamingStats(float p = 0.5f) : _p(p) {
+        reset();
+    }
+
+    void reset() {
+        _n = 0;
+        _mean = 0;
+        _m2 = 0;
+        for (int i = 0; i < 5; i++) {
+            _q[i] = 0;
+            _pos[i] = i;
+        }
+    }
+
+    void add(float x) {
+        _n++;
+        float delta = x - _mean;
+        _mean += delta / _n;
+        _m2 += delta * (x - _mean);
+
+        if (_n <= 5) {
+            // first five samples, kept sorted
+            int i = _n - 1;
+            for (; i > 0 && _q[i - 1] > x; i--) {
+                _q[i] = _q[i - 1];
+            }
+            _q[i] = x;
+            return;
+        }
+
+        // marker cell the sample falls in, stretching the min or max if it's outside them
+        int k;
+        if (x < _q[0]) {
+            _q[0] = x;
+            k = 0;
+        } else if (x >= _q[4]) {
+            _q[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= _q[k + 1]) {
+                k++;
+            }
+        }
+        for (int i = k + 1; i < 5; i++) {
+            _pos[i]++;
+        }
+
+        // move the middle markers towards where they should be
+        for (int i = 1; i < 4; i++) {
+            float d = desired(i) - _pos[i];
+            if ((d >= 1 && _pos[i + 1] - _pos[i] > 1) || (d <= -1 && _pos[i - 1] - _pos[i] < -1)) {
+                int s = (d > 0) ? 1 : -1;
+                float q = parabolic(i, s);
+                if (_q[i - 1] < q && q < _q[i + 1]) {
+                    _q[i] = q;
+                } else {
+                    _q[i] += s * (_q[i + s] - _q[i]) / (_pos[i + s] - _pos[i]);
+                }
+                _pos[i] += s;
+            }
+        }
+    }
+
+    uint32_t count() const { return _n; }
+    float mean() const { return _mean; }
+    // sample standard deviation
+    float std() const { return (_n > 1) ? sqrtf(_m2 / (_n - 1)) : 0; }
+
+    float quantile() const {
+        if (_n == 0) {
+            return 0;
+        }
+        if (_n > 5) {
+            return _q[2];
+        }
+        // exact, interpolating between the sorted samples
+        float pos = (_n - 1) * _p;
+        int lo = (int)pos;
+        int hi = (lo + 1 < (int)_n) ? lo + 1 : lo;
+        return _q[lo] + (_q[hi] - _q[lo]) * (pos - lo);
+    }
+
+private:
+    float _p;
+    uint32_t _n;
+    float _mean;
+    float _m2;
+    // marker heights and positions (0 based) in the sorted samples
+    float _q[5];
+    int32_t _pos[5];
+
+    // where marker i should be, for the samples seen so far
+    float desired(int i) const {
+        float f = (i == 1) ? _p / 2 : (i == 2) ? _p : (1 + _p) / 2;
+        return (_n - 1) * f;
+    }
+
+    float parabolic(int i, int s) const {
+        float below = _pos[i] - _pos[i - 1];
+        float above = _pos[i + 1] - _pos[i];
+        return _q[i] + s / (float)(_pos[i + 1] - _pos[i - 1]) *
+                       ((below + s) * (_q[i + 1] - _q[i]) / above + (above - s) * (_q[i] - _q[i - 1]) / below);
+    }
+};
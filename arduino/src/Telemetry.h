@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Binary telemetry stream format (version 1)
+ *
+ * Streams the state of the selected keys for every scan over the serial port, for plotting or
+ * logging on a computer (see TelemetryWriter.h, and host/telemetry_decode for a decoder to csv).
+ *
+ * The stream is a sequence of packets, each COBS encoded and followed by a 0 byte, so a decoder can
+ * start anywhere and resynchronise on the next 0. Text printed to the same port (e.g. replies to
+ * serial commands) ends up inside a packet and fails its check, so it is skipped.
+ *
+ * Each packet, before encoding, all little endian:
+ *   uint8_t type, payload, uint16_t crc (CRC-16/CCITT of type and payload)
+ * SCHEMA payload: uint8_t version, uint8_t attributes (bit mask of Attribute), uint16_t nKeys,
+ *   uint32_t scanPeriodUS, then per key: uint8_t index, uint8_t pitch
+ * FRAME payload: uint32_t sequence, uint32_t timeUS, then per key (in schema order) the value of each
+ *   attribute in the mask (in Attribute order), of attributeSize bytes: int16_t for RAW_ADC (negative
+ *   for keys whose values are negated, see KeyHammer::getAdcValue), uint16_t for ELAPSED (clamped to
+ *   65535us), float for the rest
+ * The schema is sent when streaming starts or the selection changes, and again every
+ * TELEMETRY_SCHEMA_INTERVAL frames. A gap in the frame sequence numbers is a dropped frame.
+ */
+namespace Telemetry {
+    const uint8_t VERSION = 1;
+
+    enum PacketType : uint8_t {
+        SCHEMA = 1,
+        FRAME = 2
+    };
+
+    // the same attributes as the text stream ("pka" serial command)
+    enum Attribute : uint8_t {
+        RAW_ADC = 0,
+        KEY_POSITION,
+        KEY_SPEED,
+        HAMMER_POSITION,
+        HAMMER_SPEED,
+        ELAPSED,
+        NUM_ATTRIBUTES
+    };
+
+    constexpr int attributeSize(int attribute) {
+        return (attribute == RAW_ADC || attribute == ELAPSED) ? 2 : 4;
+    }
+
+    // bytes of one key's values in a frame
+    constexpr int keySize(uint8_t attributes, int attribute = 0) {
+        return (attribute == NUM_ATTRIBUTES) ? 0
+            : (((attributes >> attribute) & 1) ? attributeSize(attribute) : 0) + keySize(attributes, attribute + 1);
+    }
+
+    const int SCHEMA_HEADER_SIZE = 8;
+    const int FRAME_HEADER_SIZE = 8;
+
+    // largest encoded size of a packet with n bytes before encoding (type, payload and crc), plus its
+    // delimiter
+    constexpr int encodedSize(int n) {
+        return n + (n + 253) / 254 + 1;
+    }
+
+    inline uint16_t crc16(const uint8_t* data, size_t n, uint16_t crc = 0xFFFF) {
+        for (size_t i = 0; i < n; i++) {
+            crc ^= (uint16_t)data[i] << 8;
+            for (int b = 0; b < 8; b++) {
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief COBS encode n bytes into out, followed by the 0 delimiter
+     *
+     * @return Bytes written, at most encodedSize(n)
+     */
+    inline size_t encode(const uint8_t* in, size_t n, uint8_t* out) {
+        size_t codeIndex = 0;
+        size_t o = 1;
+        uint8_t code = 1;
+        for (size_t i = 0; i < n; i++) {
+            if (in[i] != 0) {
+                out[o++] = in[i];
+                code++;
+            }
+            if (in[i] == 0 || code == 0xFF) {
+                out[codeIndex] = code;
+                codeIndex = o++;
+                code = 1;
+            }
+        }
+        out[codeIndex] = code;
+        out[o++] = 0;
+        return o;
+    }
+
+    /**
+     * @brief Decode a COBS packet (without its delimiter) in place
+     *
+     * @return Decoded length, or -1 if the packet is malformed
+     */
+    inline int decode(uint8_t* data, size_t n) {
+        size_t in = 0;
+        size_t out = 0;
+        while (in < n) {
+            uint8_t code = data[in++];
+            if (code == 0 || in + code - 1 > n) {
+                return -1;
+            }
+            for (int i = 1; i < code; i++) {
+                data[out++] = data[in++];
+            }
+            if (code != 0xFF && in < n) {
+                data[out++] = 0;
+            }
+        }
+        return (int)out;
+    }
+}
@@ -0,0 +1,141 @@
+#include "TelemetryWriter.h"
+#include <Arduino.h>
+#include <string.h>
+
+static_assert((TELEMETRY_BUFFER_BYTES & (TELEMETRY_BUFFER_BYTES - 1)) == 0, "TELEMETRY_BUFFER_BYTES must be a power of two");
+
+TelemetryWriter::TelemetryWriter() {
+    _streaming = false;
+    _attributes = 0;
+    _nKeys = 0;
+    _scanPeriodUS = 0;
+    _sequence = 0;
+    _droppedFrames = 0;
+    _framesSinceSchema = 0;
+    _packetLength = 0;
+    _head = 0;
+    _tail = 0;
+}
+
+bool TelemetryWriter::begin(const uint8_t* indices, const uint8_t* pitches, int nKeys, uint8_t attributes, uint32_t scanPeriodUS) {
+    _streaming = false;
+    attributes &= (1 << Telemetry::NUM_ATTRIBUTES) - 1;
+    if ((nKeys > MAX_BANK_KEYS)
+        || (Telemetry::encodedSize(1 + Telemetry::FRAME_HEADER_SIZE + nKeys * Telemetry::keySize(attributes) + 2) > BUFFER_SIZE_BYTES)) {
+        return false;
+    }
+    _attributes = attributes;
+    _nKeys = nKeys;
+    _scanPeriodUS = scanPeriodUS;
+    memcpy(_indices, indices, nKeys);
+    memcpy(_pitches, pitches, nKeys);
+    _sequence = 0;
+    _droppedFrames = 0;
+    sendSchema();
+    _streaming = true;
+    return true;
+}
+
+void TelemetryWriter::end() {
+    _streaming = false;
+}
+
+template <class T>
+void TelemetryWriter::put(T value) {
+    memcpy(_packet + _packetLength, &value, sizeof(T));
+    _packetLength += sizeof(T);
+}
+
+void TelemetryWriter::sendSchema() {
+    _packetLength = 0;
+    put<uint8_t>(Telemetry::SCHEMA);
+    put<uint8_t>(Telemetry::VERSION);
+    put<uint8_t>(_attributes);
+    put<uint16_t>(_nKeys);
+    put<uint32_t>(_scanPeriodUS);
+    for (int k = 0; k < _nKeys; k++) {
+        put<uint8_t>(_indices[k]);
+        put<uint8_t>(_pitches[k]);
+    }
+    // tried again with the next frame if there's no room
+    _framesSinceSchema = bufferPacket() ? 0 : TELEMETRY_SCHEMA_INTERVAL;
+}
+
+void TelemetryWriter::beginFrame(uint32_t timeUS) {
+    if (_framesSinceSchema >= TELEMETRY_SCHEMA_INTERVAL) {
+        sendSchema();
+    }
+    _framesSinceSchema++;
+    _packetLength = 0;
+    put<uint8_t>(Telemetry::FRAME);
+    put<uint32_t>(_sequence++);
+    put<uint32_t>(timeUS);
+}
+
+void TelemetryWriter::addKey(int rawADC, float keyPosition, float keySpeed, float hammerPosition, float hammerSpeed, int elapsedUS) {
+    if (_attributes & (1 << Telemetry::RAW_ADC)) {
+        // signed, since keys with adcValKeyUp > adcValKeyDown read negated values
+        put<int16_t>(rawADC);
+    }
+    if (_attributes & (1 << Telemetry::KEY_POSITION)) {
+        put<float>(keyPosition);
+    }
+    if (_attributes & (1 << Telemetry::KEY_SPEED)) {
+        put<float>(keySpeed);
+    }
+    if (_attributes & (1 << Telemetry::HAMMER_POSITION)) {
+        put<float>(hammerPosition);
+    }
+    if (_attributes & (1 << Telemetry::HAMMER_SPEED)) {
+        put<float>(hammerSpeed);
+    }
+    if (_attributes & (1 << Telemetry::ELAPSED)) {
+        put<uint16_t>(constrain(elapsedUS, 0, 0xFFFF));
+    }
+}
+
+void TelemetryWriter::endFrame() {
+    if (!bufferPacket()) {
+        _droppedFrames++;
+    }
+}
+
+bool TelemetryWriter::bufferPacket() {
+    uint16_t crc = Telemetry::crc16(_packet, _packetLength);
+    put<uint16_t>(crc);
+    int maxEncoded = Telemetry::encodedSize(_packetLength);
+    if (BUFFER_SIZE_BYTES - (int)(_head - _tail) < maxEncoded) {
+        return false;
+    }
+    // encode into a contiguous copy when the packet could run past the end of the buffer
+    uint32_t start = _head & (BUFFER_SIZE_BYTES - 1);
+    if (start + maxEncoded <= (uint32_t)BUFFER_SIZE_BYTES) {
+        _head += Telemetry::encode(_packet, _packetLength, _buffer + start);
+    } else {
+        int n = Telemetry::encode(_packet, _packetLength, _encoded);
+        int first = BUFFER_SIZE_BYTES - start;
+        memcpy(_buffer + start, _encoded, min(n, first));
+        if (n > first) {
+            memcpy(_buffer, _encoded + first, n - first);
+        }
+        _head += n;
+    }
+    return true;
+}
+
+int TelemetryWriter::drain() {
+    int sent = 0;
+    while (_head != _tail) {
+        int room = Serial.availableForWrite();
+        if (room <= 0) {
+            break;
+        }
+        uint32_t start = _tail & (BUFFER_SIZE_BYTES - 1);
+        // up to the end of the buffer, then around again
+        int n = min(min((int)(_head - _tail), BUFFER_SIZE_BYTES - (int)start), room);
+        Serial.write(_buffer + start, n);
+        _tail += n;
+        sent += n;
+    }
+    return sent;
+}
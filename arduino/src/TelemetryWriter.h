@@ -0,0 +1,92 @@
+#pragma once
+
+#include "config.h"
+#include <stdint.h>
+#include "Telemetry.h"
+
+/**
+ * @brief Streams the state of the selected keys for every scan over serial, as binary packets
+ *
+ * See Telemetry.h for the format. Printing every key's state as text, with a flush after each key,
+ * takes too long to do every scan. Instead each frame is packed into a binary packet in a RAM ring
+ * buffer, and drain sends as much of the buffer as the serial port will take without blocking. A
+ * frame that doesn't fit in the buffer (because the port is slower than the stream) is dropped, and
+ * counted by getDroppedFrames.
+ *
+ * Usage:
+ *   telemetry.begin(indices, pitches, nKeys, attributes, 250);
+ *   // each scan
+ *   telemetry.beginFrame(nowUS);
+ *   for (each selected key) telemetry.addKey(rawADC, keyPosition, keySpeed, hammerPosition, hammerSpeed, elapsedUS);
+ *   telemetry.endFrame();
+ *   // each loop
+ *   telemetry.drain();
+ */
+class TelemetryWriter {
+public:
+    TelemetryWriter();
+
+    /**
+     * @brief Start streaming, with a schema packet describing the frames
+     *
+     * @param indices Index of each selected key (in the order their values are added to each frame)
+     * @param pitches Midi pitch of each selected key
+     * @param attributes Bit mask of the Telemetry::Attribute values sent for each key
+     * @return false if a frame of this many keys and attributes wouldn't fit in the buffer
+     */
+    bool begin(const uint8_t* indices, const uint8_t* pitches, int nKeys, uint8_t attributes, uint32_t scanPeriodUS);
+    // stop streaming (anything already buffered is still sent by drain)
+    void end();
+    bool isStreaming() const { return _streaming; }
+
+    // start a frame, then add each selected key, in schema order
+    void beginFrame(uint32_t timeUS);
+    void addKey(int rawADC, float keyPosition, float keySpeed, float hammerPosition, float hammerSpeed, int elapsedUS);
+    // check, encode and buffer the frame (or drop it, if the buffer is full)
+    void endFrame();
+
+    /**
+     * @brief Send buffered packets over serial, as much as it takes without blocking
+     *
+     * @return bytes sent
+     */
+    int drain();
+
+    uint32_t getFrameCount() const { return _sequence; }
+    uint32_t getDroppedFrames() const { return _droppedFrames; }
+    // bytes waiting to be sent
+    int getBuffered() const { return _head - _tail; }
+
+private:
+    static const int BUFFER_SIZE_BYTES = TELEMETRY_BUFFER_BYTES;
+    // one frame of every key, with every attribute
+    static const int MAX_PACKET_SIZE = 1 + Telemetry::FRAME_HEADER_SIZE
+                                       + MAX_BANK_KEYS * Telemetry::keySize((1 << Telemetry::NUM_ATTRIBUTES) - 1) + 2;
+
+    bool _streaming;
+    uint8_t _attributes;
+    int _nKeys;
+    uint32_t _scanPeriodUS;
+    uint8_t _indices[MAX_BANK_KEYS];
+    uint8_t _pitches[MAX_BANK_KEYS];
+    uint32_t _sequence;
+    uint32_t _droppedFrames;
+    // frames since the schema was last sent
+    uint32_t _framesSinceSchema;
+
+    // packet being built, before encoding
+    uint8_t _packet[MAX_PACKET_SIZE];
+    int _packetLength;
+    // encoded packets waiting to be sent, with free running byte indices
+    uint8_t _buffer[BUFFER_SIZE_BYTES];
+    uint32_t _head;
+    uint32_t _tail;
+    // a packet encoded here when it would wrap around the end of _buffer
+    uint8_t _encoded[Telemetry::encodedSize(MAX_PACKET_SIZE)];
+
+    template <class T>
+    void put(T value);
+    void sendSchema();
+    // add the crc, encode and buffer the packet, false if there's no room
+    bool bufferPacket();
+};
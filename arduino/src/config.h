@@ -12,5 +12,132 @@
 // if dumping note-on adc data, then longer is better but need to baance number of keys with length of buffers
 #define BUFFER_SIZE 100
 
+// if defined, the hammer simulation uses fixed point (integer) arithmetic rather than float (see SimMath.h)
+// needed for boards without an FPU, such as the raspberry pico (rp2040), but also cheaper on teensy
+#ifdef PICO
+#define USE_FIXED_POINT
+#endif
+
+// if defined, keys are stepped together by a KeyBank (batched, structure-of-arrays simulation)
+// rather than one KeyHammer object at a time
+#define USE_KEY_BANK
+// maximum number of keys in a KeyBank
+#define MAX_BANK_KEYS 128
+
+// if defined, time spent in each stage of the scan loop is measured (see Profiler.h), and can be
+// printed with the "prof" serial command. Costs nothing when not defined
+// #define USE_PROFILER
+
+// if defined, the key to midi latency of every note on is recorded (see LatencyTracker.h), and can be
+// printed with the "lat" serial command
+#define USE_LATENCY_TRACKER
+// onset level used for latency, as a fraction of the way from adcValKeyUp to adcValKeyDown
+#define LATENCY_ONSET_FRACTION 0.1
+// number of recent note ons kept per key
+#define LATENCY_WINDOW 16
+
+// if defined, note ons, note offs and control changes are queued during the scan and handed to the midi
+// sender once per scan, after every key has been stepped (see MidiQueue.h), so a busy usb port can't
+// stall the scan. Queue statistics can be printed with the "mq" serial command
+#define USE_MIDI_QUEUE
+// messages the queue holds (a power of two), more than this in one scan are dropped
+#define MIDI_QUEUE_SIZE 64
+// longest a midi sender waits for usb to take a batch, in microseconds (a full speed usb frame), before
+// dropping what's left of it (counted, see the "mq" serial command)
+#define MIDI_WRITE_TIMEOUT_US 1000
+
+// buffer dumps ("pm buffers", see BufferDump.h): snapshots of key buffers waiting to be printed, and the
+// most bytes of them printed each scan. The queue holds the dumps of a two handed chord (each ~1.6 kB
+// of RAM, ~13 kB printed over ~50 scans); note ons while it is full are dropped, and counted by "pm buffers"
+#define BUFFER_DUMP_QUEUE 16
+#define BUFFER_DUMP_BYTES_PER_SCAN 256
+
+// telemetry ("pm telemetry", see TelemetryWriter.h): bytes buffered for the serial port (a power of two),
+// and frames between repeats of the schema packet
+#define TELEMETRY_BUFFER_BYTES 16384
+#define TELEMETRY_SCHEMA_INTERVAL 1000
+
+// if defined, keys resting inside their noise band (with no note sounding) skip the filters and hammer
+// simulation, only keeping their sample history up to date, see KeyHammer::updateIdle
+#define USE_IDLE_FAST_PATH
+// half width of the rest band, in standard deviations of the resting adc value (from calibration)
+#define IDLE_BAND_STDS 4
+// minimum half width of the rest band, in adc bits (also used before a key is calibrated)
+#define IDLE_BAND_MIN 3
+
+// if defined, each key's adcValKeyUp and adcValKeyDown follow slow drift in its resting and bottomed out
+// adc values (e.g. with temperature, see DriftTracker.h), one key per scan, and moved values are saved to
+// the sd card now and then. Can be printed with the "drift" serial command
+#define USE_DRIFT_TRACKING
+// weight of each new resting (or bottomed out) sample in a key's running average
+#define DRIFT_EWMA_ALPHA 0.05
+// samples within this fraction of the key's travel of adcValKeyUp (or adcValKeyDown) count as resting
+// (or bottomed out), if the key is moving slower than DRIFT_MAX_SPEED adc bits per microsecond
+#define DRIFT_WINDOW_FRACTION 0.15
+#define DRIFT_MAX_SPEED 0.0005
+// a key's values move at most once per this many milliseconds, by this fraction of the way to its
+// running average (at least one adc bit)
+#define DRIFT_STEP_MS 100
+#define DRIFT_STEP_FRACTION 0.5
+// moved values are saved at most once per this many seconds, once every key has rested for DRIFT_SAVE_QUIET_MS
+#define DRIFT_SAVE_INTERVAL_S 600
+#define DRIFT_SAVE_QUIET_MS 2000
+
+// if defined, resting keys and pedals are only read every SCAN_SLOW_DIVIDER scans (see ScanScheduler.h),
+// while keys in motion are read every scan. Needs USE_IDLE_FAST_PATH to know which keys are resting.
+// Off by default: a key starting to move is only seen on its next slow read, and the filled in samples
+// shift note on times by a few ms and velocities by a few steps (compare host_sim --scheduler with a run
+// without)
+// #define USE_SCAN_SCHEDULER
+// resting keys are read once every this many scans (at most the length of the shortest filter)
+#define SCAN_SLOW_DIVIDER 4
+// extra settle time before a read whose mux was not set up by the read before it, in microseconds
+#define SCAN_SKIP_SETTLE_US 2
+// maximum number of channels (keys + pedals) scheduled
+#define MAX_SCAN_CHANNELS (MAX_BANK_KEYS + 8)
+
+// conversions averaged into each adc value, by default, with the fast converter settings (see
+// DualAdcManager::setOversampling, which can set it per signal pin, i.e. per group of keys)
+#define ADC_OVERSAMPLING 1
+// most conversions averaged into one value
+#define MAX_OVERSAMPLING 16
+
+// if defined, a timer interrupt reads all keys in the background (see AdcFrameScanner.h), one frame
+// per scan, and the simulation runs on the last complete frame while the next is being read
+// #define USE_BACKGROUND_ADC
+// time between background adc interrupts, in microseconds (two per conversion, so at least the
+// conversion time, plus enough for the muxes to settle)
+#define ADC_FRAME_TICK_US 2
+
+// if defined, keys are read in the order worked out by a ScanPlan (see ScanPlan.h) from a table of the
+// signal pin and mux input of each key, rather than through their adc functions
+// #define USE_SCAN_PLAN
+// if defined (with USE_SCAN_PLAN), the settle time of each mux address change is measured at startup
+// (and with the "settle" serial command, see MuxSettleTable.h), and the plan only waits as long as
+// each change needs, instead of the global settle delay
+#define USE_MUX_SETTLE_TABLE
+// longest settle time measured, in microseconds (also the time allowed for a mux to fully settle)
+#define MUX_SETTLE_MAX_US 16
+// a read has settled once it is within this many adc bits of the fully settled value
+#define MUX_SETTLE_TOLERANCE 4
+// added to each measured settle time, in microseconds
+#define MUX_SETTLE_MARGIN_US 1
+
+// if defined, the carry-over of each mux input from the input read before it is measured at startup
+// (and with the "xtalk" serial command, see CrosstalkTable.h), and taken off every value as it is
+// converted, so keys can be read with little or no settle delay
+// #define USE_CROSSTALK_COMPENSATION
+// smallest difference between two inputs' settled values for the carry-over between them to be measured
+#define CROSSTALK_MIN_STEP 32
+// reads of each transition when measuring carry-over
+#define CROSSTALK_REPEATS 4
+
+#if defined(USE_SCAN_SCHEDULER) && !defined(USE_IDLE_FAST_PATH)
+#error "USE_SCAN_SCHEDULER needs USE_IDLE_FAST_PATH"
+#endif
+#if defined(USE_SCAN_PLAN) && (defined(USE_SCAN_SCHEDULER) || defined(USE_BACKGROUND_ADC))
+#error "USE_SCAN_PLAN reads every key itself, so can't be used with USE_SCAN_SCHEDULER or USE_BACKGROUND_ADC"
+#endif
+
 // if defined then the calibration button will be enabled
 // #define USE_CALIBRATION_BUTTON